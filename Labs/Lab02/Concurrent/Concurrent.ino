@@ -1,3 +1,5 @@
+#include <ToneTable.h>
+
 // Global variables
 unsigned long previousMillisA = 0;
 unsigned long previousMillisB = 0;
@@ -29,7 +31,10 @@ bool taskAEnabled = false;
 bool taskBEnabled = false;
 
 // Frequencies for "Mary Had a Little Lamb"
-uint16_t frequencies[] = {494, 440, 392, 440, 494, 494, 494, 440, 440, 440, 494, 587, 587, 494, 440, 392, 440, 494, 494, 494, 494, 440, 440, 494, 440, 392};
+constexpr int frequencies[] = {494, 440, 392, 440, 494, 494, 494, 440, 440, 440, 494, 587, 587, 494, 440, 392, 440, 494, 494, 494, 494, 440, 440, 494, 440, 392};
+
+// The ICR4 value of each note, worked out when compiling
+typedef tone_table<frequencies, sizeof(frequencies) / sizeof(frequencies[0]), TONE_PWM> song_tones;
 
 void setup() {
   // Task A setup
@@ -38,7 +43,7 @@ void setup() {
   // Task B setup
   pinMode(SPEAKER_PIN, OUTPUT);
   TCCR4A = (1 << COM4A1) | (1 << WGM41);
-  TCCR4B = (1 << WGM43) | (1 << WGM42) | (1 << CS41);
+  TCCR4B = (1 << WGM43) | (1 << WGM42) | song_tones::cs;
   ICR4 = 40000;
 
   // Initialize Task A
@@ -132,7 +137,7 @@ void runTaskB() {
   if (gapState) {
     if (currentMillisB - noteGapStartTime >= 100) { // 100 ms gap between notes
       gapState = false;
-      play_tone(frequencies[currentNote], noteDurations[currentNote]);
+      play_tone(currentNote, noteDurations[currentNote]);
       noteStartTime = currentMillisB;
     }
   } else {
@@ -166,8 +171,8 @@ void updateLEDs(uint8_t ledState) {
   }
 }
 
-void play_tone(uint16_t frequency, uint32_t duration) {
-  ICR4 = F_CPU / (8 * frequency); // Calculate the TOP value based on the frequency
+void play_tone(int note, uint32_t duration) {
+  ICR4 = song_tones::top(note); // Look up the TOP value of the note, worked out when compiling
   OCR4A = ICR4 / 2; // Set the duty cycle to 50%
   noteStartTime = millis(); // Store the start time of the note
 }
@@ -1,4 +1,6 @@
 #include <Arduino.h>
+#include <Melody.h>
+#include <ToneTable.h>
 #define LED_PIN_47_BIT 0
 #define LED_PIN_48_BIT 1
 #define LED_PIN_49_BIT 2
@@ -15,10 +17,6 @@ unsigned long previousMillisB = 0;
 unsigned long previousMillisC = 0;
 unsigned long noteStartTime = 0;
 
-// Add a new global variable
-unsigned long noteGapStartTime = 0;
-bool gapState = false;
-
 // LED matrix and thumbstick control variables
 int DIN = 22; // Changed from 47
 int CS =  24; // Changed from 49
@@ -72,15 +70,20 @@ bool taskBCompleted = false;
 
 const unsigned long intervalA = 333;
 const unsigned long intervalB[] = {2000, 10000, 1000}; // Task B durations
-const unsigned long noteDurations[] = {500, 500, 500, 500, 500, 500, 1000, 500, 500, 1000, 500, 500, 1000, 500, 500, 500, 500, 500, 500, 1000, 500, 500, 500, 500, 500, 1000}; // Note durations
-uint8_t currentNote = 0;
+const unsigned int noteDurations[] = {500, 500, 500, 500, 500, 500, 1000, 500, 500, 1000, 500, 500, 1000, 500, 500, 500, 500, 500, 500, 1000, 500, 500, 500, 500, 500, 1000}; // Note durations
 
 int phase = 0;
 bool taskAEnabled = false;
 bool taskBEnabled = false;
 
 // Frequencies for "Mary Had a Little Lamb"
-uint16_t frequencies[] = {494, 440, 392, 440, 494, 494, 494, 440, 440, 440, 494, 587, 587, 494, 440, 392, 440, 494, 494, 494, 494, 440, 440, 494, 440, 392};
+constexpr int frequencies[] = {494, 440, 392, 440, 494, 494, 494, 440, 440, 440, 494, 587, 587, 494, 440, 392, 440, 494, 494, 494, 494, 440, 440, 494, 440, 392};
+
+// The ICR4 value of each note, worked out when compiling
+typedef tone_table<frequencies, sizeof(frequencies) / sizeof(frequencies[0]), TONE_PWM> song_tones;
+
+// Where Task B is in the song
+melody_seq song;
 
 void setup() {
   // Task A setup
@@ -89,8 +92,11 @@ void setup() {
   // Task B setup
   pinMode(SPEAKER_PIN, OUTPUT);
   TCCR4A = (1 << COM4A1) | (1 << WGM41);
-  TCCR4B = (1 << WGM43) | (1 << WGM42) | (1 << CS41);
+  TCCR4B = (1 << WGM43) | (1 << WGM42) | song_tones::cs;
   ICR4 = 40000;
+  melody_init(&song, frequencies, sizeof(frequencies) / sizeof(frequencies[0]), 0);
+  melody_set_durations(&song, noteDurations);
+  melody_set_gap(&song, 100); // 100 ms gap between notes
 
   // Initialize Task A
   taskAEnabled = true;
@@ -209,25 +215,26 @@ void runTaskB() {
 
   unsigned long currentMillisB = millis();
 
-  if (gapState) {
-    if (currentMillisB - noteGapStartTime >= 100) { // 100 ms gap between notes
-      gapState = false;
-      play_tone(frequencies[currentNote], noteDurations[currentNote]);
-      noteStartTime = currentMillisB;
-    }
+  // Wait for the note, or the gap after it, to end
+  if (currentMillisB - noteStartTime < melody_held(&song)) {
+    return;
+  }
+
+  int frequency = melody_step(&song);
+
+  // Set taskBCompleted to true when the song has completed, and play it again
+  if (frequency == MELODY_END) {
+    taskBCompleted = true;
+    melody_start(&song, 0);
+    frequency = melody_step(&song);
+  }
+
+  if (frequency == 0) {
+    silence();
   } else {
-    if (currentMillisB - noteStartTime >= noteDurations[currentNote]) {
-      silence();
-      noteGapStartTime = currentMillisB;
-      gapState = true;
-      currentNote = (currentNote + 1) % (sizeof(noteDurations) / sizeof(noteDurations[0]));
-
-      // Set taskBCompleted to true when the song has completed
-      if (currentNote == 0) {
-        taskBCompleted = true;
-      }
-    }
+    play_tone(melody_index(&song), melody_held(&song));
   }
+  noteStartTime = currentMillisB;
 }
 
 void updateLEDs(uint8_t ledState) {
@@ -246,8 +253,8 @@ void updateLEDs(uint8_t ledState) {
   }
 }
 
-void play_tone(uint16_t frequency, uint32_t duration) {
-  ICR4 = F_CPU / (8 * frequency); // Calculate the TOP value based on the frequency
+void play_tone(int note, uint32_t duration) {
+  ICR4 = song_tones::top(note); // Look up the TOP value of the note, worked out when compiling
   OCR4A = ICR4 / 2; // Set the duty cycle to 50%
   noteStartTime = millis(); // Store the start time of the note
 }
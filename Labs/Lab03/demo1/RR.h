@@ -6,6 +6,9 @@
  * - Joey Pirich
  */
 
+#include <Melody.h>
+#include <ToneTable.h>
+
 // Define notes for the melody
 #define NOTE_C  262
 #define NOTE_CS 277
@@ -23,7 +26,7 @@
 
 // Define the number of notes in the melody and the melody itself
 #define NMELODY 72
-int melody[] = {
+constexpr int melody[] = {
   NOTE_E, NOTE_E, 0, NOTE_E, 0, NOTE_C, NOTE_E, 0,
   NOTE_G, 0, 0,  0, NOTE_G, 0, 0, 0,
   NOTE_C5, 0, 0, NOTE_G, 0, 0, NOTE_E, 0,
@@ -35,6 +38,9 @@ int melody[] = {
   NOTE_E, 0, NOTE_C, NOTE_D, NOTE_B, 0, 0, NOTE_C5
 };
 
+// The OCR4A value of each note of the melody, worked out when compiling
+typedef tone_table<melody, NMELODY> melody_tones;
+
 
 // Define bit masks for each bit
 #define BIT0 1<<0
@@ -59,9 +65,9 @@ int melody[] = {
 #define FLASH_DURATION 250
 #define PLAY_DURATION 200
 #define PAUSE_DURATION 4000
-#define PICKUP_TIME (NMELODY * PLAY_DURATION) + PAUSE_DURATION
 
 // Function prototypes
 void setOC4AFreq(uint32_t freq);
+void setOC4ANote(int note);
 void task1();
 void task2();
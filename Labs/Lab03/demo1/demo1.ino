@@ -9,6 +9,9 @@
 int reset1 = 0;
 int reset2 = 0;
 
+// where task2 is in the melody
+melody_seq theme;
+
 // sets the OCR4A to make the clock cycle frequency
 // the same as the input freq
 void setOC4AFreq(uint32_t freq) {
@@ -16,6 +19,13 @@ void setOC4AFreq(uint32_t freq) {
   TIMER_COUNTER = 0;
 }
 
+// sets the OCR4A to play a note of the melody, from the
+// table worked out when compiling, with no division
+void setOC4ANote(int note) {
+  PRESCALER = melody_tones::top(note);
+  TIMER_COUNTER = 0;
+}
+
 void task1() {
   static unsigned long time;
   time++;
@@ -51,33 +61,23 @@ void task2() {
   if (reset2) {
     setOC4AFreq(0);
     time = 0;
+    melody_start(&theme, 1);
     reset2 = 0;
     return;
   }
 
-  // play tone
-  for (int i = 0; i < NMELODY; i++) {
-    if (time == ((unsigned long) i * PLAY_DURATION) + 1) {
-      setOC4AFreq(melody[i]);
-    }
-  }
-
-  // stop playing for 4 seconds
-  if (time == ((unsigned long) NMELODY * PLAY_DURATION) + 1) {
-    setOC4AFreq(0);
-  }
-
-  // start playing after 4 seconds
-  for (int i = 0; i < NMELODY; i++) {
-    if (time == (PICKUP_TIME + (unsigned long) i * PLAY_DURATION) + 1) {
-      setOC4AFreq(melody[i]);
-    }
-  }
+  // wait for the note, or the pause between the two plays, to end
+  if (time < melody_next(&theme)) return;
+  int freq = melody_step(&theme);
 
   // reset
-  if (time == (PICKUP_TIME + (unsigned long) NMELODY * PLAY_DURATION) + 1) {
-    time = 0;
+  if (freq == MELODY_END) {
+    time = 1;
+    melody_start(&theme, 1);
+    freq = melody_step(&theme);
   }
+
+  setOC4ANote(melody_index(&theme));
 }
 
 /// Initializes everything needed for the tasks
@@ -100,8 +100,9 @@ void setup() {
   //
   //  f_out = f_i/o / 2 * N * (PRESCALER + 1)
   //
-  // because f_i/o = 16Mhz, we'll just set N = 1
-  TIMER_REG_B |= (0 << CS42) | (0 << CS41) | (1 << CS40);
+  // N is the smallest prescaler the lowest note of the
+  // melody fits, which the tone table picks when compiling
+  TIMER_REG_B |= melody_tones::cs;
   PRESCALER = 0;
   TIMER_COUNTER = 0;
 
@@ -113,6 +114,11 @@ void setup() {
   LED_DDR |= BIT0;
   LED_DDR |= BIT1;
   LED_DDR |= BIT2;
+
+  // play the melody twice, with a pause in between
+  melody_init(&theme, melody, NMELODY, PLAY_DURATION);
+  melody_set_repeat(&theme, 2, PAUSE_DURATION);
+  melody_start(&theme, 1);
 }
 
 /// Scheduler loop
@@ -6,6 +6,10 @@
  * - Joey Pirich
  */
 
+#include <FrameIdle.h>
+#include <Melody.h>
+#include <ToneTable.h>
+
 // Define notes for the melody
 #define NOTE_C  262
 #define NOTE_CS 277
@@ -23,7 +27,7 @@
 
 // Define the number of notes in the melody and the melody itself
 #define NMELODY 72
-int melody[] = {
+constexpr int melody[] = {
   NOTE_E, NOTE_E, 0, NOTE_E, 0, NOTE_C, NOTE_E, 0,
   NOTE_G, 0, 0,  0, NOTE_G, 0, 0, 0,
   NOTE_C5, 0, 0, NOTE_G, 0, 0, NOTE_E, 0,
@@ -35,6 +39,9 @@ int melody[] = {
   NOTE_E, 0, NOTE_C, NOTE_D, NOTE_B, 0, 0, NOTE_C5
 };
 
+// The OCR4A value of each note of the melody, worked out when compiling
+typedef tone_table<melody, NMELODY> melody_tones;
+
 
 // Define bit masks for each bit
 #define BIT0 1<<0
@@ -59,7 +66,6 @@ int melody[] = {
 #define FLASH_DURATION 250
 #define PLAY_DURATION 200
 #define PAUSE_DURATION 4000
-#define PICKUP_TIME (NMELODY * PLAY_DURATION) + PAUSE_DURATION
 
 // Define the number of tasks and an enum for the state of a task
 #define NTASKS 10
@@ -68,10 +74,19 @@ enum state {READY, RUNNING, SLEEPING};
 // Define an enum for the state of a flag
 enum flagState {PENDING, DONE};
 
+// Define the period of the Timer3 tick schedule_sync waits for, in milliseconds
+#define TICK_MS 2
+
+// Define how many frames pass between reports of the idle time and of the task times, 5 s of them
+#define IDLE_REPORT_FRAMES 2500
+
 // Function prototypes for various functions used in the sketch
 void sleep_474(long t);
 void schedule_sync();
+long task_time();
+void task_reset_time();
 void setOC4AFreq(uint32_t freq);
+void setOC4ANote(int note);
 void task1();
 void task2();
 void interruptSetup();
@@ -11,12 +11,23 @@
 int reset1 = 0;
 int reset2 = 0;
 
+// where task2 is in the melody
+melody_seq theme;
+
 void (* taskArr[NTASKS]) ();
 volatile int sFlag = PENDING;
 volatile int currTask;
 volatile int sleepArr[NTASKS];
 volatile int stateArr[NTASKS];
-volatile long timeArr[NTASKS];
+volatile unsigned long timeArr[NTASKS];
+
+// sleep queue in wake up order, each sleepArr entry is the time left after the task before it
+int sleepNext[NTASKS];
+int sleepHead = -1;
+// number of tasks not sleeping, schedule_sync included
+int nAwake;
+// time schedule_sync has counted, task times are worked out from it
+unsigned long now;
 
 /// Initializes all necessary i/o parts
 void setup() {
@@ -35,7 +46,15 @@ void setup() {
   taskArr[0] = task1;
   taskArr[1] = task2;
   taskArr[NTASKS-2] = schedule_sync;
-  Serial.begin(9600);
+  for (int i = 0; i < NTASKS; i++) {
+    if (taskArr[i] != NULL) nAwake++;
+  }
+  Serial.begin(115200);
+  melody_tones::report(Serial);
+
+  // play the melody twice, with a pause in between
+  melody_init(&theme, melody, NMELODY, PLAY_DURATION);
+  melody_set_repeat(&theme, 2, PAUSE_DURATION);
 }
 
 /// Scheduler loop
@@ -45,8 +64,9 @@ void loop() {
       // start up this task
       stateArr[i] = RUNNING;
       currTask = i;
+      frame_task_begin(i);
       (*taskArr[i])();
-
+      frame_task_end(i);
 
       // tear down
       if (stateArr[i] == RUNNING) stateArr[i] = READY;
@@ -66,9 +86,11 @@ void loop() {
  * @brief Timer 3 Interrupt function.
  * 
  * This function is called by the Timer 3 Interrupt and sets the sFlag to DONE.
+ * If the sFlag is still DONE, a task ran past the frame and the overrun is counted.
  * 
  */
 ISR(TIMER3_COMPA_vect) {
+  frame_tick(sFlag == DONE); // count the frame, and the overrun if schedule_sync missed the last one
   sFlag = DONE; // Set the sFlag to DONE
 }
 
@@ -88,10 +110,32 @@ ISR(TIMER3_COMPA_vect) {
  * @return void
  */
 void sleep_474(long t) {
-  // sleep array @ [function index], set value to t
-  sleepArr[currTask] = t;
+  // sleep whole ticks, and at least one
+  int timeSleep = t < 2 * TICK_MS ? TICK_MS : (t / TICK_MS) * TICK_MS;
+
+  // find where the task goes in the sleep queue, after the tasks that wake no later
+  int prev = -1;
+  int next = sleepHead;
+  while (next != -1 && sleepArr[next] <= timeSleep) {
+    timeSleep -= sleepArr[next];
+    prev = next;
+    next = sleepNext[next];
+  }
+
+  // sleep array @ [function index], set value to the time left after the task before it
+  sleepArr[currTask] = timeSleep;
+  sleepNext[currTask] = next;
+  if (prev == -1) {
+    sleepHead = currTask;
+  } else {
+    sleepNext[prev] = currTask;
+  }
+  // the task behind it now sleeps only the time after it
+  if (next != -1) sleepArr[next] -= timeSleep;
+
   // state array @ [function index], set state to SLEEPING
   stateArr[currTask] = SLEEPING;
+  nAwake--;
   return;
 }
 
@@ -99,45 +143,75 @@ void sleep_474(long t) {
  * @file demo2.ino
  * @brief This file contains the implementation of the schedule_sync function.
  * 
- * This function updates the remaining sleep time for each sleeping task and wakes up any sleeping tasks
- * whose remaining sleep time has elapsed. It also updates the timeArr for each task and resets the sFlag.
+ * This function waits for the timer, moves the time of every task on and wakes up the sleeping tasks
+ * at the front of the sleep queue whose sleep time has elapsed. When every other task is asleep it waits
+ * out all the ticks until the first one wakes and passes them on at once.
  * 
  */
 
 /**
- * @brief Updates the remaining sleep time for each sleeping task and wakes up any sleeping tasks
- * whose remaining sleep time has elapsed. It also updates the timeArr for each task and resets the sFlag.
+ * @brief Waits for the timer, moves the time of every task on and wakes up any sleeping tasks
+ * whose sleep time has elapsed.
  * 
  * @return void
  */
 void schedule_sync() {
-  // wait for sFlag to be set to DONE
-  while (sFlag == PENDING) {
-    3 + 5;
+  // if every other task is asleep, wait for the first one to wake rather than one tick
+  int idle = nAwake == 1 && sleepHead != -1 ? sleepArr[sleepHead] : TICK_MS;
+  int elapsed = 0;
+
+  do {
+    // sleep until the timer sets sFlag to DONE
+    frame_idle_wait(sFlag, PENDING);
+
+    // reset sFlag and count every frame that ended, more than one if a task ran over
+    elapsed += frame_take(sFlag, PENDING) * TICK_MS;
+  } while (elapsed < idle);
+
+  // print how much of each frame was left idle, then which tasks ran over, a call apart
+  if (frame_idle_frames() >= IDLE_REPORT_FRAMES) {
+    frame_idle_report(Serial);
+  } else if (frame_task_frames() >= IDLE_REPORT_FRAMES) {
+    frame_task_report(Serial);
   }
 
-  // update sleep time and wake up sleeping tasks
-  for (int i = 0; i < NTASKS; i++) {
-    // update remaining sleep time
-    if (stateArr[i] == SLEEPING) {
-      sleepArr[i] -= 2;
-      // wake up any sleeping tasks
-      if (sleepArr[i] < 2) {
-        // reset to t = 0 in sleep array
-        sleepArr[i] = 0;
-        // change corresponding state from SLEEPING to READY
-        stateArr[i] = READY;
-      }
-    }
+  // move the time of every task on
+  now += elapsed;
 
-    // update timeArr for each task
-    timeArr[i] += 2;
-  }
+  // only the first task in the sleep queue counts down, the rest sleep on after it
+  if (sleepHead != -1) sleepArr[sleepHead] -= elapsed;
 
-  // reset sFlag
-  sFlag = PENDING;
+  // wake up sleeping tasks whose sleep time has elapsed
+  while (sleepHead != -1 && sleepArr[sleepHead] <= 0) {
+    int i = sleepHead;
+    sleepHead = sleepNext[i];
+    // pass on what the ticks took past this task's wake up time
+    if (sleepHead != -1) sleepArr[sleepHead] += sleepArr[i];
+    sleepArr[i] = 0;
+    // change corresponding state from SLEEPING to READY
+    stateArr[i] = READY;
+    nAwake++;
+  }
   return;
 }
+
+/**
+ * @brief Returns the time the current task sees, in milliseconds
+ * 
+ * @return long The time since the task started or last reset its time
+ */
+long task_time() {
+  return (long) (now - timeArr[currTask]);
+}
+
+/**
+ * @brief Sets the current task's time back to 0
+ * 
+ * @return void
+ */
+void task_reset_time() {
+  timeArr[currTask] = now;
+}
 /**
  * @file demo2.ino
  * @brief This file contains the implementation of the setOC4AFreq function.
@@ -161,6 +235,20 @@ void setOC4AFreq(uint32_t freq) {
   TIMER_COUNTER = 0;
 }
 
+/**
+ * @brief Sets the OCR4A to play a note of the melody
+ * 
+ * The OCR4A value of every note is looked up in a table worked out when compiling,
+ * so no division is needed.
+ * 
+ * @param note Index of the note in the melody, or -1 for silence
+ * @return void
+ */
+void setOC4ANote(int note) {
+  PRESCALER = melody_tones::top(note);
+  TIMER_COUNTER = 0;
+}
+
 /**
  * @file demo2.ino
  * @brief This file contains the implementation of the task1 function.
@@ -180,28 +268,28 @@ void task1() {
   // reset everything given a reset signal
   if (reset1) {
     LED_PORT |= BIT2;
-    timeArr[currTask] = 0;
+    task_reset_time();
     reset1 = 0;
     return;
   }
 
   // flash led on pin 47 for FLASH_DURATION
-  if (timeArr[currTask] < (1 * FLASH_DURATION) + 1) {
+  if (task_time() < (1 * FLASH_DURATION) + 1) {
     LED_PORT |= BIT2;
     sleep_474(250);
     return;
   }
 
   // turn off led for PAUSE_DURATION
-  if (timeArr[currTask] < (2 * FLASH_DURATION) + 1) {
+  if (task_time() < (2 * FLASH_DURATION) + 1) {
     LED_PORT &= ~BIT2;
     sleep_474(750);
     return;
   }
 
-  // reset timeArr after 1000ms
-  if (timeArr[currTask] >= 1000) {
-    timeArr[currTask]= 0;
+  // reset the time after 1000ms
+  if (task_time() >= 1000) {
+    task_reset_time();
   }
 
   return;
@@ -226,42 +314,24 @@ void task2() {
   // reset everything given a reset signal
   if (reset2) {
     setOC4AFreq(0);
-    timeArr[currTask] = 0;
+    task_reset_time();
+    melody_start(&theme, 0);
     reset2 = 0;
     return;
   }
 
-  // play tone
-  for (int i = 0; i < NMELODY; i++) {
-    if ( timeArr[currTask] >= ((unsigned long) i * PLAY_DURATION) &&
-      timeArr[currTask] < (((unsigned long) i + 1) * PLAY_DURATION) ) {
-      setOC4AFreq(melody[i]);
-      sleep_474(PLAY_DURATION);
-      return;
-    }
-  }
-
-  // stop playing for 4 seconds
-  if (timeArr[currTask] < PICKUP_TIME) {
-    setOC4AFreq(0);
-    sleep_474(PAUSE_DURATION);
-    return;
-  }
-
-  // start playing after 4 seconds
-  for (int i = 0; i < NMELODY; i++) {
-    if (timeArr[currTask] >= (PICKUP_TIME + ((unsigned long) i) * PLAY_DURATION) &&
-        timeArr[currTask] < (PICKUP_TIME + ((unsigned long) i + 1) * PLAY_DURATION)) {
-      setOC4AFreq(melody[i]);
-      sleep_474(PLAY_DURATION);
-      return;
-    }
-  }
+  // play the next note, or the pause between the two plays
+  int freq = melody_step(&theme);
 
   // reset
-  if (timeArr[currTask] >= (PICKUP_TIME + (unsigned long) NMELODY * PLAY_DURATION)) {
-    timeArr[currTask] = 0;
+  if (freq == MELODY_END) {
+    task_reset_time();
+    melody_start(&theme, 0);
+    freq = melody_step(&theme);
   }
+
+  setOC4ANote(melody_index(&theme));
+  sleep_474((long) (melody_next(&theme) - task_time()));
 }
 /**
  * @file demo2.ino
@@ -333,7 +403,7 @@ void speakerSetup() {
   // disable interrupts on the timer
   TIMSK4 = 0;
 
-  TIMER_REG_B |= (0 << CS42) | (0 << CS41) | (1 << CS40);
+  TIMER_REG_B |= melody_tones::cs;
   PRESCALER = 0;
   TIMER_COUNTER = 0;
 
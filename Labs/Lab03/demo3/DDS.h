@@ -6,6 +6,10 @@
  * - Joey Pirich
  */
 
+#include <FrameIdle.h>
+#include <Melody.h>
+#include <ToneTable.h>
+
 // Define notes for the melody
 #define NOTE_C  262
 #define NOTE_CS 277
@@ -23,7 +27,7 @@
 
 // Define the number of notes in the melody and the melody itself
 #define NMELODY 72
-int melody[] = {
+constexpr int melody[] = {
   NOTE_E, NOTE_E, 0, NOTE_E, 0, NOTE_C, NOTE_E, 0,
   NOTE_G, 0, 0,  0, NOTE_G, 0, 0, 0,
   NOTE_C5, 0, 0, NOTE_G, 0, 0, NOTE_E, 0,
@@ -35,6 +39,9 @@ int melody[] = {
   NOTE_E, 0, NOTE_C, NOTE_D, NOTE_B, 0, 0, NOTE_C5
 };
 
+// The OCR4A value of each note of the melody, worked out when compiling
+typedef tone_table<melody, NMELODY> melody_tones;
+
 // Define bit masks for each bit
 #define BIT0 1<<0
 #define BIT1 1<<1
@@ -61,7 +68,6 @@ int melody[] = {
 #define ADURATION 2000
 #define CDURATION 10000
 #define PAUSE_DURATION 4000
-#define PICKUP_TIME (NMELODY * PLAY_DURATION) + PAUSE_DURATION
 
 // Define the maximum number of tasks
 #define NTASKS 10
@@ -72,6 +78,9 @@ typedef enum {READY, RUNNING, SLEEPING, DEAD} STATE;
 // Define the possible states of a flag
 typedef enum flagState {PENDING, DONE} FLAG;
 
+/// Number of Timer3 frames between reports of the idle time, 5 s of them
+#define IDLE_REPORT_FRAMES 2500
+
 // Define the Task Control Block (TCB) structure
 typedef struct TCB {
   char name[20];
@@ -92,6 +101,7 @@ void task_start(tcb * task);
 void task_load(void (*fn_ptr)(), const char * name);
 tcb * find_dead_task(const char * name);
 void setOC4AFreq(uint32_t freq);
+void setOC4ANote(int note);
 void task1();
 void task2();
 void speakerSetup();
@@ -31,6 +31,9 @@ volatile int currTask;
 int reset1 = 0;
 int reset2 = 0;
 
+// where task2 is in the melody
+melody_seq theme;
+
 // Setup function
 void setup() {
   // Initialize the id variable
@@ -40,6 +43,11 @@ void setup() {
   interruptSetup();
   speakerSetup();
   ledSetup();
+  Serial.begin(9600);
+
+  // play the melody twice, with a pause in between
+  melody_init(&theme, melody, NMELODY, PLAY_DURATION);
+  melody_set_repeat(&theme, 2, PAUSE_DURATION);
 
   // Setup the DDS
   DDSSetup();
@@ -281,10 +289,11 @@ void sleep_474(long t) {
  * @return void
  */
 void schedule_sync() {
-  // wait until sFlag is no longer PENDING
-  while (sFlag == PENDING) {
-    3 + 5;
-  }
+  // sleep until sFlag is no longer PENDING
+  frame_idle_wait(sFlag, PENDING);
+
+  // print how much of each frame was left idle
+  if (frame_idle_frames() >= IDLE_REPORT_FRAMES) frame_idle_report(Serial);
 
   // update remaining sleep time for any sleeping tasks and wake up any sleeping tasks whose remaining sleep time has elapsed
   for (int i = 0; i < NTASKS; i++) {
@@ -329,6 +338,20 @@ void setOC4AFreq(uint32_t freq) {
   TIMER_COUNTER = 0;
 }
 
+/**
+ * @brief Sets the OCR4A to play a note of the melody
+ * 
+ * The OCR4A value of every note is looked up in a table worked out when compiling,
+ * so no division is needed.
+ * 
+ * @param note Index of the note in the melody, or -1 for silence
+ * @return void
+ */
+void setOC4ANote(int note) {
+  PRESCALER = melody_tones::top(note);
+  TIMER_COUNTER = 0;
+}
+
 
 
 /**
@@ -372,7 +395,7 @@ void task1() {
 /**
  * @brief Plays a melody on the speaker.
  * 
- * This function checks the current time and plays the corresponding note in the melody.
+ * This function plays the next note in the melody and sleeps until it is over.
  * If the melody has finished playing, it resets the time.
  * 
  * @return void
@@ -381,37 +404,23 @@ void task2() {
   if (reset2) {
     setOC4AFreq(0);
     taskArr[currTask].time = 0;
+    melody_start(&theme, 0);
     reset2 = 0;
     return;
   }
 
-  for (int i = 0; i < NMELODY; i++) {
-    if ( taskArr[currTask].time >= ((unsigned long) i * PLAY_DURATION) &&
-      taskArr[currTask].time < (((unsigned long) i + 1) * PLAY_DURATION) ) {
-      setOC4AFreq(melody[i]);
-      sleep_474(PLAY_DURATION);
-      return;
-    }
-  }
+  // play the next note, or the pause between the two plays
+  int freq = melody_step(&theme);
 
-  if (taskArr[currTask].time < PICKUP_TIME) {
-    setOC4AFreq(0);
-    sleep_474(PAUSE_DURATION);
-    return;
-  }
-
-  for (int i = 0; i < NMELODY; i++) {
-    if (taskArr[currTask].time >= (PICKUP_TIME + ((unsigned long) i) * PLAY_DURATION) &&
-        taskArr[currTask].time < (PICKUP_TIME + ((unsigned long) i + 1) * PLAY_DURATION)) {
-      setOC4AFreq(melody[i]);
-      sleep_474(PLAY_DURATION);
-      return;
-    }
-  }
-
-  if (taskArr[currTask].time >= (PICKUP_TIME + (unsigned long) NMELODY * PLAY_DURATION)) {
+  // reset
+  if (freq == MELODY_END) {
     taskArr[currTask].time = 0;
+    melody_start(&theme, 0);
+    freq = melody_step(&theme);
   }
+
+  setOC4ANote(melody_index(&theme));
+  sleep_474((long) melody_next(&theme) - taskArr[currTask].time);
 }
 
 /**
@@ -467,7 +476,7 @@ void speakerSetup() {
   TIMSK4 = 0; // disable timer interrupts
 
   // set prescaler and timer counter to 0
-  TIMER_REG_B |= (0 << CS42) | (0 << CS41) | (1 << CS40);
+  TIMER_REG_B |= melody_tones::cs;
   PRESCALER = 0;
   TIMER_COUNTER = 0;
 
@@ -11,6 +11,10 @@
  * - Joey Pirich
  */
 
+#include <FrameIdle.h>
+#include <Melody.h>
+#include <ToneTable.h>
+
 // Defines musical notes as frequencies
 #define NOTE_C  262
 #define NOTE_CS 277
@@ -30,7 +34,7 @@
 #define NMELODY 72
 
 // An array of notes that make up a melody
-int melody[] = {
+constexpr int melody[] = {
   NOTE_E, NOTE_E, 0, NOTE_E, 0, NOTE_C, NOTE_E, 0,
   NOTE_G, 0, 0,  0, NOTE_G, 0, 0, 0,
   NOTE_C5, 0, 0, NOTE_G, 0, 0, NOTE_E, 0,
@@ -42,6 +46,9 @@ int melody[] = {
   NOTE_E, 0, NOTE_C, NOTE_D, NOTE_B, 0, 0, NOTE_C5
 };
 
+// The OCR4A value of each note of the melody, worked out when compiling
+typedef tone_table<melody, NMELODY> melody_tones;
+
 
 #define BIT0 1<<0
 #define BIT1 1<<1
@@ -72,7 +79,6 @@ int melody[] = {
 #define ADURATION 2000
 #define CDURATION 10000
 #define PAUSE_DURATION 4000
-#define PICKUP_TIME (NMELODY * PLAY_DURATION) + PAUSE_DURATION
 
 // The lookup table for the 7-segment display
 byte seven_seg_digits[10][7] = { { 1,1,1,1,1,1,0 },  // = 0
@@ -88,7 +94,14 @@ byte seven_seg_digits[10][7] = { { 1,1,1,1,1,1,0 },  // = 0
                                  };
 
 #define NTASKS 10
+enum state {READY, RUNNING, SLEEPING};
+enum flagState {PENDING, DONE};
 
+/// Period of the Timer3 tick schedule_sync waits for, in milliseconds
+#define TICK_MS 2
+
+/// Number of frames between reports of the idle time, 5 s of them
+#define IDLE_REPORT_FRAMES 2500
 
 /**
  * @brief Suspends the execution of the calling task for a specified time
@@ -103,6 +116,19 @@ void sleep_474(long t);
  */
 void schedule_sync();
 
+/**
+ * @brief Returns the time the current task sees
+ * 
+ * @return The time in milliseconds since the task started or last reset its time
+ */
+long task_time();
+
+/**
+ * @brief Sets the current task's time back to 0
+ * 
+ */
+void task_reset_time();
+
 /**
  * @brief Sets the frequency of the output compare register 4A
  * 
@@ -110,6 +136,13 @@ void schedule_sync();
  */
 void setOC4AFreq(uint32_t freq);
 
+/**
+ * @brief Sets the output compare register 4A to play a note of the melody
+ * 
+ * @param note Index of the note in the melody, or -1 for silence
+ */
+void setOC4ANote(int note);
+
 /**
  * @brief The first task to be executed
  * 
@@ -9,12 +9,23 @@
 int reset1 = 0;
 int reset2 = 0;
 
+// where task2 is in the melody
+melody_seq theme;
+
 void (* taskArr[NTASKS]) ();
 volatile int sFlag = PENDING;
 volatile int currTask;
 volatile int sleepArr[NTASKS];
 volatile int stateArr[NTASKS];
-volatile long timeArr[NTASKS];
+volatile unsigned long timeArr[NTASKS];
+
+// sleep queue in wake up order, each sleepArr entry is the time left after the task before it
+int sleepNext[NTASKS];
+int sleepHead = -1;
+// number of tasks not sleeping, schedule_sync included
+int nAwake;
+// time schedule_sync has counted, task times are worked out from it
+unsigned long now;
 
 /// Initializes all necessary i/o parts
 void setup() {
@@ -35,7 +46,14 @@ void setup() {
   taskArr[1] = task2;
   taskArr[2] = task3;
   taskArr[NTASKS-2] = schedule_sync;
-  // Serial.begin(9600);
+  for (int i = 0; i < NTASKS; i++) {
+    if (taskArr[i] != NULL) nAwake++;
+  }
+  Serial.begin(9600);
+
+  // play the melody twice, with a pause in between
+  melody_init(&theme, melody, NMELODY, PLAY_DURATION);
+  melody_set_repeat(&theme, 2, PAUSE_DURATION);
 
   pinMode(LED_BUILTIN, OUTPUT);
   digitalWrite(LED_BUILTIN, LOW);
@@ -81,10 +99,32 @@ ISR(TIMER3_COMPA_vect) {
  * @return void
  */
 void sleep_474(long t) {
-  // sleep array @ [function index], set value to t
-  sleepArr[currTask] = t;
+  // sleep whole ticks, and at least one
+  int timeSleep = t < 2 * TICK_MS ? TICK_MS : (t / TICK_MS) * TICK_MS;
+
+  // find where the task goes in the sleep queue, after the tasks that wake no later
+  int prev = -1;
+  int next = sleepHead;
+  while (next != -1 && sleepArr[next] <= timeSleep) {
+    timeSleep -= sleepArr[next];
+    prev = next;
+    next = sleepNext[next];
+  }
+
+  // sleep array @ [function index], set value to the time left after the task before it
+  sleepArr[currTask] = timeSleep;
+  sleepNext[currTask] = next;
+  if (prev == -1) {
+    sleepHead = currTask;
+  } else {
+    sleepNext[prev] = currTask;
+  }
+  // the task behind it now sleeps only the time after it
+  if (next != -1) sleepArr[next] -= timeSleep;
+
   // state array @ [function index], set state to SLEEPING
   stateArr[currTask] = SLEEPING;
+  nAwake--;
   return;
 }
 
@@ -92,40 +132,66 @@ void sleep_474(long t) {
 /**
  * @brief Synchronizes the scheduler with the timer
  * 
- * This function updates the remaining sleep time of each sleeping task and wakes up any sleeping tasks that have finished sleeping.
- * It also updates the time elapsed for each task and resets the sFlag.
+ * This function waits for the timer, moves the time of every task on and wakes up the sleeping tasks at the front of the sleep queue that have finished sleeping.
+ * When every other task is asleep it waits out all the ticks until the first one wakes and passes them on at once.
  * 
  * @param None
  * 
  * @return void
  */
 void schedule_sync() {
-  // wait for sFlag to be set to DONE
-  while (sFlag == PENDING) {
-    3 + 5; // do nothing
+  // if every other task is asleep, wait for the first one to wake rather than one tick
+  int idle = nAwake == 1 && sleepHead != -1 ? sleepArr[sleepHead] : TICK_MS;
+  int elapsed = 0;
+
+  do {
+    // sleep until the timer sets sFlag to DONE
+    frame_idle_wait(sFlag, PENDING);
+
+    // reset sFlag
+    sFlag = PENDING;
+    elapsed += TICK_MS;
+  } while (elapsed < idle);
+
+  // print how much of each frame was left idle
+  if (frame_idle_frames() >= IDLE_REPORT_FRAMES) frame_idle_report(Serial);
+
+  // move the time of every task on
+  now += elapsed;
+
+  // only the first task in the sleep queue counts down, the rest sleep on after it
+  if (sleepHead != -1) sleepArr[sleepHead] -= elapsed;
+
+  // wake up sleeping tasks whose sleep time has elapsed
+  while (sleepHead != -1 && sleepArr[sleepHead] <= 0) {
+    int i = sleepHead;
+    sleepHead = sleepNext[i];
+    // pass on what the ticks took past this task's wake up time
+    if (sleepHead != -1) sleepArr[sleepHead] += sleepArr[i];
+    sleepArr[i] = 0;
+    // change corresponding state from SLEEPING to READY
+    stateArr[i] = READY;
+    nAwake++;
   }
+  return;
+}
 
-  // update each task's sleep time and state
-  for (int i = 0; i < NTASKS; i++) {
-    // update remaining sleep time
-    if (stateArr[i] == SLEEPING) {
-      sleepArr[i] -= 2;
-      // wake up any sleeping tasks
-      if (sleepArr[i] < 2) {
-        // reset to t = 0 in sleep array
-        sleepArr[i] = 0;
-        // change corresponding state from SLEEPING to READY
-        stateArr[i] = READY;
-      }
-    }
-
-    // update time elapsed for each task
-    timeArr[i] += 2;
-  }
+/**
+ * @brief Returns the time the current task sees, in milliseconds
+ * 
+ * @return long The time since the task started or last reset its time
+ */
+long task_time() {
+  return (long) (now - timeArr[currTask]);
+}
 
-  // reset sFlag
-  sFlag = PENDING;
-  return;
+/**
+ * @brief Sets the current task's time back to 0
+ * 
+ * @return void
+ */
+void task_reset_time() {
+  timeArr[currTask] = now;
 }
 
 
@@ -145,6 +211,20 @@ void setOC4AFreq(uint32_t freq) {
   TIMER_COUNTER = 0;
 }
 
+/**
+ * @brief Sets the OCR4A to play a note of the melody
+ * 
+ * The OCR4A value of every note is looked up in a table worked out when compiling,
+ * so no division is needed.
+ * 
+ * @param note Index of the note in the melody, or -1 for silence
+ * @return void
+ */
+void setOC4ANote(int note) {
+  PRESCALER = melody_tones::top(note);
+  TIMER_COUNTER = 0;
+}
+
 /**
  * @brief Flashes an LED on pin 47 for a specified duration
  * 
@@ -158,26 +238,26 @@ void task1() {
   // reset everything given a reset signal
   if (reset1) {
     LED_PORT |= BIT2;
-    timeArr[currTask] = 0;
+    task_reset_time();
     reset1 = 0;
     return;
   }
 
   // flash led on pin 47 for FLASH_DURATION
-  if (timeArr[currTask] < (1 * FLASH_DURATION) + 1) {
+  if (task_time() < (1 * FLASH_DURATION) + 1) {
     LED_PORT |= BIT2;
     sleep_474(250);
     return;
   }
 
-  if (timeArr[currTask] < (2 * FLASH_DURATION) + 1) {
+  if (task_time() < (2 * FLASH_DURATION) + 1) {
     LED_PORT &= ~BIT2;
     sleep_474(750);
     return;
   }
 
-  if (timeArr[currTask] >= 1000) {
-    timeArr[currTask]= 0;
+  if (task_time() >= 1000) {
+    task_reset_time();
   }
 
   return;
@@ -201,42 +281,24 @@ void task2() {
   // reset everything given a reset signal
   if (reset2) {
     setOC4AFreq(0);
-    timeArr[currTask] = 0;
+    task_reset_time();
+    melody_start(&theme, 0);
     reset2 = 0;
     return;
   }
 
-  // play tone
-  for (int i = 0; i < NMELODY; i++) {
-    if ( timeArr[currTask] >= ((unsigned long) i * PLAY_DURATION) &&
-      timeArr[currTask] < (((unsigned long) i + 1) * PLAY_DURATION) ) {
-      setOC4AFreq(melody[i]);
-      sleep_474(PLAY_DURATION);
-      return;
-    }
-  }
-
-  // stop playing for 4 seconds
-  if (timeArr[currTask] < PICKUP_TIME) {
-    setOC4AFreq(0);
-    sleep_474(PAUSE_DURATION);
-    return;
-  }
-
-  // start playing after 4 seconds
-  for (int i = 0; i < NMELODY; i++) {
-    if (timeArr[currTask] >= (PICKUP_TIME + ((unsigned long) i) * PLAY_DURATION) &&
-        timeArr[currTask] < (PICKUP_TIME + ((unsigned long) i + 1) * PLAY_DURATION)) {
-      setOC4AFreq(melody[i]);
-      sleep_474(PLAY_DURATION);
-      return;
-    }
-  }
+  // play the next note, or the pause between the two plays
+  int freq = melody_step(&theme);
 
   // reset
-  if (timeArr[currTask] >= (PICKUP_TIME + (unsigned long) NMELODY * PLAY_DURATION)) {
-    timeArr[currTask] = 0;
+  if (freq == MELODY_END) {
+    task_reset_time();
+    melody_start(&theme, 0);
+    freq = melody_step(&theme);
   }
+
+  setOC4ANote(melody_index(&theme));
+  sleep_474((long) (melody_next(&theme) - task_time()));
 }
 
 /**
@@ -290,7 +352,7 @@ void task3() {
   for (int h = 0; h < 5; h++) { // loop through 5 times to display each digit
     for (int i = 0; i < 4; i++) { // loop through 4 times to display each segment of the digit
       int pin = 10 + i; // calculate the pin number for the segment
-      if ((timeArr[currTask] / 5) >= (4 * h) + i && (timeArr[currTask] / 5) < (4 * h) + (i + 1)) {
+      if ((task_time() / 5) >= (4 * h) + i && (task_time() / 5) < (4 * h) + (i + 1)) {
         // if it's time to display the segment, turn on the 7-segment display and the specified digit
         PORTB = displayStates[i];
         byte *disp = seven_seg_digits[digits[i]];
@@ -302,8 +364,8 @@ void task3() {
   }
 
   // reset
-  if (timeArr[currTask] >= 100) { // if it's time to reset
-    timeArr[currTask] = 0; // reset the time
+  if (task_time() >= 100) { // if it's time to reset
+    task_reset_time(); // reset the time
     count = count == 9999 ? 0 : count + 1; // increment the count or reset it if it's at its maximum value
   }
 }
@@ -393,8 +455,9 @@ void speakerSetup() {
   //
   //  f_out = f_i/o / 2 * N * (PRESCALER + 1)
   //
-  // because f_i/o = 16Mhz, we'll just set N = 1
-  TIMER_REG_B |= (0 << CS42) | (0 << CS41) | (1 << CS40);
+  // N is the smallest prescaler the lowest note of the
+  // melody fits, which the tone table picks when compiling
+  TIMER_REG_B |= melody_tones::cs;
   PRESCALER = 0;
   TIMER_COUNTER = 0;
 
@@ -6,6 +6,11 @@
  * - Joey Pirich
  */
 
+#include <FrameIdle.h>
+#include <Melody.h>
+#include <ToneTable.h>
+#include <TCBScheduler.h>
+
 #define BIT0 1<<0
 #define BIT1 1<<1
 #define BIT2 1<<2
@@ -34,7 +39,6 @@
 #define ADURATION 2000
 #define CDURATION 10000
 #define PAUSE_DURATION 4000
-#define PICKUP_TIME long ((NMELODY * PLAY_DURATION) + PAUSE_DURATION)
 
 #define NOTE_C  262
 #define NOTE_CS 277
@@ -51,7 +55,7 @@
 #define NOTE_C5 523
 
 #define NMELODY long(72)
-int melody[] = {
+constexpr int melody[] = {
   NOTE_E, NOTE_E, 0, NOTE_E, 0, NOTE_C, NOTE_E, 0,
   NOTE_G, 0, 0,  0, NOTE_G, 0, 0, 0,
   NOTE_C5, 0, 0, NOTE_G, 0, 0, NOTE_E, 0,
@@ -63,7 +67,8 @@ int melody[] = {
   NOTE_E, 0, NOTE_C, NOTE_D, NOTE_B, 0, 0, NOTE_C5
 };
 
-#define NTASKS 10
+// The OCR4A value of each note of the melody, worked out when compiling
+typedef tone_table<melody, NMELODY> melody_tones;
 
 /// All codes for digits 0-9 on our 7-segment displays
 byte seven_seg_digits[10][7] = { { 1,1,1,1,1,1,0 },  // = 0
@@ -78,36 +83,10 @@ byte seven_seg_digits[10][7] = { { 1,1,1,1,1,1,0 },  // = 0
                                  { 1,1,1,0,0,1,1 }   // = 9
                                  };
 
-typedef enum {READY, RUNNING, SLEEPING, DEAD} STATE;
 typedef enum flagState {PENDING, DONE} FLAG;
 
-/**
- * @brief Struct to hold all of a Tasks running state
- * 
- */
-typedef struct TCB {
-  /// Task name
-  char name[20];
-  /// Task function
-  void (*fn_ptr)();
-  /// Task id
-  int id;
-  /// Number of times task has been run
-  int nTimes;
-  /// Amount of time in ms the task should sleep for
-  int timeSleep;
-  /// Current clock time this task sees
-  long time;
-  /// Running state of this task
-  STATE state;
-} tcb;
-
-/**
- * @brief Suspends the execution of the calling task for a specified amount of time
- * 
- * @param t Time in milliseconds to sleep for
- */
-void sleep_474(long t);
+/// Number of Timer3 frames between reports of the idle time, 5 s of them
+#define IDLE_REPORT_FRAMES 2500
 
 /**
  * @brief Synchronizes the tasks with the system clock
@@ -116,48 +95,18 @@ void sleep_474(long t);
 void schedule_sync();
 
 /**
- * @brief Copies the contents of one TCB to another
- * 
- * @param dst Destination TCB to copy to
- * @param src Source TCB to copy from
- */
-void copy_tcb(tcb * dst, tcb * src);
-
-/**
- * @brief Terminates the calling task
- * 
- */
-void task_self_quit();
-
-/**
- * @brief Starts a new task
- * 
- * @param task Pointer to the TCB of the task to start
- */
-void task_start(tcb * task);
-
-/**
- * @brief Loads a task into the system
- * 
- * @param fn_ptr Pointer to the function to be executed by the task
- * @param name Name of the task
- */
-void task_load(void (*fn_ptr)(), const char * name);
-
-/**
- * @brief Finds a dead task by name
+ * @brief Sets the frequency of the output compare register 4A
  * 
- * @param name Name of the task to find
- * @return tcb* Pointer to the TCB of the dead task, or NULL if not found
+ * @param freq Frequency to set in Hz
  */
-tcb * find_dead_task(const char * name);
+void setOC4AFreq(uint32_t freq);
 
 /**
- * @brief Sets the frequency of the output compare register 4A
+ * @brief Sets the output compare register 4A to play a note of the melody
  * 
- * @param freq Frequency to set in Hz
+ * @param note Index of the note in the melody, or -1 for silence
  */
-void setOC4AFreq(uint32_t freq);
+void setOC4ANote(int note);
 
 /**
  * @brief Task 2 function
@@ -206,9 +155,3 @@ void displaySetup();
  * 
  */
 void ledSetup();
-
-/**
- * @brief Sets up the DDS
- * 
- */
-void DDSSetup();
@@ -3,22 +3,81 @@
 // the Arduino_FreeRTOS is a real-time operating system for Arduino, 
 // the queue library allows for inter-task communication, 
 // task.h is the API for controlling real-time tasks, 
-// and Encoder.h is a library for reading rotary encoders.
+// topic_bus.h lets one task publish events to any number of subscribers,
+// periodic_task.h runs jobs on a fixed, drift-free schedule and tracks their deadlines,
+// rta.h checks from the measured timings whether every periodic job can meet its deadline,
+// stack_monitor.h watches every task's stack and recommends how deep each one needs to be,
+// ram_account.h breaks the kernel's RAM down by object type and by the task that owns it,
+// idle_power.h puts the CPU to sleep when no task needs it and measures how long it slept,
+// Encoder.h is a library for reading rotary encoders,
+// and SevenSeg.h keeps the 7-segment display lit from the Timer5 interrupt.
 #include <arduinoFFT.h>
 #include "Final.h"
 #include <Arduino_FreeRTOS.h>
 #include <queue.h>
 #include <task.h>
+#include <topic_bus.h>
+#include <periodic_task.h>
+#include <rta.h>
+#include <stack_monitor.h>
+#include <ram_account.h>
+#include <idle_power.h>
 #include <Encoder.h>
-
-// The joystick variables store the current state of the joystick.
-// 'joystickMoved' is a boolean indicating whether the joystick has been moved,
-// 'joystickX' and 'joystickY' store the current X and Y positions of the joystick,
-// and 'joystickPressed' is a boolean indicating whether the joystick button has been pressed.
-bool joystickMoved = false;
-int joystickX = 0;
-int joystickY = 0;
-bool joystickPressed = false;
+#include <SevenSeg.h>
+
+// The library leaves the kernel options below off, so build this sketch with them on:
+//   arduino-cli compile -b arduino:avr:mega \
+//     --build-property "build.extra_flags=-DconfigUSE_TASK_BUDGETS=1 -DconfigUSE_RAM_ACCOUNTING=1 -DconfigUSE_IDLE_POWER=1" 4.2
+#if (configUSE_TASK_BUDGETS != 1)
+#error "4.2 caps the countdown's CPU time with a budget, build it with -DconfigUSE_TASK_BUDGETS=1"
+#endif
+#if (configUSE_RAM_ACCOUNTING != 1)
+#error "4.2 reports the kernel's RAM by owner, build it with -DconfigUSE_RAM_ACCOUNTING=1"
+#endif
+#if (configUSE_IDLE_POWER != 1)
+#error "4.2 sleeps when idle and reports how long for, build it with -DconfigUSE_IDLE_POWER=1"
+#endif
+
+// The joystick topic carries a joystick_event_t every time the joystick leaves its stationary position.
+// TaskLCD subscribes through 'lcdJoystickQueue'; a new consumer (a logger, say) only needs its own
+// subscriber and queue, and JobJoyStick doesn't change.
+topicDEFINE(joystickTopic, joystick_event_t);
+TopicSubscriber_t lcdJoystickSubscriber;
+QueueHandle_t lcdJoystickQueue;
+
+// The periodic jobs and their timing: period, phase and relative deadline, in ticks (about 16 ms each).
+// Each job runs once per period on a schedule fixed at start up, so a slow job can't push later
+// releases back. Their jitter, response times and deadline misses are printed by the report job.
+periodicDEFINE(joyStickTask, JobJoyStick, NULL, pdMS_TO_TICKS(100), 0, pdMS_TO_TICKS(100));
+periodicDEFINE(countdownTask, JobCountdown, NULL, pdMS_TO_TICKS(COUNTDOWN_PERIOD_MS), 0, pdMS_TO_TICKS(COUNTDOWN_PERIOD_MS));
+periodicDEFINE(buzzerTask, JobBuzzerAndLED, NULL, pdMS_TO_TICKS(100), 0, pdMS_TO_TICKS(100));
+periodicDEFINE(encoderTask, JobRotaryEncoder, NULL, pdMS_TO_TICKS(ENCODER_PERIOD_MS), 0, pdMS_TO_TICKS(ENCODER_PERIOD_MS));
+periodicDEFINE(ledFlashTask, JobLEDFlash, NULL, pdMS_TO_TICKS(LED_FLASH_PERIOD_MS), 0, pdMS_TO_TICKS(LED_FLASH_PERIOD_MS));
+periodicDEFINE(reportTask, JobReport, NULL, pdMS_TO_TICKS(REPORT_PERIOD_MS), pdMS_TO_TICKS(REPORT_PERIOD_MS), pdMS_TO_TICKS(REPORT_PERIOD_MS));
+
+// Response time analysis inputs and results for the report job, one entry per periodic task and
+// one for TaskLCD. The tasks share no mutexes, but a scoreboard writer suspends the scheduler,
+// which holds off every task, so the longest write is passed as a mutex that all of them use.
+RtaTask_t rtaTasks[NRTA];
+RtaMutex_t rtaScoreboardWrite = { "scoreboard", 0, 0 };
+
+// TaskLCD, and its longest run from a joystick event or refresh timeout to the end of its redraw,
+// in microseconds, not counting the time it waits for the joystick button to be let go.
+TaskHandle_t lcdHandle;
+unsigned long lcdMaxExecutionUs = 0;
+
+// Stack usage of every task, including idle (which also runs loop()) and the timer service task,
+// sampled by the report job. The recommended depths are what the stacks can be trimmed to.
+StackUsage_t stackUsage[stackmonitorMAX_TASKS];
+
+// Kernel RAM by object type and by owning task, printed once by the first report.
+// The type names are kept in flash, indexed by eRamObjectType.
+RamUsage_t ramUsage[eRamNumberOfTypes];
+RamOwner_t ramOwners[ramaccountMAX_OWNERS + 1];
+const char ramTypeNames[eRamNumberOfTypes][14] PROGMEM = {
+    "tcb", "stack", "queue", "queue data", "timer", "event group", "stream", "stream data", "heap overhead"
+};
+bool ramReported = false;
 
 // LCD related variables. 'charIndex' is an array storing the index of each character on the LCD,
 // and 'alphabetIndex' stores the current index in the alphabet (for scrolling through letters).
@@ -28,14 +87,16 @@ int alphabetIndex = 0;
 // The 'message' variable is a string to store a formatted message that will be displayed on the LCD.
 char message[40];  
 
-// Score related variables. 'teamAScore' and 'teamBScore' store the current scores for each team,
-// 'quarter' stores the current quarter of the game,
-// 'teamAName' and 'teamBName' store the names of the teams.
-int teamAScore = 0;
-int teamBScore = 0;
-int quarter = 1;
-char teamAName[7] = "Team A";  
-char teamBName[7] = "Team B";  
+// The scoreboard state (team names, scores, quarter and the countdown) shared between tasks.
+// Writers bracket their updates with scoreboardBeginWrite() and scoreboardEndWrite(), which bump
+// 'scoreboardSeq' to an odd value and back to an even one. Readers take a copy with
+// scoreboardSnapshot() and retry if the sequence moved, so they never block a writer.
+scoreboard_t scoreboard = { "Team A", "Team B", 0, 0, 1, 600 };
+volatile uint8_t scoreboardSeq = 0;
+
+// micros() at the start of the write in progress, and the longest write so far, in microseconds.
+unsigned long scoreboardWriteStartUs;
+unsigned long scoreboardMaxWriteUs = 0;
 
 // Variables related to the selected option in a menu or interface.
 // 'selectedOption' stores the currently selected option,
@@ -49,9 +110,6 @@ int optionStartIndexes[] = {0, 10, 17, 22, 29};
 int optionLengths[] = {6, 6, 2, 5, 2};  
 int numOptions = sizeof(optionStartIndexes) / sizeof(int); 
 
-// A counter variable that starts at 600.
-static unsigned long count = 600;
-
 // Variables related to the encoder position.
 // 'encoderPos' stores the current position of the encoder (and is volatile because it may be changed in an interrupt routine),
 // 'myEncoder' is an Encoder object,
@@ -65,13 +123,15 @@ int timerMinutes = 12;
 int timerSeconds = 0;
 
 /**
- * @brief Initializes the board and creates tasks for joystick input, LCD screen update, countdown, buzzer and LED control, and rotary encoder input.
+ * @brief Initializes the board and creates tasks for joystick input, LCD screen update, countdown, buzzer and LED control, rotary encoder input,
+ * LED flashing and timing reports.
  * 
  * @return void
  */
 void setup() {
-    // initialize serial communication at 9600 bits per second:
-    Serial.begin(9600);
+    // initialize serial communication at 115200 bits per second, so the report holds the port for
+    // a twelfth of the time it would at 9600
+    Serial.begin(115200);
 
     // initialize sensor pins as inputs:
     pinMode(JOY_X, INPUT);
@@ -88,8 +148,8 @@ void setup() {
     pinMode(ROTARY_SW, INPUT_PULLUP);  // Enable internal pull-up resistor
     pinMode(OFFBOARD_LED_PIN, OUTPUT); // initialize off-board LED pin as output:
 
-    // initialize 7-segment display
-    displaySetup();
+    // initialize 7-segment display, refreshed from the Timer5 interrupt from now on
+    seven_seg_begin();
 
     // initialize LCD
     lcdInit();
@@ -97,16 +157,29 @@ void setup() {
     lcdSetCursor(0, 0);
 
     // Format and print the Message on the LCD Screen
-    sprintf(message, "%s    %s %02d   Qtr:%d  %02d  ", teamAName, teamBName, teamAScore, quarter, teamBScore);
+    scoreboard_t snap;
+    scoreboardSnapshot(&snap);
+    formatScoreboard(message, &snap);
     lcdPrint(message);
 
-    // Create the Tasks
-    xTaskCreate(TaskJoyStick, "JoyStick", 128, NULL, 1, NULL);
-    xTaskCreate(TaskLCD, "LCD", 128, NULL, 1, NULL);
-    xTaskCreate(TaskCountdown, "Countdown", 128, NULL, 1, NULL);
-    xTaskCreate(TaskBuzzerAndLED, "BuzzerAndLED", 128, NULL, 1, NULL);
-    xTaskCreate(TaskRotaryEncoder, "Encoder", 128, NULL, 1, NULL);
-    xTaskCreate(TaskLEDFlash, "LEDFlash", 128, NULL, 1, NULL);  // Add the new task here
+    // Subscribe the LCD task to joystick events
+    lcdJoystickQueue = xQueueCreate(JOY_QUEUE_LENGTH, sizeof(joystick_event_t));
+    xTopicSubscribeQueue(&joystickTopic, &lcdJoystickSubscriber, lcdJoystickQueue);
+
+    // Create the Tasks, rate monotonic: the 16 ms encoder above the 100 ms jobs and the LCD, and
+    // the 5 s report below them all, so its printing can't hold up the others.
+    // Arduino_FreeRTOS/extras/rta/scoreboard.txt checks these priorities with the measured times.
+    xTaskCreate(TaskLCD, "LCD", 128, NULL, 2, &lcdHandle);
+    xPeriodicTaskCreate(&joyStickTask, 128, 2);
+    xPeriodicTaskCreate(&countdownTask, 128, 2);
+    xPeriodicTaskCreate(&buzzerTask, 128, 2);
+    xPeriodicTaskCreate(&encoderTask, 128, 3);
+    xPeriodicTaskCreate(&ledFlashTask, 128, 2);  // Add the new task here
+    xPeriodicTaskCreate(&reportTask, 256, 1);
+
+    // Cap the countdown job's CPU time, so if it ever runs away it is throttled until its
+    // next period instead of starving the other priority 2 tasks and the report
+    vTaskSetBudget(xPeriodicTaskGetHandle(&countdownTask), COUNTDOWN_BUDGET_US, pdMS_TO_TICKS(COUNTDOWN_PERIOD_MS));
 
 
     // Start the scheduler
@@ -123,24 +196,19 @@ void setup() {
     /*--------------------------------------------------*/
 
     /**
-     * @brief Task function to read joystick input and update global variables accordingly.
+     * @brief Periodic job to read joystick input and publish it on the joystick topic, every 100 ms.
      * 
-     * @param pvParameters Pointer to task parameters (not used in this function).
+     * @param pvParameters Pointer to job parameters (not used in this function).
      * @return void
      */
-    void TaskJoyStick(void *pvParameters) {
-        for (;;) {
-            int x = analogRead(JOY_X);
-            int y = analogRead(JOY_Y);
-            int sw = digitalRead(JOY_SW);
-
-            if (x != 512 || y != 512 || sw == LOW) {  // If joystick is not in the stationary position
-                joystickMoved = true;
-                joystickX = x;
-                joystickY = y;
-                joystickPressed = (sw == LOW);
-            }
-            vTaskDelay(pdMS_TO_TICKS(100));  // Short delay before next read
+    void JobJoyStick(void *pvParameters) {
+        int x = analogRead(JOY_X);
+        int y = analogRead(JOY_Y);
+        int sw = digitalRead(JOY_SW);
+
+        if (x != 512 || y != 512 || sw == LOW) {  // If joystick is not in the stationary position
+            joystick_event_t event = { x, y, sw == LOW };
+            uxTopicPublish(&joystickTopic, &event);
         }
     }
 /**
@@ -155,7 +223,7 @@ void setup() {
  * 
  * The LCD screen should also display a blinking cursor to indicate which option is selected.
  * 
- * The LCD screen should be updated every 100 ms.
+ * The LCD screen should be updated every 100 ms, or as soon as a joystick event arrives.
  * 
  * @param pvParameters Pointer to task parameters (not used in this function).
  * 
@@ -169,6 +237,20 @@ void setup() {
     bool blinkState = false;
 
     for (;;) {
+        // Wait up to one refresh period for the next joystick event
+        joystick_event_t event;
+        bool joystickMoved = false;
+        bool joystickPressed = false;
+        int joystickX = 512;
+        int joystickY = 512;
+        if (xQueueReceive(lcdJoystickQueue, &event, pdMS_TO_TICKS(100)) == pdTRUE) {
+            joystickMoved = true;
+            joystickX = event.x;
+            joystickY = event.y;
+            joystickPressed = event.pressed;
+        }
+        unsigned long startUs = micros();
+
         // Move selected option or letter based on joystick position
         if (joystickMoved) {
             if (selectedOption == -1) {  // If no option is selected
@@ -186,34 +268,34 @@ void setup() {
             }
         }
         if (joystickMoved && selectedOption != -1) {  // If an option is selected
+            // Edit the scoreboard in place; the display picks the change up on its next snapshot
+            scoreboardBeginWrite();
             if (selectedOption == 2 || selectedOption == 3 || selectedOption == 4) {  // If the selected option is a score or quarter
                 if (joystickY < JOY_THRESHOLD) {
                     if (selectedOption == 2) {
-                        teamAScore++;
-                        if (teamAScore >= 99) teamAScore = 99;  // Don't allow negative scores
-                    } else if (selectedOption == 3 && quarter < 4) {
-                        quarter++;
+                        scoreboard.teamAScore++;
+                        if (scoreboard.teamAScore >= 99) scoreboard.teamAScore = 99;  // Don't allow negative scores
+                    } else if (selectedOption == 3 && scoreboard.quarter < 4) {
+                        scoreboard.quarter++;
                     } else if (selectedOption == 4) {
-                        teamBScore++;
-                        if (teamBScore >= 99) teamBScore = 99;  // Don't allow negative scores
+                        scoreboard.teamBScore++;
+                        if (scoreboard.teamBScore >= 99) scoreboard.teamBScore = 99;  // Don't allow negative scores
                     }
                 } else if (joystickY > 1023 - JOY_THRESHOLD) {
-                    if (selectedOption == 2 && teamAScore > 0) {
-                        teamAScore--;
-                    } else if (selectedOption == 3 && quarter > 1) {
-                        quarter--;
-                    } else if (selectedOption == 4 && teamBScore > 0) {
-                        teamBScore--;
+                    if (selectedOption == 2 && scoreboard.teamAScore > 0) {
+                        scoreboard.teamAScore--;
+                    } else if (selectedOption == 3 && scoreboard.quarter > 1) {
+                        scoreboard.quarter--;
+                    } else if (selectedOption == 4 && scoreboard.teamBScore > 0) {
+                        scoreboard.teamBScore--;
                     }
                 }
-                // Update the message with the new scores and quarter
-             sprintf(message, "%s    %s %02d   Qtr:%d  %02d  ", teamAName, teamBName, teamAScore, quarter, teamBScore);
             } else {
                 for (int i = 0; i < strlen(ALPHABET); i++) {
-                    if (selectedOption == 0 && ALPHABET[i] == teamAName[selectedLetter - optionStartIndexes[selectedOption]]) {
+                    if (selectedOption == 0 && ALPHABET[i] == scoreboard.teamAName[selectedLetter - optionStartIndexes[selectedOption]]) {
                         alphabetIndex = i;
                         break;
-                    } else if (selectedOption == 1 && ALPHABET[i] == teamBName[selectedLetter - optionStartIndexes[selectedOption]]) {
+                    } else if (selectedOption == 1 && ALPHABET[i] == scoreboard.teamBName[selectedLetter - optionStartIndexes[selectedOption]]) {
                         alphabetIndex = i;
                         break;
                     }
@@ -225,9 +307,9 @@ void setup() {
                         alphabetIndex++;
                     }
                     if (selectedOption == 0) {
-                        teamAName[selectedLetter - optionStartIndexes[selectedOption]] = ALPHABET[alphabetIndex];
+                        scoreboard.teamAName[selectedLetter - optionStartIndexes[selectedOption]] = ALPHABET[alphabetIndex];
                     } else if (selectedOption == 1) {
-                        teamBName[selectedLetter - optionStartIndexes[selectedOption]] = ALPHABET[alphabetIndex];
+                        scoreboard.teamBName[selectedLetter - optionStartIndexes[selectedOption]] = ALPHABET[alphabetIndex];
                     }
                 } else if (joystickY > 1023 - JOY_THRESHOLD) {
                     if (alphabetIndex == 0) {
@@ -236,15 +318,13 @@ void setup() {
                         alphabetIndex--;
                     }
                     if (selectedOption == 0) {
-                        teamAName[selectedLetter - optionStartIndexes[selectedOption]] = ALPHABET[alphabetIndex];
+                        scoreboard.teamAName[selectedLetter - optionStartIndexes[selectedOption]] = ALPHABET[alphabetIndex];
                     } else if (selectedOption == 1) {
-                        teamBName[selectedLetter - optionStartIndexes[selectedOption]] = ALPHABET[alphabetIndex];
+                        scoreboard.teamBName[selectedLetter - optionStartIndexes[selectedOption]] = ALPHABET[alphabetIndex];
                     }
                 }
-                // Update the message with the new team name
-                sprintf(message, "%s    %s %02d   Qtr:%d  %02d  ", teamAName, teamBName, teamAScore, quarter, teamBScore);
             }
-            joystickMoved = false;
+            scoreboardEndWrite();
         }
 
         // Select or deselect option based on joystick press
@@ -256,13 +336,21 @@ void setup() {
                 selectedOption = -1;
                 selectedLetter = 0;  // Reset to the first option
             }
-            // waste some time while the button is held down
+            // waste some time while the button is held down, which doesn't count towards the run
+            unsigned long heldUs = micros();
             while (digitalRead(JOY_SW) == LOW) {
                 vTaskDelay(pdMS_TO_TICKS(50));
             }
-            joystickPressed = false;
+            startUs += micros() - heldUs;
+            // drop the events published while the button was held
+            xQueueReset(lcdJoystickQueue);
         }
 
+        // Render from a consistent copy of the scoreboard so a preempting writer can't tear it
+        scoreboard_t snap;
+        scoreboardSnapshot(&snap);
+        formatScoreboard(message, &snap);
+
         for (int i = 0; i < LCD_COLS * LCD_ROWS; i++) {
             if ((selectedOption == -1 && i >= optionStartIndexes[selectedLetter] && i < optionStartIndexes[selectedLetter] + optionLengths[selectedLetter]) || 
                 (selectedOption != -1 && selectedOption != 0 && selectedOption != 1 && i >= optionStartIndexes[selectedOption] && i < optionStartIndexes[selectedOption] + optionLengths[selectedOption]) || 
@@ -285,56 +373,58 @@ void setup() {
             }
         }
 
-        vTaskDelay(pdMS_TO_TICKS(100));  // Short delay before next update
+        // Update the longest run with the scheduler suspended, so the report never reads half of it
+        unsigned long runUs = micros() - startUs;
+        vTaskSuspendAll();
+        if (runUs > lcdMaxExecutionUs) {
+            lcdMaxExecutionUs = runUs;
+        }
+        xTaskResumeAll();
     }
 }   
 
 /**
- * @brief Task function to update and display a countdown timer on a 7-segment display.
+ * @brief Periodic job to update and display a countdown timer on a 7-segment display, every 100 ms.
  * 
  * This function updates and displays a countdown timer on a 7-segment display. The countdown timer
- * is initialized to 10 minutes (600 seconds) and decrements by tenths of a second. The timer is
- * only decremented if the CLOCK_SWITCH pin is HIGH. The function converts the countdown timer into
+ * starts at 10 minutes (600 seconds) and decrements by the tenths of a second millis() has counted since
+ * the release before, keeping the remainder for the next one, so it runs at the crystal's rate rather than
+ * the watchdog tick's. The timer is only decremented if the CLOCK_SWITCH pin is HIGH, and the tenths that
+ * pass while it is LOW are dropped. The function converts the countdown timer into
  * minutes, seconds, and tenths, and then converts each of these values into separate digits to be
- * displayed on the 7-segment display. The function uses a static array to store the display states
- * of each digit, and cycles through these states to display each digit on the 7-segment display.
+ * displayed on the 7-segment display. The digits go to the display's frame buffer, and the Timer5
+ * interrupt keeps them lit until the next release, so the job returns straight away.
  * 
- * @param pvParameters Pointer to task parameters (not used in this function).
+ * @param pvParameters Pointer to job parameters (not used in this function).
  * @return void
  */
-void TaskCountdown(void *pvParameters) {
-    // Initialize the countdown timer to 10 minutes (600 seconds)
-    count = 600; // Count in tenths of a second
-    int digits[4]; // Array to store digits of count
-    static int displayStates[4] = {S0, S1, S2, S3}; // Array to store display states
+void JobCountdown(void *pvParameters) {
+    byte digits[4]; // Array to store digits of count
+    static unsigned long countedMs = millis(); // Time the tenths have been counted up to
+
+    // Count the whole tenths since the last release, the rest carries over to the next one
+    unsigned long elapsedTenths = (millis() - countedMs) / 100;
+    countedMs += elapsedTenths * 100;
+
+    int clockSwitch = digitalRead(CLOCK_SWITCH);
+    // Decrement the countdown timer only if CLOCK_SWITCH is HIGH
+    scoreboardBeginWrite();
+    if (clockSwitch == HIGH) {
+        scoreboard.count = scoreboard.count > elapsedTenths ? scoreboard.count - elapsedTenths : 0;
+    }
+    unsigned long count = scoreboard.count;
+    scoreboardEndWrite();
 
-    for (;;) {
-        // Start a timer to count to 100 milliseconds
-        unsigned long start = millis();
-        Serial.println(digitalRead(CLOCK_SWITCH));
-        // Decrement the countdown timer only if CLOCK_SWITCH is HIGH
-        if (digitalRead(CLOCK_SWITCH) == HIGH && count > 0) {
-            count--;
-        }
+    // Convert the count into minutes, seconds, and tenths
+    int minutes = count / 600;
+    int seconds = (count % 600) / 10;
+    int tenths = count % 10;
 
-        // Convert the count into minutes, seconds, and tenths
-        int minutes = count / 600;
-        int seconds = (count % 600) / 10;
-        int tenths = count % 10;
-
-        // Convert the minutes, seconds, and tenths into separate digits
-        convert(digits, minutes, seconds, tenths);
-
-        while (millis() - start < 100) { 
-            // Display the countdown timer on the 7-segment display
-            for (int h = 0; h < 4; h++) {
-                PORTB = displayStates[h]; // Select the digit
-                byte *disp = seven_seg_digits[digits[h]]; // Get the 7-segment code for the digit
-                send7(disp); // Send the 7-segment code to the display
-                delayMicroseconds(2500); // Add a short delay after setting each digit
-            }
-        }
-    }
+    // Convert the minutes, seconds, and tenths into separate digits
+    convert(digits, minutes, seconds, tenths);
+
+    // Show the countdown timer on the 7-segment display from its next scan
+    seven_seg_show_digits(digits);
 }
 
 /**
@@ -471,135 +561,364 @@ void lcdPrint(const char* str) {
 }
 
 /**
- * @brief Task function to control the buzzer and LED based on button press and timer countdown.
+ * @brief Periodic job to control the buzzer and LED based on button press and timer countdown, every 100 ms.
  * 
  * This function checks if the button is pressed or the timer has hit zero, and turns on the buzzer and LED accordingly.
- * If the button is not pressed and the timer has not hit zero, the buzzer and LED are turned off.
+ * Once triggered they stay on for BUZZER_HOLD_RELEASES more releases. After that, if the button is not pressed and the
+ * timer has not hit zero, the buzzer and LED are turned off.
  * 
- * @param pvParameters Pointer to task parameters (not used in this function).
+ * @param pvParameters Pointer to job parameters (not used in this function).
  * @return void
  */
-void TaskBuzzerAndLED(void *pvParameters) {
-    for (;;) {
-        // Check if the button is pressed or the timer hit zero
-        if (digitalRead(BUTTON_PIN) == HIGH || count == 0) {
-            // Put a Tone on the Buzzer
-            tone(BUZZER_PIN, 1000);
-
-            digitalWrite(LED_PIN, HIGH);
+void JobBuzzerAndLED(void *pvParameters) {
+    static int holdReleases = 0; // Releases left to keep the buzzer on after it was triggered
+    scoreboard_t snap;
+
+    // Check if the button is pressed or the timer hit zero
+    scoreboardSnapshot(&snap);
+    if (digitalRead(BUTTON_PIN) == HIGH || snap.count == 0) {
+        // Put a Tone on the Buzzer
+        tone(BUZZER_PIN, 1000);
+
+        digitalWrite(LED_PIN, HIGH);
+
+        // Keep it on for a while
+        holdReleases = BUZZER_HOLD_RELEASES;
+    } else if (holdReleases > 0) {
+        holdReleases--;
+    } else {
+        // Turn off the Buzzer
+        noTone(BUZZER_PIN);
+        digitalWrite(LED_PIN, LOW);
+    }
+}
 
-            // Delay for a while
-            vTaskDelay(pdMS_TO_TICKS(200));
+/**
+ * @brief Periodic job to read the rotary encoder input and update the global count variable accordingly.
+ * 
+ * This function reads the rotary encoder input and updates the global count variable based on the direction of rotation.
+ * If the rotary encoder button is pressed, the count variable is reset to 600 and the encoder's position is set to 0.
+ * 
+ * @param pvParameters Pointer to job parameters (not used in this function).
+ * @return void
+ */
+void JobRotaryEncoder(void *pvParameters) {
+    long newPosition = myEncoder.read();
+    if (newPosition != oldPosition) {
+        scoreboardBeginWrite();
+        // Keep the count on the four digits: 9:59.9 at most, and never below zero
+        if (newPosition > oldPosition) {
+            scoreboard.count = min(scoreboard.count + 10, COUNTDOWN_MAX);
+        } else if (newPosition < oldPosition) {
+            scoreboard.count = scoreboard.count > 10 ? scoreboard.count - 10 : 0;
         }
-         else {
-            // Turn off the Buzzer
-            noTone(BUZZER_PIN);
-            digitalWrite(LED_PIN, LOW);
+        unsigned long count = scoreboard.count;
+        scoreboardEndWrite();
+        Serial.println(count);
+        oldPosition = newPosition;
     }
 
-    // Delay for a while
-    vTaskDelay(pdMS_TO_TICKS(100));
+    if (digitalRead(ROTARY_SW) == LOW) {
+        scoreboardBeginWrite();
+        scoreboard.count = 600;
+        scoreboardEndWrite();
+        myEncoder.write(0); // We reset the encoder's position to 0
+        Serial.println(600);
     }
 }
 
 /**
- * @brief Task function to read the rotary encoder input and update the global count variable accordingly.
+ * @brief Periodic job to flash an off-board LED on and off. The LED is ON for 100ms and OFF for 200ms.
  * 
- * This function reads the rotary encoder input and updates the global count variable based on the direction of rotation.
- * If the rotary encoder button is pressed, the count variable is reset to 600 and the encoder's position is set to 0.
+ * The job runs every 100 ms and turns the LED on for the first of every three releases.
  * 
- * @param pvParameters Pointer to task parameters (not used in this function).
+ * @param pvParameters Pointer to job parameters (not used in this function).
  * @return void
  */
-void TaskRotaryEncoder(void *pvParameters) {
-    for (;;) {
-        long newPosition = myEncoder.read();
-        if (newPosition != oldPosition) {
-            if (newPosition > oldPosition) {
-                count = count + 10;
-            } else if (newPosition < oldPosition) {
-                count = count - 10;
-            }
-            Serial.println(count);
-            oldPosition = newPosition;
-        }
+void JobLEDFlash(void *pvParameters) {
+    static int release = 0;
 
-        if (digitalRead(ROTARY_SW) == LOW) {
-            count = 600;
-            myEncoder.write(0); // We reset the encoder's position to 0
-            Serial.println(count);
-        }
+    digitalWrite(OFFBOARD_LED_PIN, release == 0 ? HIGH : LOW);
+    release = (release + 1) % 3;
+}
+
+/**
+ * @brief Periodic job to print the timing statistics of every periodic task over serial.
+ * 
+ * Prints one line per task with its releases, worst release jitter and response time in ticks,
+ * worst execution time in microseconds, the number of deadline misses and overruns, and how many times
+ * the task was throttled for using up its CPU budget. Then runs a response time analysis of the periodic
+ * tasks and TaskLCD with the worst execution times and scoreboard write seen so far, and prints each
+ * task's blocking term, worst case response time and slack, checks every task's stack, and prints how
+ * long the CPU slept since the previous report.
+ * 
+ * @param pvParameters Pointer to job parameters (not used in this function).
+ * @return void
+ */
+void JobReport(void *pvParameters) {
+    PeriodicTaskStats_t stats;
+
+    // By the first report every task, including idle and the timer service task, has been created
+    if (!ramReported) {
+        printRamReport();
+        ramReported = true;
+    }
+
+    Serial.println(F("task\treleases\tjitter\tresponse\texec_us\tmisses\toverruns\tthrottled"));
+    for (PeriodicTask_t *task = pxPeriodicTaskGetNext(NULL); task != NULL; task = pxPeriodicTaskGetNext(task)) {
+        vPeriodicTaskGetStats(task, &stats);
+        Serial.print(pcPeriodicTaskGetName(task));
+        Serial.print('\t');
+        Serial.print(stats.ulReleases);
+        Serial.print('\t');
+        Serial.print(stats.xMaxReleaseJitter);
+        Serial.print('\t');
+        Serial.print(stats.xMaxResponseTime);
+        Serial.print('\t');
+        Serial.print(stats.ulMaxExecutionUs);
+        Serial.print('\t');
+        Serial.print(stats.usDeadlineMisses);
+        Serial.print('\t');
+        Serial.print(stats.usOverruns);
+        Serial.print('\t');
+        Serial.println(usTaskGetBudgetOverruns(xPeriodicTaskGetHandle(task)));
+    }
+
+    // Feed the worst execution times seen so far into a response time analysis
+    size_t n = 0;
+    for (PeriodicTask_t *task = pxPeriodicTaskGetNext(NULL); task != NULL && n < NPERIODIC; task = pxPeriodicTaskGetNext(task)) {
+        vPeriodicTaskGetStats(task, &stats);
+        rtaTasks[n].pcName = pcPeriodicTaskGetName(task);
+        rtaTasks[n].ulPeriod = (uint32_t) xPeriodicTaskGetPeriod(task) * portTICK_PERIOD_MS * 1000;
+        rtaTasks[n].ulDeadline = (uint32_t) xPeriodicTaskGetDeadline(task) * portTICK_PERIOD_MS * 1000;
+        rtaTasks[n].ulWcet = stats.ulMaxExecutionUs;
+        rtaTasks[n].ucPriority = uxTaskPriorityGet(xPeriodicTaskGetHandle(task));
+        n++;
+    }
 
-        vTaskDelay(pdMS_TO_TICKS(10));
+    // Take the LCD's and the writers' longest times together, both are only written with the scheduler suspended
+    vTaskSuspendAll();
+    unsigned long lcdUs = lcdMaxExecutionUs;
+    rtaScoreboardWrite.ulHoldTime = scoreboardMaxWriteUs;
+    xTaskResumeAll();
+
+    // TaskLCD runs for each joystick event, at most one per joystick period, and after a joystick
+    // period with no event, so it can run twice in one period but no more
+    rtaTasks[n].pcName = pcTaskGetName(lcdHandle);
+    rtaTasks[n].ulPeriod = (uint32_t) xPeriodicTaskGetPeriod(&joyStickTask) * portTICK_PERIOD_MS * 1000;
+    rtaTasks[n].ulDeadline = 0;
+    rtaTasks[n].ulWcet = 2 * lcdUs;
+    rtaTasks[n].ucPriority = uxTaskPriorityGet(lcdHandle);
+    n++;
+
+    // Suspending the scheduler holds off every task, whatever its priority
+    rtaScoreboardWrite.ulUsers = (n < 32) ? (1UL << n) - 1 : 0xFFFFFFFFUL;
+    size_t misses = xRtaAnalyse(rtaTasks, n, &rtaScoreboardWrite, 1);
+
+    Serial.println(F("task\tblocking_us\tresponse_us\tslack_us"));
+    for (size_t i = 0; i < n; i++) {
+        Serial.print(rtaTasks[i].pcName);
+        Serial.print('\t');
+        Serial.print(rtaTasks[i].ulBlocking);
+        Serial.print('\t');
+        Serial.print(rtaTasks[i].ulResponse);
+        Serial.print('\t');
+        Serial.println(rtaTasks[i].lSlack);
     }
+    Serial.println(misses == 0 ? F("schedulable") : F("NOT schedulable"));
+
+    // Warn about any stack close to overflowing, then show what every stack could be cut to
+    uxStackMonitorCheck(stackLow);
+    n = uxStackMonitorSample(stackUsage, stackmonitorMAX_TASKS);
+    long reclaimable = 0;
+    Serial.println(F("task\tdepth\tfree\trecommended"));
+    for (size_t i = 0; i < n; i++) {
+        Serial.print(stackUsage[i].pcTaskName);
+        Serial.print('\t');
+        Serial.print(stackUsage[i].usStackDepth);
+        Serial.print('\t');
+        Serial.print(stackUsage[i].usHighWaterMark);
+        Serial.print('\t');
+        Serial.println(stackUsage[i].usRecommended);
+        reclaimable += (long) stackUsage[i].usStackDepth - stackUsage[i].usRecommended;
+    }
+    Serial.print(F("stack bytes reclaimable: "));
+    Serial.println(reclaimable);
+
+    // The share of the last report period the CPU spent asleep is the headroom the task set leaves
+    IdlePowerStats_t power;
+    vIdlePowerGetStats(&power);
+    vIdlePowerResetStats();
+    uint32_t slept = power.ulResidencyUs[eIdlePowerIdle] + power.ulResidencyUs[eIdlePowerSave] + power.ulResidencyUs[eIdlePowerDown];
+    Serial.print(F("asleep "));
+    Serial.print(power.ulElapsedUs < 1000 ? 0 : slept / (power.ulElapsedUs / 1000));
+    Serial.print(F(" per mille, idle/save/down us "));
+    Serial.print(power.ulResidencyUs[eIdlePowerIdle]);
+    Serial.print('/');
+    Serial.print(power.ulResidencyUs[eIdlePowerSave]);
+    Serial.print('/');
+    Serial.print(power.ulResidencyUs[eIdlePowerDown]);
+    Serial.print(F(", sleeps "));
+    Serial.print(power.ulEntries[eIdlePowerIdle] + power.ulEntries[eIdlePowerSave] + power.ulEntries[eIdlePowerDown]);
+    Serial.print(F(", skipped "));
+    Serial.println(power.ulEntries[eIdlePowerNone]);
 }
 
 /**
- * @brief Task function to flash an off-board LED on and off. The LED is ON for 100ms and OFF for 200ms.
+ * @brief Prints the RAM used by the kernel.
+ * 
+ * This function prints the size of each kind of kernel object for the current FreeRTOSConfig.h,
+ * then the RAM live kernel objects hold, broken down by object type and by the task that owns them.
+ * A task owns its own TCB and stack and everything it creates; objects created in setup() are
+ * listed under "setup".
  * 
- * @param pvParameters Pointer to task parameters (not used in this function).
  * @return void
  */
-void TaskLEDFlash(void *pvParameters) {
-    for (;;) {
-        digitalWrite(OFFBOARD_LED_PIN, HIGH);  // Turn on the LED
-        vTaskDelay(pdMS_TO_TICKS(100));       // Delay for 100ms
-        digitalWrite(OFFBOARD_LED_PIN, LOW);   // Turn off the LED
-        vTaskDelay(pdMS_TO_TICKS(200));       // Delay for 200ms
+void printRamReport() {
+    Serial.print(F("sizeof tcb "));
+    Serial.print(ramaccountSIZEOF_TCB);
+    Serial.print(F(" queue "));
+    Serial.print(ramaccountSIZEOF_QUEUE);
+    Serial.print(F(" timer "));
+    Serial.print(ramaccountSIZEOF_TIMER);
+    Serial.print(F(" event group "));
+    Serial.print(ramaccountSIZEOF_EVENT_GROUP);
+    Serial.print(F(" stream "));
+    Serial.println(ramaccountSIZEOF_STREAM_BUFFER);
+
+    vRamAccountGetUsage(ramUsage);
+    size_t total = 0;
+    Serial.println(F("type	objects	bytes"));
+    for (int i = 0; i < eRamNumberOfTypes; i++) {
+        Serial.print((const __FlashStringHelper *) ramTypeNames[i]);
+        Serial.print('\t');
+        Serial.print(ramUsage[i].usObjects);
+        Serial.print('\t');
+        Serial.println(ramUsage[i].xBytes);
+        total += ramUsage[i].xBytes;
+    }
+    Serial.print(F("kernel total\t\t"));
+    Serial.println(total);
+
+    UBaseType_t n = uxRamAccountGetOwners(ramOwners, ramaccountMAX_OWNERS + 1);
+    Serial.println(F("owner\tbytes"));
+    for (UBaseType_t i = 0; i < n; i++) {
+        if (ramOwners[i].xHandle != NULL) {
+            Serial.print(pcTaskGetName(ramOwners[i].xHandle));
+        } else if (ramOwners[i].uxTaskNumber == 0) {
+            Serial.print(F("setup"));
+        } else {
+            Serial.print(F("deleted"));
+        }
+        Serial.print('\t');
+        Serial.println(ramOwners[i].xBytes);
     }
 }
 
 /**
- * @brief Converts the input time values into an array of digits.
+ * @brief Reports a task that is running low on stack.
  * 
- * This function takes in the input time values (minutes, seconds, and tenths) and separates
- * their digits, storing them in an array. The array is passed in as a pointer to an integer.
+ * This function is called by the stack monitor from the report job for each task with fewer than
+ * stackmonitorWARN_FREE words of stack that have never been used.
  * 
- * @param digits Pointer to an integer array to store the separated digits.
- * @param minutes The number of minutes in the input time.
- * @param seconds The number of seconds in the input time.
- * @param tenths The number of tenths of a second in the input time.
+ * @param usage the stack usage of the task.
  * 
  * @return void
  */
-void convert(int * digits, int minutes, int seconds, int tenths) {
-    // Separate the digits of the minutes, seconds, and tenths and store them in the array
-    digits[0] = tenths;
-    digits[1] = seconds % 10;
-    digits[2] = (seconds/10) % 10;
-    digits[3] = minutes;
+void stackLow(const StackUsage_t *usage) {
+    Serial.print(F("stack low: "));
+    Serial.print(usage->pcTaskName);
+    Serial.print(F(" has "));
+    Serial.print(usage->usHighWaterMark);
+    Serial.print(F(" of "));
+    Serial.print(usage->usStackDepth);
+    Serial.println(F(" words left"));
 }
-    
+
 /**
- * @brief Sends an array of 7 bytes to the 7-segment display.
+ * @brief Starts an update of the shared scoreboard.
  * 
- * @param arr An array of 7 bytes to send to the 7-segment display.
+ * This function suspends the scheduler so writers are serialized against each other, then bumps
+ * the sequence number to an odd value so any reader that was preempted mid-copy will retry.
+ * Every call must be paired with scoreboardEndWrite().
  * 
  * @return void
  */
-void send7(byte arr[7]) {
-  int data = 0; // initialize a variable to store the data to be sent to the 7-segment display
-  for (int i = 0; i < 7; i++) { // loop through each byte in the array
-    data |= (arr[i] << i); // set the corresponding bit in the data variable to the value of the byte
-  }
-  PORTA = data; // send the data to the 7-segment display
+void scoreboardBeginWrite() {
+    vTaskSuspendAll();
+    scoreboardWriteStartUs = micros();
+    scoreboardSeq++;
+    SCOREBOARD_BARRIER();
 }
 
+/**
+ * @brief Finishes an update of the shared scoreboard.
+ * 
+ * This function bumps the sequence number back to an even value, publishing the update, records
+ * how long the scheduler was suspended for the report job's response time analysis, and resumes
+ * the scheduler.
+ * 
+ * @return void
+ */
+void scoreboardEndWrite() {
+    SCOREBOARD_BARRIER();
+    scoreboardSeq++;
+    unsigned long heldUs = micros() - scoreboardWriteStartUs;
+    if (heldUs > scoreboardMaxWriteUs) {
+        scoreboardMaxWriteUs = heldUs;
+    }
+    xTaskResumeAll();
+}
 
 /**
- * @brief Sets up the pins for the 7-segment display and digit selectors.
+ * @brief Copies a consistent snapshot of the shared scoreboard.
  * 
- * @param None
+ * This function copies the scoreboard without locking anything. If the sequence number was odd
+ * (a write in progress) or changed during the copy, the copy may be torn and is retried.
  * 
+ * @param snap Pointer to the scoreboard to copy into.
  * @return void
  */
-void displaySetup() {
-  // set up digit selectors
-  DDRB |= BIT7 | BIT6 | BIT5 | BIT4; // set pins 4-7 on PORTB as output pins
+void scoreboardSnapshot(scoreboard_t *snap) {
+    uint8_t seq;
+    do {
+        seq = scoreboardSeq;
+        SCOREBOARD_BARRIER();
+        memcpy(snap, &scoreboard, sizeof(scoreboard_t));
+        SCOREBOARD_BARRIER();
+    } while ((seq & 1) || seq != scoreboardSeq);
+}
 
-  // set up 7-seg outputs
-  DDRA |= BIT7 | BIT6 | BIT5 | BIT4 | BIT3 | BIT2 | BIT1 | BIT0; // set pins 0-7 on PORTA as output pins
+/**
+ * @brief Formats a scoreboard snapshot into the LCD message layout.
+ * 
+ * @param buf Buffer of at least 40 characters to format into.
+ * @param snap The scoreboard snapshot to format.
+ * @return void
+ */
+void formatScoreboard(char *buf, const scoreboard_t *snap) {
+    sprintf(buf, "%s    %s %02d   Qtr:%d  %02d  ", snap->teamAName, snap->teamBName, snap->teamAScore, snap->quarter, snap->teamBScore);
+}
 
-  PORTB |= BIT7 | BIT6 | BIT5 | BIT4; // set pins 4-7 on PORTB to HIGH
+/**
+ * @brief Converts the input time values into an array of digits.
+ * 
+ * This function takes in the input time values (minutes, seconds, and tenths) and separates
+ * their digits, storing them in an array. The array is passed in as a pointer to a byte.
+ * 
+ * @param digits Pointer to an integer array to store the separated digits.
+ * @param minutes The number of minutes in the input time.
+ * @param seconds The number of seconds in the input time.
+ * @param tenths The number of tenths of a second in the input time.
+ * 
+ * @return void
+ */
+void convert(byte * digits, int minutes, int seconds, int tenths) {
+    // Separate the digits of the minutes, seconds, and tenths and store them in the array
+    digits[0] = tenths;
+    digits[1] = seconds % 10;
+    digits[2] = (seconds/10) % 10;
+    digits[3] = minutes;
 }
+    
 
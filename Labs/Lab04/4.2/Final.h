@@ -11,6 +11,9 @@
 #define BLINK_DELAY 500  
 #define JOY_THRESHOLD 200  
 
+// Define the number of joystick events the LCD task can fall behind by before events are dropped.
+#define JOY_QUEUE_LENGTH 4
+
 // Define the pins for the second and third sensors.
 #define SENSOR2_PIN 3
 #define SENSOR3_PIN 4
@@ -56,27 +59,68 @@
 #define BIT6 1<<6
 #define BIT7 1<<7
 
-// Define the segments for the 7-segment display.
-#define S0 0b1110 << 4
-#define S1 0b1101 << 4
-#define S2 0b1011 << 4
-#define S3 0b0111 << 4
-
 // Define the OffBoard LED
 #define OFFBOARD_LED_PIN 37
 
-// Define the lookup table for the 7-segment display. This table maps each digit to its representation on the display.
-byte seven_seg_digits[10][7] = { { 1,1,1,1,1,1,0 },  // = 0
-                                 { 0,1,1,0,0,0,0 },  // = 1
-                                 { 1,1,0,1,1,0,1 },  // = 2
-                                 { 1,1,1,1,0,0,1 },  // = 3
-                                 { 0,1,1,0,0,1,1 },  // = 4
-                                 { 1,0,1,1,0,1,1 },  // = 5
-                                 { 1,0,1,1,1,1,1 },  // = 6
-                                 { 1,1,1,0,0,0,0 },  // = 7
-                                 { 1,1,1,1,1,1,1 },  // = 8
-                                 { 1,1,1,0,0,1,1 }   // = 9
-                               };
+// Define the periods of the periodic jobs in milliseconds. A tick is about 16 ms, so shorter
+// periods round down to zero ticks, and 100 ms is six ticks. The countdown counts its tenths of a
+// second from millis() rather than from its releases, so it keeps time however long they are.
+#define COUNTDOWN_PERIOD_MS 100
+#define ENCODER_PERIOD_MS 20
+#define LED_FLASH_PERIOD_MS 100
+#define REPORT_PERIOD_MS 5000
+
+// Define the number of periodic tasks, and of all the tasks in the response time analysis in the
+// report job, which also covers TaskLCD.
+#define NPERIODIC 6
+#define NRTA (NPERIODIC + 1)
+
+// Define how many extra 100 ms releases the buzzer stays on for once triggered.
+#define BUZZER_HOLD_RELEASES 2
+
+// Define the CPU time the countdown job may use per period, in microseconds. The display refreshes
+// itself from the Timer5 interrupt, so the job runs for about 20 us in the simulator, which charges
+// nothing for arithmetic. On the board its 32 bit divisions take about 40 us each, and interrupts
+// that land in the job are charged to it, so allow four times a generous 250 us.
+#define COUNTDOWN_BUDGET_US 1000UL
+
+// Define the largest countdown the four digits can show, 9:59.9, in tenths of a second.
+#define COUNTDOWN_MAX 5999UL
+
+// Define a compiler barrier so scoreboard copies are not reordered around the sequence number reads.
+#define SCOREBOARD_BARRIER() __asm__ __volatile__ ("" ::: "memory")
+
+/**
+ * @brief Struct to hold the scoreboard state shared between tasks.
+ * 
+ * Only accessed through scoreboardBeginWrite()/scoreboardEndWrite() and scoreboardSnapshot().
+ */
+typedef struct {
+  /// Name of the first team
+  char teamAName[7];
+  /// Name of the second team
+  char teamBName[7];
+  /// Score of the first team
+  int teamAScore;
+  /// Score of the second team
+  int teamBScore;
+  /// Current quarter of the game
+  int quarter;
+  /// Countdown in tenths of a second
+  unsigned long count;
+} scoreboard_t;
+
+/**
+ * @brief Struct published on the joystick topic whenever the joystick is not stationary.
+ */
+typedef struct {
+  /// X position of the joystick, 0 to 1023
+  int x;
+  /// Y position of the joystick, 0 to 1023
+  int y;
+  /// Whether the joystick button is pressed
+  bool pressed;
+} joystick_event_t;
 
 /**
  * @brief Sends a command to the LCD.
@@ -104,57 +148,73 @@ void lcdData(uint8_t data);
 void lcdInit();
 
 /**
- * @brief Task to read joystick data.
+ * @brief Task to control the LCD.
  * 
  * @param pvParameters A pointer to task parameters.
  * 
  * @return void.
  */
-void TaskJoyStick(void * pvParameters);
+void TaskLCD(void * pvParameters);
+
+
 
 /**
- * @brief Task to control the LCD.
+ * @brief Clears the LCD.
  * 
- * @param pvParameters A pointer to task parameters.
+ * @return void.
+ */
+void lcdClear();
+
+/**
+ * @brief Sends a command to the LCD.
+ * 
+ * @param cmd The command to send.
  * 
  * @return void.
  */
-void TaskLCD(void * pvParameters);
+void lcdSetCursor(uint8_t col, uint8_t row);
 
 /**
- * @brief Task to handle countdown operation.
+ * @brief Prints a string to the LCD.
  * 
- * @param pvParameters A pointer to task parameters.
+ * @param str The string to print.
  * 
  * @return void.
  */
-void TaskCountdown(void * pvParameters);
+void lcdPrint(const char* str);
 
+/**
+ * @brief Starts an update of the shared scoreboard.
+ * 
+ * @return void.
+ */
+void scoreboardBeginWrite();
 
 /**
- * @brief Clears the LCD.
+ * @brief Finishes an update of the shared scoreboard.
  * 
  * @return void.
  */
-void lcdClear();
+void scoreboardEndWrite();
 
 /**
- * @brief Sends a command to the LCD.
+ * @brief Copies a consistent snapshot of the shared scoreboard.
  * 
- * @param cmd The command to send.
+ * @param snap The scoreboard to copy into.
  * 
  * @return void.
  */
-void lcdSetCursor(uint8_t col, uint8_t row);
+void scoreboardSnapshot(scoreboard_t *snap);
 
 /**
- * @brief Prints a string to the LCD.
+ * @brief Formats a scoreboard snapshot into the LCD message layout.
  * 
- * @param str The string to print.
+ * @param buf The buffer to format into.
+ * @param snap The scoreboard snapshot to format.
  * 
  * @return void.
  */
-void lcdPrint(const char* str);
+void formatScoreboard(char *buf, const scoreboard_t *snap);
 
 /**
  * @brief Initializes the joystick, sensors, buttons, buzzer, LED, rotary encoder, 7-segment display, and LCD screen.
@@ -164,13 +224,13 @@ void lcdPrint(const char* str);
 void setup();
 
 /**
- * @brief Task function that reads input from the joystick and updates the selected option or letter.
+ * @brief Periodic job that reads input from the joystick and publishes it on the joystick topic.
  * 
- * @param pvParameters void pointer to task parameters.
+ * @param pvParameters void pointer to job parameters.
  * 
  * @return void.
  */
-void TaskJoyStick(void *pvParameters);
+void JobJoyStick(void *pvParameters);
 
 /**
  * @brief Task function that displays information on an LCD screen and handles user input from a joystick.
@@ -182,30 +242,76 @@ void TaskJoyStick(void *pvParameters);
 void TaskLCD(void *pvParameters);
 
 /**
- * @brief Task function that counts down from a specified time and displays the remaining time on a 7-segment display.
+ * @brief Periodic job that counts down a tenth of a second and displays the remaining time on a 7-segment display.
  * 
- * @param pvParameters void pointer to task parameters.
+ * @param pvParameters void pointer to job parameters.
  * 
  * @return void.
  */
-void TaskCountdown(void *pvParameters);
+void JobCountdown(void *pvParameters);
 
 /**
- * @brief Task function that controls a buzzer and LED based on the state of a sensor.
+ * @brief Periodic job that controls a buzzer and LED based on the state of a sensor.
  * 
- * @param pvParameters void pointer to task parameters.
+ * @param pvParameters void pointer to job parameters.
  * 
  * @return void.
  */
-void TaskBuzzerAndLED(void *pvParameters);
+void JobBuzzerAndLED(void *pvParameters);
 
 /**
- * @brief Task function that reads input from a rotary encoder and updates the selected option or letter.
+ * @brief Periodic job that reads input from a rotary encoder and updates the countdown.
  * 
- * @param pvParameters void pointer to task parameters.
+ * @param pvParameters void pointer to job parameters.
+ * 
+ * @return void.
+ */
+void JobRotaryEncoder(void *pvParameters);
+
+/**
+ * @brief Periodic job that flashes the off-board LED.
+ * 
+ * @param pvParameters void pointer to job parameters.
+ * 
+ * @return void.
+ */
+void JobLEDFlash(void *pvParameters);
+
+/**
+ * @brief Periodic job that prints the timing statistics of every periodic task.
+ * 
+ * @param pvParameters void pointer to job parameters.
+ * 
+ * @return void.
+ */
+void JobReport(void *pvParameters);
+
+/**
+ * @brief Prints the RAM used by the kernel, by object type and by owning task.
+ * 
+ * @return void.
+ */
+void printRamReport();
+
+/**
+ * @brief Reports a task that is running low on stack.
+ * 
+ * @param usage the stack usage of the task.
+ * 
+ * @return void.
+ */
+void stackLow(const struct StackUsage *usage);
+
+/**
+ * @brief Converts the input time values into an array of digits.
+ * 
+ * @param digits Pointer to an integer array to store the separated digits.
+ * @param minutes The number of minutes in the input time.
+ * @param seconds The number of seconds in the input time.
+ * @param tenths The number of tenths of a second in the input time.
  * 
  * @return void.
  */
-void TaskRotaryEncoder(void *pvParameters);
+void convert(byte * digits, int minutes, int seconds, int tenths);
 
 
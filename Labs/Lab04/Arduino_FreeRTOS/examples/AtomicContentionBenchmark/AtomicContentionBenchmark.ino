@@ -0,0 +1,143 @@
+/**
+ * @file AtomicContentionBenchmark.ino
+ * @brief Times shared counter updates from a task while a 20 kHz interrupt updates them too.
+ *
+ * Timer 1 interrupts every 50 us and increments every counter. Meanwhile the benchmark task
+ * increments one counter NITERATIONS times per row, and each row prints:
+ *  - ns_per_op: the average cost of one increment in the task, interrupts included.
+ *  - lost: increments that went missing, found by comparing the counter with the number of
+ *    task and interrupt increments that should have reached it.
+ *
+ * The plain row uses ++ and loses updates whenever the interrupt lands between its load and
+ * store. The critical row wraps ++ in taskENTER_CRITICAL(). The atomic rows use atomic.h,
+ * which masks interrupts in line, and whose byte version avoids the 32 bit arithmetic. The
+ * load8 row reads a byte with Atomic_Load_u8(), which needs no masking at all.
+ */
+#include <Arduino_FreeRTOS.h>
+#include <task.h>
+#include <atomic.h>
+
+#define NITERATIONS 20000L
+#define TIMER_TOP 99 // 16 MHz / 8 / (99 + 1) = 20 kHz
+
+volatile uint32_t plainCount;
+volatile uint32_t criticalCount;
+volatile uint32_t atomicCount;
+volatile uint8_t atomicByte;
+volatile uint32_t isrTicks;
+
+void setup() {
+  Serial.begin(19200);
+
+  // Timer 1 in CTC mode, prescaler 8
+  TCCR1A = 0;
+  TCCR1B = _BV(WGM12) | _BV(CS11);
+  OCR1A = TIMER_TOP;
+  TIMSK1 = _BV(OCIE1A);
+
+  xTaskCreate(TaskBenchmark, "Bench", 192, NULL, 1, NULL);
+}
+
+void loop()
+{
+  // Empty. Things are done in Tasks.
+}
+
+// interrupts do not nest on AVR, so plain increments are safe in here
+ISR(TIMER1_COMPA_vect) {
+  plainCount++;
+  criticalCount++;
+  atomicCount++;
+  atomicByte++;
+  isrTicks++;
+}
+
+/*--------------------------------------------------*/
+/*------------------- Benchmarks -------------------*/
+/*--------------------------------------------------*/
+
+uint32_t readTicks() {
+  uint32_t ticks;
+  taskENTER_CRITICAL();
+  ticks = isrTicks;
+  taskEXIT_CRITICAL();
+  return ticks;
+}
+
+void printRow(const __FlashStringHelper * name, unsigned long elapsed, long lost) {
+  Serial.print(name);
+  Serial.print('\t');
+  Serial.print(elapsed * 1000UL / NITERATIONS);
+  Serial.print('\t');
+  Serial.println(lost);
+}
+
+// expected is the value the counter should have if no update was lost
+uint32_t expectedCount(uint32_t start, uint32_t ticksBefore) {
+  return start + NITERATIONS + (readTicks() - ticksBefore);
+}
+
+void TaskBenchmark(void * pvParameters) {
+  unsigned long begin;
+  uint32_t ticks, start, expected;
+  uint8_t startByte, sum = 0;
+
+  Serial.println(F("update\tns_per_op\tlost"));
+
+  ticks = readTicks();
+  start = Atomic_Add_u32(&plainCount, 0);
+  begin = micros();
+  for (long i = 0; i < NITERATIONS; i++) {
+    plainCount++;
+  }
+  begin = micros() - begin;
+  expected = expectedCount(start, ticks);
+  printRow(F("plain"), begin, (long) (expected - Atomic_Add_u32(&plainCount, 0)));
+
+  ticks = readTicks();
+  start = Atomic_Add_u32(&criticalCount, 0);
+  begin = micros();
+  for (long i = 0; i < NITERATIONS; i++) {
+    taskENTER_CRITICAL();
+    criticalCount++;
+    taskEXIT_CRITICAL();
+  }
+  begin = micros() - begin;
+  expected = expectedCount(start, ticks);
+  printRow(F("critical"), begin, (long) (expected - Atomic_Add_u32(&criticalCount, 0)));
+
+  ticks = readTicks();
+  start = Atomic_Add_u32(&atomicCount, 0);
+  begin = micros();
+  for (long i = 0; i < NITERATIONS; i++) {
+    Atomic_Increment_u32(&atomicCount);
+  }
+  begin = micros() - begin;
+  expected = expectedCount(start, ticks);
+  printRow(F("atomic32"), begin, (long) (expected - Atomic_Add_u32(&atomicCount, 0)));
+
+  // the byte counter wraps, so compare modulo 256
+  ticks = readTicks();
+  startByte = Atomic_Load_u8(&atomicByte);
+  begin = micros();
+  for (long i = 0; i < NITERATIONS; i++) {
+    Atomic_Increment_u8(&atomicByte);
+  }
+  begin = micros() - begin;
+  expected = expectedCount(startByte, ticks);
+  printRow(F("atomic8"), begin, (uint8_t) ((uint8_t) expected - Atomic_Load_u8(&atomicByte)));
+
+  begin = micros();
+  for (long i = 0; i < NITERATIONS; i++) {
+    sum += Atomic_Load_u8(&atomicByte);
+  }
+  begin = micros() - begin;
+  printRow(F("load8"), begin, 0);
+
+  Serial.print(F("interrupts: "));
+  Serial.print(readTicks());
+  Serial.print(F(", checksum: "));
+  Serial.println(sum);
+
+  vTaskDelete(NULL);
+}
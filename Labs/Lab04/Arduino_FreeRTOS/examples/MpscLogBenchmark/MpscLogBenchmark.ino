@@ -0,0 +1,133 @@
+/**
+ * @file MpscLogBenchmark.ino
+ * @brief Shares one log buffer between several tasks, with and without a mutex.
+ *
+ * First the cost of posting one 16 byte log line is measured, in microseconds, for a message
+ * buffer behind a mutex - what several writers need with stream_buffer.c - and for an MPSC
+ * buffer, which writers share without one.
+ *
+ * Then three writer tasks log into the MPSC buffer while a single reader drains it to the
+ * serial port. The writers yield to each other half way through every line, so several lines
+ * are always being written at once, yet every line comes out whole and in reservation order.
+ * The reader finishes by printing how many lines it got and how many were dropped because
+ * the buffer was full.
+ */
+#include <Arduino_FreeRTOS.h>
+#include <message_buffer.h>
+#include <semphr.h>
+#include <task.h>
+#include <mpsc_buffer.h>
+
+#define NMESSAGES 256
+#define LINE_LENGTH 16
+#define BUFFER_BYTES 128
+#define NWRITERS 3
+#define LINES_PER_WRITER 20
+
+mpscbufferDEFINE(logBuffer, BUFFER_BYTES);
+
+MessageBufferHandle_t messageBuffer;
+SemaphoreHandle_t messageMutex;
+
+char line[LINE_LENGTH] = "line 0123456789";
+
+void setup() {
+  Serial.begin(19200);
+
+  messageBuffer = xMessageBufferCreate(BUFFER_BYTES);
+  messageMutex = xSemaphoreCreateMutex();
+
+  xTaskCreate(TaskBenchmark, "Bench", 192, NULL, 1, NULL);
+}
+
+void loop()
+{
+  // Empty. Things are done in Tasks.
+}
+
+/*--------------------------------------------------*/
+/*------------------- Benchmarks -------------------*/
+/*--------------------------------------------------*/
+
+unsigned long timeMutexSend() {
+  char out[LINE_LENGTH];
+  unsigned long start = micros();
+  for (int i = 0; i < NMESSAGES; i++) {
+    xSemaphoreTake(messageMutex, portMAX_DELAY);
+    xMessageBufferSend(messageBuffer, line, LINE_LENGTH, 0);
+    xSemaphoreGive(messageMutex);
+    // drain as we go so the buffer never fills, and charge both rows the same for it
+    xMessageBufferReceive(messageBuffer, out, LINE_LENGTH, 0);
+  }
+  return (micros() - start) / NMESSAGES;
+}
+
+unsigned long timeMpscSend() {
+  char out[LINE_LENGTH];
+  unsigned long start = micros();
+  for (int i = 0; i < NMESSAGES; i++) {
+    xMpscBufferSend(&logBuffer, line, LINE_LENGTH);
+    xMpscBufferReceive(&logBuffer, out, LINE_LENGTH, 0);
+  }
+  return (micros() - start) / NMESSAGES;
+}
+
+/*--------------------------------------------------*/
+/*--------------------- Tasks ----------------------*/
+/*--------------------------------------------------*/
+
+// formats each line straight into the buffer, yielding to the other writers in the middle
+// of it - lines they reserve meanwhile are held back until this one is committed
+void TaskWriter(void * pvParameters) {
+  char id = (char) (uintptr_t) pvParameters;
+
+  for (int i = 0; i < LINES_PER_WRITER; i++) {
+    char * space = (char *) pvMpscBufferReserve(&logBuffer, 8);
+    if (space != NULL) {
+      space[0] = 'w';
+      space[1] = id;
+      space[2] = ' ';
+      taskYIELD();
+      space[3] = '0' + i / 10;
+      space[4] = '0' + i % 10;
+      space[5] = '\r';
+      space[6] = '\n';
+      space[7] = '\0';
+      vMpscBufferCommit(&logBuffer, space);
+    }
+    vTaskDelay(1);
+  }
+  vTaskDelete(NULL);
+}
+
+void TaskReader(void * pvParameters) {
+  char text[LINE_LENGTH];
+  unsigned int lines = 0;
+
+  while (xMpscBufferReceive(&logBuffer, text, sizeof(text), pdMS_TO_TICKS(500)) > 0) {
+    Serial.print(text);
+    lines++;
+  }
+
+  Serial.print(F("lines: "));
+  Serial.print(lines);
+  Serial.print(F(", dropped: "));
+  Serial.println(usMpscBufferGetDropped(&logBuffer));
+
+  vTaskDelete(NULL);
+}
+
+void TaskBenchmark(void * pvParameters) {
+  Serial.println(F("writer\tsend_us"));
+  Serial.print(F("mutex\t"));
+  Serial.println(timeMutexSend());
+  Serial.print(F("mpsc\t"));
+  Serial.println(timeMpscSend());
+
+  xTaskCreate(TaskReader, "Reader", 128, NULL, 1, NULL);
+  for (int i = 0; i < NWRITERS; i++) {
+    xTaskCreate(TaskWriter, "Writer", 96, (void *) (uintptr_t) ('A' + i), 2, NULL);
+  }
+
+  vTaskDelete(NULL);
+}
@@ -0,0 +1,119 @@
+/**
+ * @file ObjectPoolBenchmark.ino
+ * @brief Compares spawning short-lived workers with xTaskCreate() against a task pool.
+ *
+ * Each round runs NSPAWN tiny jobs one after another and prints the average cost of one
+ * spawn and teardown in microseconds. With xTaskCreate() every job gets a freshly allocated
+ * and painted TCB and stack, deletes itself, and the memory is freed later by the idle task.
+ * With a task pool the same worker is woken again and again.
+ *
+ * The benchmark runs at the idle priority and yields after each job, so the idle task gets
+ * the chance to free deleted workers and the heap never runs dry. Both variants pay for the
+ * yield. The queue rows compare xQueueCreate()/vQueueDelete() with a queue pool.
+ */
+#include <Arduino_FreeRTOS.h>
+#include <queue.h>
+#include <task.h>
+#include <object_pool.h>
+
+#define NSPAWN 64
+#define WORKER_STACK 128
+#define WORKER_PRIORITY 1
+#define QUEUE_LENGTH 4
+
+taskpoolDEFINE(workerPool, 1, WORKER_STACK);
+queuepoolDEFINE(queuePool, 1, QUEUE_LENGTH, sizeof(long));
+
+volatile unsigned int jobsRun;
+
+void setup() {
+  Serial.begin(19200);
+
+  xTaskCreate(TaskBenchmark, "Bench", 192, NULL, tskIDLE_PRIORITY, NULL);
+}
+
+void loop()
+{
+  // Empty. Things are done in Tasks.
+}
+
+/*--------------------------------------------------*/
+/*---------------------- Jobs ----------------------*/
+/*--------------------------------------------------*/
+
+void Job(void * pvParameters) {
+  jobsRun++;
+}
+
+// the same job as a conventional task, which has to delete itself
+void TaskJob(void * pvParameters) {
+  Job(pvParameters);
+  vTaskDelete(NULL);
+}
+
+/*--------------------------------------------------*/
+/*------------------- Benchmarks -------------------*/
+/*--------------------------------------------------*/
+
+unsigned long timeTaskCreate() {
+  unsigned long start = micros();
+  for (int i = 0; i < NSPAWN; i++) {
+    xTaskCreate(TaskJob, "Job", WORKER_STACK, NULL, WORKER_PRIORITY, NULL);
+    taskYIELD();
+  }
+  return (micros() - start) / NSPAWN;
+}
+
+unsigned long timeTaskPool() {
+  unsigned long start = micros();
+  for (int i = 0; i < NSPAWN; i++) {
+    xTaskPoolSpawn(&workerPool, Job, NULL, WORKER_PRIORITY, NULL);
+    taskYIELD();
+  }
+  return (micros() - start) / NSPAWN;
+}
+
+unsigned long timeQueueCreate() {
+  unsigned long start = micros();
+  for (int i = 0; i < NSPAWN; i++) {
+    vQueueDelete(xQueueCreate(QUEUE_LENGTH, sizeof(long)));
+  }
+  return (micros() - start) / NSPAWN;
+}
+
+unsigned long timeQueuePool() {
+  unsigned long start = micros();
+  for (int i = 0; i < NSPAWN; i++) {
+    vQueuePoolRelease(xQueuePoolAcquire(&queuePool));
+  }
+  return (micros() - start) / NSPAWN;
+}
+
+void TaskBenchmark(void * pvParameters) {
+  ObjectPoolStats_t stats;
+
+  // the first spawn creates the pooled worker, keep it out of the timings
+  xTaskPoolSpawn(&workerPool, Job, NULL, WORKER_PRIORITY, NULL);
+  vQueuePoolRelease(xQueuePoolAcquire(&queuePool));
+  taskYIELD();
+
+  Serial.println(F("object\tcreate_us\tpool_us"));
+
+  Serial.print(F("task\t"));
+  Serial.print(timeTaskCreate());
+  Serial.print('\t');
+  Serial.println(timeTaskPool());
+
+  Serial.print(F("queue\t"));
+  Serial.print(timeQueueCreate());
+  Serial.print('\t');
+  Serial.println(timeQueuePool());
+
+  vTaskPoolGetStats(&workerPool, &stats);
+  Serial.print(F("jobs run: "));
+  Serial.print(jobsRun);
+  Serial.print(F(", pool failures: "));
+  Serial.println(stats.uxFailures);
+
+  vTaskDelete(NULL);
+}
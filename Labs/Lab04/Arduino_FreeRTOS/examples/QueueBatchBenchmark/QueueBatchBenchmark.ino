@@ -0,0 +1,132 @@
+/**
+ * @file QueueBatchBenchmark.ino
+ * @brief Compares moving queue items one at a time against uxQueueSendMultiple()/uxQueueReceiveMultiple().
+ *
+ * Every row moves NITEMS two byte items through a queue and prints the average cost of one
+ * item in microseconds, once with xQueueSend()/xQueueReceive() per item and once with the
+ * batch calls for a few batch sizes.
+ *
+ * The "local" rows fill and drain the queue from the benchmark task itself, so they only
+ * measure the copy and the critical sections. In the "handoff" rows a higher priority
+ * consumer is blocked on the queue, as it would be behind a sensor or a serial port. Each
+ * single send then wakes the consumer and switches to it, while a batch send wakes it once
+ * per batch - this is where batching pays off most.
+ */
+#include <Arduino_FreeRTOS.h>
+#include <queue.h>
+#include <task.h>
+
+#define NITEMS 256
+#define QUEUE_LENGTH 16
+#define BENCH_PRIORITY 1
+#define CONSUMER_PRIORITY 2
+
+const UBaseType_t batchSizes[] = { 1, 4, 16 };
+
+QueueHandle_t localQueue;
+QueueHandle_t handoffQueue;
+volatile unsigned int itemsConsumed;
+
+void setup() {
+  Serial.begin(19200);
+
+  localQueue = xQueueCreate(QUEUE_LENGTH, sizeof(uint16_t));
+  handoffQueue = xQueueCreate(QUEUE_LENGTH, sizeof(uint16_t));
+
+  xTaskCreate(TaskConsumer, "Consumer", 128, NULL, CONSUMER_PRIORITY, NULL);
+  xTaskCreate(TaskBenchmark, "Bench", 192, NULL, BENCH_PRIORITY, NULL);
+}
+
+void loop()
+{
+  // Empty. Things are done in Tasks.
+}
+
+/*--------------------------------------------------*/
+/*--------------------- Tasks ----------------------*/
+/*--------------------------------------------------*/
+
+// drains the handoff queue, taking whatever has piled up each time it wakes
+void TaskConsumer(void * pvParameters) {
+  uint16_t items[QUEUE_LENGTH];
+
+  for (;;) {
+    itemsConsumed += uxQueueReceiveMultiple(handoffQueue, items, QUEUE_LENGTH, portMAX_DELAY);
+  }
+}
+
+/*--------------------------------------------------*/
+/*------------------- Benchmarks -------------------*/
+/*--------------------------------------------------*/
+
+unsigned long timeLocalSingle() {
+  uint16_t item = 0;
+  unsigned long start = micros();
+  for (int i = 0; i < NITEMS; i += QUEUE_LENGTH) {
+    for (int j = 0; j < QUEUE_LENGTH; j++) {
+      xQueueSend(localQueue, &item, 0);
+    }
+    for (int j = 0; j < QUEUE_LENGTH; j++) {
+      xQueueReceive(localQueue, &item, 0);
+    }
+  }
+  return (micros() - start) / NITEMS;
+}
+
+unsigned long timeLocalBatch(UBaseType_t batch) {
+  uint16_t items[QUEUE_LENGTH] = { 0 };
+  unsigned long start = micros();
+  for (int i = 0; i < NITEMS; i += QUEUE_LENGTH) {
+    for (UBaseType_t j = 0; j < QUEUE_LENGTH; j += batch) {
+      uxQueueSendMultiple(localQueue, items, batch, 0);
+    }
+    for (UBaseType_t j = 0; j < QUEUE_LENGTH; j += batch) {
+      uxQueueReceiveMultiple(localQueue, items, batch, 0);
+    }
+  }
+  return (micros() - start) / NITEMS;
+}
+
+unsigned long timeHandoffSingle() {
+  uint16_t item = 0;
+  itemsConsumed = 0;
+  unsigned long start = micros();
+  for (int i = 0; i < NITEMS; i++) {
+    xQueueSend(handoffQueue, &item, portMAX_DELAY);
+  }
+  return (micros() - start) / NITEMS;
+}
+
+unsigned long timeHandoffBatch(UBaseType_t batch) {
+  uint16_t items[QUEUE_LENGTH] = { 0 };
+  itemsConsumed = 0;
+  unsigned long start = micros();
+  for (int i = 0; i < NITEMS; i += batch) {
+    // the consumer empties the queue each time it runs, so a full batch always fits
+    uxQueueSendMultiple(handoffQueue, items, batch, portMAX_DELAY);
+  }
+  return (micros() - start) / NITEMS;
+}
+
+void printRow(const __FlashStringHelper * name, unsigned long single, unsigned long (*batchFn)(UBaseType_t)) {
+  Serial.print(name);
+  Serial.print('\t');
+  Serial.print(single);
+  for (unsigned int i = 0; i < sizeof(batchSizes) / sizeof(batchSizes[0]); i++) {
+    Serial.print('\t');
+    Serial.print(batchFn(batchSizes[i]));
+  }
+  Serial.println();
+}
+
+void TaskBenchmark(void * pvParameters) {
+  Serial.println(F("case\tsingle_us\tbatch1_us\tbatch4_us\tbatch16_us"));
+
+  printRow(F("local"), timeLocalSingle(), timeLocalBatch);
+  printRow(F("handoff"), timeHandoffSingle(), timeHandoffBatch);
+
+  Serial.print(F("items consumed in last run: "));
+  Serial.println(itemsConsumed);
+
+  vTaskDelete(NULL);
+}
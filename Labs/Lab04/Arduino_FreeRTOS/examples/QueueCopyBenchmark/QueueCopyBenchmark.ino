@@ -0,0 +1,106 @@
+/**
+ * @file QueueCopyBenchmark.ino
+ * @brief Measures the per item copy classes queues select from their item size.
+ *
+ * For items of 1, 2, 4 and 8 bytes each row prints, in nanoseconds per item:
+ *  - memcpy_ns: one copy in and one copy out with memcpy() and a run time size, which is
+ *    what every send and receive used to do.
+ *  - class_ns: the same with queueCOPY_ITEM(), which is what they do now.
+ *  - queue_ns: a complete xQueueSend() and xQueueReceive() pair, for scale.
+ *
+ * 8 byte items still go through memcpy(), so that row shows the cost of picking the class.
+ * The same comparison can be run on the host with extras/queue_copy.
+ */
+#include <Arduino_FreeRTOS.h>
+#include <queue.h>
+#include <task.h>
+#include <queue_copy.h>
+
+#define NITEMS 1024
+#define RING_LENGTH 16
+#define MAX_ITEM 8
+
+uint8_t ring[RING_LENGTH * MAX_ITEM];
+uint8_t items[RING_LENGTH * MAX_ITEM];
+
+// read through a volatile so the compiler can not specialise memcpy() for the size
+volatile size_t runtimeSize;
+
+void setup() {
+  Serial.begin(19200);
+
+  xTaskCreate(TaskBenchmark, "Bench", 192, NULL, tskIDLE_PRIORITY, NULL);
+}
+
+void loop()
+{
+  // Empty. Things are done in Tasks.
+}
+
+/*--------------------------------------------------*/
+/*------------------- Benchmarks -------------------*/
+/*--------------------------------------------------*/
+
+unsigned long timeMemcpy(size_t itemSize) {
+  runtimeSize = itemSize;
+  unsigned long start = micros();
+  for (int i = 0; i < NITEMS; i += RING_LENGTH) {
+    size_t size = runtimeSize;
+    for (int j = 0; j < RING_LENGTH; j++) {
+      memcpy(&ring[j * size], &items[j * size], size);
+    }
+    for (int j = 0; j < RING_LENGTH; j++) {
+      memcpy(&items[j * size], &ring[j * size], size);
+    }
+  }
+  return (micros() - start) * 1000UL / NITEMS;
+}
+
+unsigned long timeClass(size_t itemSize) {
+  runtimeSize = itemSize;
+  unsigned long start = micros();
+  for (int i = 0; i < NITEMS; i += RING_LENGTH) {
+    size_t size = runtimeSize;
+    uint8_t copyClass = queueCOPY_SELECT_CLASS(size);
+    for (int j = 0; j < RING_LENGTH; j++) {
+      queueCOPY_ITEM(copyClass, &ring[j * size], &items[j * size], size);
+    }
+    for (int j = 0; j < RING_LENGTH; j++) {
+      queueCOPY_ITEM(copyClass, &items[j * size], &ring[j * size], size);
+    }
+  }
+  return (micros() - start) * 1000UL / NITEMS;
+}
+
+unsigned long timeQueue(size_t itemSize) {
+  QueueHandle_t queue = xQueueCreate(1, itemSize);
+  if (queue == NULL) {
+    return 0;
+  }
+  unsigned long start = micros();
+  for (int i = 0; i < NITEMS; i++) {
+    xQueueSend(queue, items, 0);
+    xQueueReceive(queue, ring, 0);
+  }
+  unsigned long elapsed = micros() - start;
+  vQueueDelete(queue);
+  return elapsed * 1000UL / NITEMS;
+}
+
+void TaskBenchmark(void * pvParameters) {
+  const size_t sizes[] = { 1, 2, 4, 8 };
+
+  Serial.println(F("bytes\tmemcpy_ns\tclass_ns\tqueue_ns"));
+
+  for (unsigned int i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+    Serial.print(sizes[i]);
+    Serial.print('\t');
+    Serial.print(timeMemcpy(sizes[i]));
+    Serial.print('\t');
+    Serial.print(timeClass(sizes[i]));
+    Serial.print('\t');
+    Serial.println(timeQueue(sizes[i]));
+  }
+
+  vTaskDelete(NULL);
+}
@@ -0,0 +1,82 @@
+/**
+ * @file TopicBusBenchmark.ino
+ * @brief Measures the cost of uxTopicPublish() against the number of subscribers.
+ *
+ * For each subscriber count the benchmark publishes NPUBLISH messages and prints the
+ * average time per publish in microseconds, once with queue subscribers and once with
+ * latest-value subscribers. The queues are drained between rounds so no message is dropped.
+ */
+#include <Arduino_FreeRTOS.h>
+#include <queue.h>
+#include <task.h>
+#include <topic_bus.h>
+
+#define MAX_SUBSCRIBERS 8
+#define NPUBLISH 32
+#define QUEUE_LENGTH NPUBLISH
+
+topicDEFINE(xQueueTopic, long);
+topicDEFINE(xLatestTopic, long);
+
+TopicSubscriber_t queueSubscribers[MAX_SUBSCRIBERS];
+TopicSubscriber_t latestSubscribers[MAX_SUBSCRIBERS];
+QueueHandle_t queues[MAX_SUBSCRIBERS];
+long slots[MAX_SUBSCRIBERS];
+
+void setup() {
+  Serial.begin(19200);
+
+  for (int i = 0; i < MAX_SUBSCRIBERS; i++) {
+    queues[i] = xQueueCreate(QUEUE_LENGTH, sizeof(long));
+  }
+
+  xTaskCreate(TaskBenchmark, "Bench", 192, NULL, 1, NULL);
+}
+
+void loop()
+{
+  // Empty. Things are done in Tasks.
+}
+
+/**
+ * @brief Publishes NPUBLISH messages on a topic and returns the average cost of one publish.
+ *
+ * @param topic The topic to publish on.
+ * @return The average time per publish in microseconds.
+ */
+unsigned long timePublish(Topic_t * topic) {
+  long message = 0;
+  unsigned long start = micros();
+  for (int i = 0; i < NPUBLISH; i++) {
+    message++;
+    uxTopicPublish(topic, &message);
+  }
+  return (micros() - start) / NPUBLISH;
+}
+
+void TaskBenchmark(void * pvParameters) {
+  Serial.println(F("subscribers\tqueue_us\tlatest_us"));
+
+  for (int n = 0; n <= MAX_SUBSCRIBERS; n++) {
+    // each round adds one more subscriber of each kind
+    if (n > 0) {
+      xTopicSubscribeQueue(&xQueueTopic, &queueSubscribers[n - 1], queues[n - 1]);
+      xTopicSubscribeLatest(&xLatestTopic, &latestSubscribers[n - 1], &slots[n - 1], NULL);
+    }
+
+    unsigned long queueCost = timePublish(&xQueueTopic);
+    unsigned long latestCost = timePublish(&xLatestTopic);
+
+    for (int i = 0; i < n; i++) {
+      xQueueReset(queues[i]);
+    }
+
+    Serial.print(n);
+    Serial.print('\t');
+    Serial.print(queueCost);
+    Serial.print('\t');
+    Serial.println(latestCost);
+  }
+
+  vTaskDelete(NULL);
+}
@@ -0,0 +1,100 @@
+/**
+ * @file queue_copy_bench.c
+ * @brief Host benchmark for the queue item copy classes in src/queue_copy.h.
+ *
+ * Pushes items through a 16 slot ring the way queue.c does - one copy in, one copy out - and
+ * prints the average cost of one send plus receive in nanoseconds, once with memcpy() and a
+ * run time item size as the kernel used to, and once with queueCOPY_ITEM(). The 8 byte row
+ * falls back to memcpy() in both columns and shows the cost of the class dispatch.
+ *
+ * Usage: queue_copy_bench [rounds]
+ *
+ * The AVR side of the comparison is examples/QueueCopyBenchmark.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "queue_copy.h"
+
+#define RING_LENGTH 16
+#define MAX_ITEM 8
+#define DEFAULT_ROUNDS 2000000L
+
+static uint8_t ring[RING_LENGTH * MAX_ITEM];
+static uint8_t items[RING_LENGTH * MAX_ITEM];
+
+/**
+ * @brief Returns a monotonic time stamp in nanoseconds.
+ */
+static double nowNs(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double) ts.tv_sec * 1e9 + (double) ts.tv_nsec;
+}
+
+/**
+ * @brief Fills and drains the ring once with memcpy().
+ *
+ * Kept out of line so the item size stays a run time value, as it is in the kernel.
+ */
+__attribute__((noinline)) static void roundMemcpy(size_t itemSize) {
+  for (int i = 0; i < RING_LENGTH; i++) {
+    memcpy(&ring[i * itemSize], &items[i * itemSize], itemSize);
+  }
+  for (int i = 0; i < RING_LENGTH; i++) {
+    memcpy(&items[i * itemSize], &ring[i * itemSize], itemSize);
+  }
+}
+
+/**
+ * @brief Fills and drains the ring once with queueCOPY_ITEM().
+ */
+__attribute__((noinline)) static void roundClass(size_t itemSize, uint8_t copyClass) {
+  for (int i = 0; i < RING_LENGTH; i++) {
+    queueCOPY_ITEM(copyClass, &ring[i * itemSize], &items[i * itemSize], itemSize);
+  }
+  for (int i = 0; i < RING_LENGTH; i++) {
+    queueCOPY_ITEM(copyClass, &items[i * itemSize], &ring[i * itemSize], itemSize);
+  }
+}
+
+int main(int argc, char **argv) {
+  static const size_t sizes[] = { 1, 2, 4, 8 };
+  long rounds = DEFAULT_ROUNDS;
+
+  if (argc > 1) {
+    rounds = strtol(argv[1], NULL, 10);
+    if (rounds <= 0) {
+      fprintf(stderr, "usage: %s [rounds]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  for (size_t i = 0; i < sizeof(items); i++) {
+    items[i] = (uint8_t) i;
+  }
+
+  printf("%-6s %12s %12s\n", "bytes", "memcpy_ns", "class_ns");
+  for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+    size_t itemSize = sizes[s];
+    uint8_t copyClass = queueCOPY_SELECT_CLASS(itemSize);
+    double perItem = (double) rounds * RING_LENGTH;
+
+    double start = nowNs();
+    for (long r = 0; r < rounds; r++) {
+      roundMemcpy(itemSize);
+    }
+    double memcpyNs = (nowNs() - start) / perItem;
+
+    start = nowNs();
+    for (long r = 0; r < rounds; r++) {
+      roundClass(itemSize, copyClass);
+    }
+    double classNs = (nowNs() - start) / perItem;
+
+    printf("%-6zu %12.2f %12.2f\n", itemSize, memcpyNs, classNs);
+  }
+
+  return 0;
+}
@@ -0,0 +1,160 @@
+/**
+ * @file rta_tool.c
+ * @brief Host front end for the response time analysis in src/rta.c.
+ *
+ * Reads a task set description and prints each task's blocking term, worst case response
+ * time and slack, so a configuration can be checked before it is flashed.
+ *
+ * Usage: rta_tool <taskset file>
+ *
+ * The file has one declaration per line, and '#' starts a comment. Times are in microseconds.
+ *
+ *     task  <name> <period> <deadline> <wcet> <priority>
+ *     mutex <name> <hold time> <task>[,<task>...]
+ *
+ * A deadline of 0 means the deadline equals the period. Mutexes must come after the tasks
+ * that use them. The exit status is 0 if every task meets its deadline, 1 if not, and 2 if the
+ * file could not be read.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "rta.h"
+
+#define MAX_LINE 256
+#define MAX_NAME 32
+#define MAX_MUTEXES 32
+
+static char taskNames[rtaMAX_TASKS][MAX_NAME];
+static char mutexNames[MAX_MUTEXES][MAX_NAME];
+static RtaTask_t tasks[rtaMAX_TASKS];
+static RtaMutex_t mutexes[MAX_MUTEXES];
+static size_t taskCount = 0;
+static size_t mutexCount = 0;
+
+/**
+ * @brief Finds a task by name.
+ *
+ * @param name The name to look for.
+ * @return The index of the task, or -1 if there is none.
+ */
+static int findTask(const char *name) {
+  for (size_t i = 0; i < taskCount; i++) {
+    if (strcmp(tasks[i].pcName, name) == 0) {
+      return (int) i;
+    }
+  }
+  return -1;
+}
+
+/**
+ * @brief Parses one line of a task set file.
+ *
+ * @param line The line, without its comment.
+ * @param lineNo The line number, for error messages.
+ * @return 0 on success, -1 on a malformed line.
+ */
+static int parseLine(char *line, int lineNo) {
+  char kind[16], name[MAX_NAME], users[MAX_LINE];
+  unsigned long period, deadline, wcet, hold;
+  unsigned int priority;
+
+  if (sscanf(line, "%15s", kind) != 1) {
+    return 0; // blank line
+  }
+
+  if (strcmp(kind, "task") == 0) {
+    if (sscanf(line, "%*s %31s %lu %lu %lu %u", name, &period, &deadline, &wcet, &priority) != 5) {
+      fprintf(stderr, "line %d: expected: task <name> <period> <deadline> <wcet> <priority>\n", lineNo);
+      return -1;
+    }
+    if (taskCount == rtaMAX_TASKS) {
+      fprintf(stderr, "line %d: more than %u tasks\n", lineNo, rtaMAX_TASKS);
+      return -1;
+    }
+    strcpy(taskNames[taskCount], name);
+    tasks[taskCount].pcName = taskNames[taskCount];
+    tasks[taskCount].ulPeriod = period;
+    tasks[taskCount].ulDeadline = deadline;
+    tasks[taskCount].ulWcet = wcet;
+    tasks[taskCount].ucPriority = (uint8_t) priority;
+    taskCount++;
+  } else if (strcmp(kind, "mutex") == 0) {
+    if (sscanf(line, "%*s %31s %lu %255s", name, &hold, users) != 3) {
+      fprintf(stderr, "line %d: expected: mutex <name> <hold time> <task>[,<task>...]\n", lineNo);
+      return -1;
+    }
+    if (mutexCount == MAX_MUTEXES) {
+      fprintf(stderr, "line %d: more than %d mutexes\n", lineNo, MAX_MUTEXES);
+      return -1;
+    }
+    strcpy(mutexNames[mutexCount], name);
+    mutexes[mutexCount].pcName = mutexNames[mutexCount];
+    mutexes[mutexCount].ulHoldTime = hold;
+    mutexes[mutexCount].ulUsers = 0;
+    for (char *user = strtok(users, ","); user != NULL; user = strtok(NULL, ",")) {
+      int index = findTask(user);
+      if (index < 0) {
+        fprintf(stderr, "line %d: unknown task '%s'\n", lineNo, user);
+        return -1;
+      }
+      mutexes[mutexCount].ulUsers |= 1UL << index;
+    }
+    mutexCount++;
+  } else {
+    fprintf(stderr, "line %d: unknown declaration '%s'\n", lineNo, kind);
+    return -1;
+  }
+
+  return 0;
+}
+
+int main(int argc, char **argv) {
+  char line[MAX_LINE];
+  int lineNo = 0;
+
+  if (argc != 2) {
+    fprintf(stderr, "usage: %s <taskset file>\n", argv[0]);
+    return 2;
+  }
+
+  FILE *file = fopen(argv[1], "r");
+  if (file == NULL) {
+    perror(argv[1]);
+    return 2;
+  }
+
+  while (fgets(line, sizeof(line), file) != NULL) {
+    lineNo++;
+    char *comment = strchr(line, '#');
+    if (comment != NULL) {
+      *comment = '\0';
+    }
+    if (parseLine(line, lineNo) != 0) {
+      fclose(file);
+      return 2;
+    }
+  }
+  fclose(file);
+
+  size_t misses = xRtaAnalyse(tasks, taskCount, mutexes, mutexCount);
+
+  printf("%-12s %4s %10s %10s %10s %10s %10s %10s\n",
+         "task", "prio", "period", "deadline", "wcet", "blocking", "response", "slack");
+  for (size_t i = 0; i < taskCount; i++) {
+    RtaTask_t *t = &tasks[i];
+    printf("%-12s %4u %10lu %10lu %10lu %10lu %10lu %10ld%s\n",
+           t->pcName, (unsigned) t->ucPriority, (unsigned long) t->ulPeriod,
+           (unsigned long) (t->ulDeadline != 0 ? t->ulDeadline : t->ulPeriod),
+           (unsigned long) t->ulWcet, (unsigned long) t->ulBlocking,
+           (unsigned long) t->ulResponse, (long) t->lSlack,
+           t->ucSchedulable ? "" : "  MISS");
+  }
+
+  unsigned long utilisation = ulRtaUtilisation(tasks, taskCount);
+  printf("\nutilisation %lu.%lu%%, %s\n", utilisation / 10, utilisation % 10,
+         misses == 0 ? "schedulable" : "NOT schedulable");
+
+  return misses == 0 ? 0 : 1;
+}
@@ -0,0 +1,26 @@
+/*
+ * The Encoder library for the host simulator.  On the board pin change
+ * interrupts count the steps; here vSimTurnEncoder() does.
+ */
+#ifndef SIM_ENCODER_H
+#define SIM_ENCODER_H
+
+#include <Arduino.h>
+
+class Encoder {
+public:
+  Encoder(uint8_t pin1, uint8_t pin2);
+  ~Encoder();
+  long read();
+  void write(long p);
+
+  // Moves every encoder on pin1 by steps; what vSimTurnEncoder() calls.
+  static void turn(uint8_t pin1, long steps);
+
+private:
+  uint8_t pin1;
+  volatile long position;
+  Encoder *next;
+};
+
+#endif
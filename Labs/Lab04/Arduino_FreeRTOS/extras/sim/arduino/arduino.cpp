@@ -0,0 +1,518 @@
+/*
+ * The Arduino core for the host simulator, see Arduino.h.
+ */
+#include <stdio.h>
+
+#include <Arduino.h>
+#include <Encoder.h>
+
+#include "Arduino_FreeRTOS.h"
+#include "sim.h"
+
+// Roughly what each call takes on a 16 MHz ATmega2560, in microseconds.
+#define PIN_MODE_US 4
+#define DIGITAL_WRITE_US 4
+#define DIGITAL_READ_US 4
+#define ANALOG_READ_US 112
+#define ANALOG_WRITE_US 6
+#define MICROS_US 4
+#define TONE_US 10
+#define SERIAL_WRITE_US 5
+
+// Bytes the serial port can hold before write() has to wait for the UART.
+#define SERIAL_TX_BUFFER 64
+
+#define NUM_ANALOG_INPUTS 16
+
+#define SIM_PORT(x) volatile uint8_t PIN##x, DDR##x, PORT##x;
+extern "C" {
+SIM_PORT(A) SIM_PORT(B) SIM_PORT(C) SIM_PORT(D) SIM_PORT(E) SIM_PORT(F)
+SIM_PORT(G) SIM_PORT(H) SIM_PORT(J) SIM_PORT(K) SIM_PORT(L)
+}
+#undef SIM_PORT
+
+static uint8_t pinLevel[NUM_DIGITAL_PINS];
+static uint8_t pinOutput[NUM_DIGITAL_PINS];
+static bool pinDriven[NUM_DIGITAL_PINS];
+static uint16_t analogLevel[NUM_ANALOG_INPUTS];
+static unsigned int toneFrequency[NUM_DIGITAL_PINS];
+
+static unsigned long serialByteUs = 0;
+static uint64_t serialIdleUs = 0;
+static bool serialQuiet = false;
+
+static unsigned long randomState = 1;
+
+static Encoder *encoders = NULL;
+
+HardwareSerial Serial;
+
+/*--------------------------------------------------*/
+/*---------------------- Pins ----------------------*/
+/*--------------------------------------------------*/
+
+void pinMode(uint8_t pin, uint8_t mode) {
+  vSimConsume(PIN_MODE_US);
+  if (pin < NUM_DIGITAL_PINS && mode == INPUT_PULLUP && !pinDriven[pin]) {
+    pinLevel[pin] = HIGH;
+  }
+}
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+  vSimConsume(DIGITAL_WRITE_US);
+  if (pin < NUM_DIGITAL_PINS) {
+    pinOutput[pin] = val ? HIGH : LOW;
+    // writing an input turns its pull up on or off, which is what it then reads
+    if (!pinDriven[pin]) {
+      pinLevel[pin] = pinOutput[pin];
+    }
+  }
+}
+
+int digitalRead(uint8_t pin) {
+  vSimConsume(DIGITAL_READ_US);
+  return pin < NUM_DIGITAL_PINS ? pinLevel[pin] : LOW;
+}
+
+// analog pins can be given as A0..A15 or as channel numbers
+static int analogChannel(uint8_t pin) {
+  if (pin >= A0) {
+    pin -= A0;
+  }
+  return pin < NUM_ANALOG_INPUTS ? pin : -1;
+}
+
+int analogRead(uint8_t pin) {
+  vSimConsume(ANALOG_READ_US);
+  int channel = analogChannel(pin);
+  return channel < 0 ? 0 : analogLevel[channel];
+}
+
+void analogWrite(uint8_t pin, int val) {
+  vSimConsume(ANALOG_WRITE_US);
+  if (pin < NUM_DIGITAL_PINS) {
+    pinOutput[pin] = val > 127 ? HIGH : LOW;
+  }
+}
+
+void tone(uint8_t pin, unsigned int frequency, unsigned long duration) {
+  (void) duration;
+  vSimConsume(TONE_US);
+  if (pin < NUM_DIGITAL_PINS) {
+    toneFrequency[pin] = frequency;
+  }
+}
+
+void tone(uint8_t pin, unsigned int frequency) {
+  tone(pin, frequency, 0);
+}
+
+void noTone(uint8_t pin) {
+  tone(pin, 0, 0);
+}
+
+extern "C" void vSimSetDigitalInput(uint8_t ucPin, uint8_t ucLevel) {
+  if (ucPin < NUM_DIGITAL_PINS) {
+    pinDriven[ucPin] = true;
+    pinLevel[ucPin] = ucLevel ? HIGH : LOW;
+  }
+}
+
+extern "C" void vSimSetAnalogInput(uint8_t ucPin, uint16_t usValue) {
+  int channel = analogChannel(ucPin);
+  if (channel >= 0) {
+    analogLevel[channel] = usValue > 1023 ? 1023 : usValue;
+  }
+}
+
+extern "C" uint8_t ucSimGetDigitalOutput(uint8_t ucPin) {
+  return ucPin < NUM_DIGITAL_PINS ? pinOutput[ucPin] : LOW;
+}
+
+/*--------------------------------------------------*/
+/*---------------------- Time ----------------------*/
+/*--------------------------------------------------*/
+
+// Unlike the board's, these do not wrap after 71 minutes.
+unsigned long micros(void) {
+  vSimConsume(MICROS_US);
+  return (unsigned long) ullSimGetTime();
+}
+
+unsigned long millis(void) {
+  vSimConsume(MICROS_US);
+  return (unsigned long) (ullSimGetTime() / 1000U);
+}
+
+// delay() watches the clock, so time spent in other tasks counts
+void delay(unsigned long ms) {
+  vSimWaitUntil(ullSimGetTime() + (uint64_t) ms * 1000U);
+}
+
+// delayMicroseconds() counts cycles, so only this task's time counts
+void delayMicroseconds(unsigned int us) {
+  vSimConsume(us);
+}
+
+/*--------------------------------------------------*/
+/*--------------------- Random ---------------------*/
+/*--------------------------------------------------*/
+
+// avr-libc's random(), so a sketch gets the same numbers as on the board
+static long nextRandom(void) {
+  long x = (long) randomState;
+  if (x == 0) {
+    x = 123459876L;
+  }
+  long hi = x / 127773L;
+  long lo = x % 127773L;
+  x = 16807L * lo - 2836L * hi;
+  if (x < 0) {
+    x += 0x7fffffffL;
+  }
+  randomState = (unsigned long) x;
+  return x % 0x80000000L;
+}
+
+long random(long howbig) {
+  return howbig == 0 ? 0 : nextRandom() % howbig;
+}
+
+long random(long howsmall, long howbig) {
+  return howsmall >= howbig ? howsmall : random(howbig - howsmall) + howsmall;
+}
+
+void randomSeed(unsigned long seed) {
+  if (seed != 0) {
+    randomState = seed;
+  }
+}
+
+long map(long x, long in_min, long in_max, long out_min, long out_max) {
+  return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+/*--------------------------------------------------*/
+/*--------------------- String ---------------------*/
+/*--------------------------------------------------*/
+
+String::String(const char *str) : buffer(NULL), len(0) {
+  append(str, str == NULL ? 0 : strlen(str));
+}
+
+String::String(const String &other) : buffer(NULL), len(0) {
+  append(other.buffer, other.len);
+}
+
+String::String(char c) : buffer(NULL), len(0) {
+  append(&c, 1);
+}
+
+String::String(int value, unsigned char base) : String((long) value, base) {}
+
+String::String(unsigned int value, unsigned char base) : String((unsigned long) value, base) {}
+
+String::String(long value, unsigned char base) : buffer(NULL), len(0) {
+  if (value < 0 && base == DEC) {
+    append("-", 1);
+    *this += String((unsigned long) -value, base);
+  } else {
+    *this += String((unsigned long) value, base);
+  }
+}
+
+String::String(unsigned long value, unsigned char base) : buffer(NULL), len(0) {
+  char digits[8 * sizeof(unsigned long) + 1];
+  char *p = &digits[sizeof(digits) - 1];
+  if (base < 2) {
+    base = DEC;
+  }
+  *p = '\0';
+  do {
+    unsigned long d = value % base;
+    *--p = (char) (d < 10 ? '0' + d : 'A' + d - 10);
+    value /= base;
+  } while (value != 0);
+  append(p, strlen(p));
+}
+
+String::~String() {
+  free(buffer);
+}
+
+String &String::operator=(const String &other) {
+  if (this != &other) {
+    len = 0;
+    append(other.buffer, other.len);
+  }
+  return *this;
+}
+
+String &String::operator+=(const String &other) {
+  // copy first, in case other is this
+  String copy(other.buffer);
+  append(copy.buffer, copy.len);
+  return *this;
+}
+
+String &String::operator+=(const char *str) {
+  return *this += String(str);
+}
+
+String &String::operator+=(char c) {
+  append(&c, 1);
+  return *this;
+}
+
+void String::append(const char *str, unsigned int n) {
+  char *grown = (char *) realloc(buffer, len + n + 1);
+  if (grown == NULL) {
+    return;
+  }
+  buffer = grown;
+  memcpy(buffer + len, str, n);
+  len += n;
+  buffer[len] = '\0';
+}
+
+String operator+(const String &lhs, const String &rhs) {
+  String result(lhs);
+  result += rhs;
+  return result;
+}
+
+/*--------------------------------------------------*/
+/*---------------------- Print ---------------------*/
+/*--------------------------------------------------*/
+
+size_t Print::write(const uint8_t *buffer, size_t size) {
+  size_t n = 0;
+  while (size--) {
+    n += write(*buffer++);
+  }
+  return n;
+}
+
+size_t Print::print(const __FlashStringHelper *str) {
+  return write(reinterpret_cast<const char *>(str));
+}
+
+size_t Print::print(const String &str) {
+  return write((const uint8_t *) str.c_str(), str.length());
+}
+
+size_t Print::print(const char str[]) {
+  return write(str);
+}
+
+size_t Print::print(char c) {
+  return write((uint8_t) c);
+}
+
+size_t Print::print(unsigned char n, int base) {
+  return print((unsigned long) n, base);
+}
+
+size_t Print::print(int n, int base) {
+  return print((long) n, base);
+}
+
+size_t Print::print(unsigned int n, int base) {
+  return print((unsigned long) n, base);
+}
+
+size_t Print::print(long n, int base) {
+  if (base == 0) {
+    return write((uint8_t) n);
+  }
+  if (base == 10 && n < 0) {
+    size_t t = print('-');
+    return printNumber((unsigned long) -n, 10) + t;
+  }
+  return printNumber((unsigned long) n, base);
+}
+
+size_t Print::print(unsigned long n, int base) {
+  return base == 0 ? write((uint8_t) n) : printNumber(n, base);
+}
+
+size_t Print::print(double n, int digits) {
+  return printFloat(n, digits);
+}
+
+size_t Print::println(void) {
+  return write("\r\n");
+}
+
+size_t Print::println(const __FlashStringHelper *str) {
+  size_t n = print(str);
+  return n + println();
+}
+
+size_t Print::println(const String &str) {
+  size_t n = print(str);
+  return n + println();
+}
+
+size_t Print::println(const char str[]) {
+  size_t n = print(str);
+  return n + println();
+}
+
+size_t Print::println(char c) {
+  size_t n = print(c);
+  return n + println();
+}
+
+size_t Print::println(unsigned char b, int base) {
+  size_t n = print(b, base);
+  return n + println();
+}
+
+size_t Print::println(int num, int base) {
+  size_t n = print(num, base);
+  return n + println();
+}
+
+size_t Print::println(unsigned int num, int base) {
+  size_t n = print(num, base);
+  return n + println();
+}
+
+size_t Print::println(long num, int base) {
+  size_t n = print(num, base);
+  return n + println();
+}
+
+size_t Print::println(unsigned long num, int base) {
+  size_t n = print(num, base);
+  return n + println();
+}
+
+size_t Print::println(double num, int digits) {
+  size_t n = print(num, digits);
+  return n + println();
+}
+
+size_t Print::printNumber(unsigned long n, uint8_t base) {
+  return print(String(n, base));
+}
+
+// the same rounding and digits as the core's Print::printFloat()
+size_t Print::printFloat(double number, uint8_t digits) {
+  size_t n = 0;
+
+  if (isnan(number)) return print("nan");
+  if (isinf(number)) return print("inf");
+  if (number > 4294967040.0) return print("ovf");
+  if (number < -4294967040.0) return print("ovf");
+
+  if (number < 0.0) {
+    n += print('-');
+    number = -number;
+  }
+
+  double rounding = 0.5;
+  for (uint8_t i = 0; i < digits; ++i) {
+    rounding /= 10.0;
+  }
+  number += rounding;
+
+  unsigned long intPart = (unsigned long) number;
+  double remainder = number - (double) intPart;
+  n += print(intPart);
+
+  if (digits > 0) {
+    n += print('.');
+  }
+  while (digits-- > 0) {
+    remainder *= 10.0;
+    unsigned int toPrint = (unsigned int) remainder;
+    n += print(toPrint);
+    remainder -= toPrint;
+  }
+
+  return n;
+}
+
+/*--------------------------------------------------*/
+/*--------------------- Serial ---------------------*/
+/*--------------------------------------------------*/
+
+void HardwareSerial::begin(unsigned long baud) {
+  // a start bit, eight data bits and a stop bit
+  serialByteUs = baud == 0 ? 0 : (10000000UL + baud / 2) / baud;
+}
+
+// waits for the UART to send everything written so far
+void HardwareSerial::flush() {
+  vSimWaitUntil(serialIdleUs);
+  fflush(stdout);
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+  vSimConsume(SERIAL_WRITE_US);
+
+  if (serialByteUs != 0) {
+    // wait for room in the transmit buffer; another task may take it first
+    uint64_t backlog = (uint64_t) (SERIAL_TX_BUFFER - 1) * serialByteUs;
+    while (serialIdleUs > ullSimGetTime() + backlog) {
+      vSimWaitUntil(serialIdleUs - backlog);
+    }
+    uint64_t now = ullSimGetTime();
+    serialIdleUs = (serialIdleUs > now ? serialIdleUs : now) + serialByteUs;
+  }
+
+  // the board sends "\r\n" line ends; stdout only needs the "\n"
+  if (!serialQuiet && c != '\r') {
+    putchar(c);
+  }
+  return 1;
+}
+
+extern "C" void vSimSetSerialQuiet(BaseType_t xQuiet) {
+  serialQuiet = xQuiet != pdFALSE;
+}
+
+/*--------------------------------------------------*/
+/*--------------------- Encoder --------------------*/
+/*--------------------------------------------------*/
+
+Encoder::Encoder(uint8_t pin1, uint8_t pin2) : pin1(pin1), position(0), next(encoders) {
+  (void) pin2;
+  encoders = this;
+}
+
+Encoder::~Encoder() {
+  for (Encoder **e = &encoders; *e != NULL; e = &(*e)->next) {
+    if (*e == this) {
+      *e = next;
+      break;
+    }
+  }
+}
+
+long Encoder::read() {
+  noInterrupts();
+  long p = position;
+  interrupts();
+  return p;
+}
+
+void Encoder::write(long p) {
+  noInterrupts();
+  position = p;
+  interrupts();
+}
+
+void Encoder::turn(uint8_t pin1, long steps) {
+  for (Encoder *e = encoders; e != NULL; e = e->next) {
+    if (e->pin1 == pin1) {
+      e->position += steps;
+    }
+  }
+}
+
+extern "C" void vSimTurnEncoder(uint8_t ucPin1, long lSteps) {
+  Encoder::turn(ucPin1, lSteps);
+}
@@ -0,0 +1,10 @@
+/*
+ * arduinoFFT for the host simulator.  The scoreboard includes it without
+ * using it, so there is nothing in here yet.
+ */
+#ifndef SIM_ARDUINOFFT_H
+#define SIM_ARDUINOFFT_H
+
+#include <Arduino.h>
+
+#endif
@@ -0,0 +1,23 @@
+/*
+ * <avr/interrupt.h> for the host simulator.  cli() and sei() mask the
+ * simulated interrupts; there are no vectors, attach handlers with
+ * xSimAttachInterrupt() instead.
+ */
+#ifndef SIM_AVR_INTERRUPT_H
+#define SIM_AVR_INTERRUPT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void vPortDisableInterrupts(void);
+void vPortEnableInterrupts(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#define cli() vPortDisableInterrupts()
+#define sei() vPortEnableInterrupts()
+
+#endif
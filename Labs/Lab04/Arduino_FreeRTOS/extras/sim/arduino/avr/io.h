@@ -0,0 +1,29 @@
+/*
+ * <avr/io.h> for the host simulator.  The port registers are plain bytes that
+ * sketches can write to and read back; nothing is wired to them.
+ */
+#ifndef SIM_AVR_IO_H
+#define SIM_AVR_IO_H
+
+#include <stdint.h>
+
+#ifndef F_CPU
+#define F_CPU 16000000UL
+#endif
+
+#define _BV(bit) (1 << (bit))
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SIM_PORT(x) extern volatile uint8_t PIN##x, DDR##x, PORT##x;
+SIM_PORT(A) SIM_PORT(B) SIM_PORT(C) SIM_PORT(D) SIM_PORT(E) SIM_PORT(F)
+SIM_PORT(G) SIM_PORT(H) SIM_PORT(J) SIM_PORT(K) SIM_PORT(L)
+#undef SIM_PORT
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
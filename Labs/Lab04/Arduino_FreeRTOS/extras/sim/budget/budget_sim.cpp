@@ -0,0 +1,123 @@
+/**
+ * @file budget_sim.cpp
+ * @brief Checks on the host simulator that CPU budgets only throttle a task that is ready.
+ *
+ * A task can use up its budget where the kernel blocks it, with the scheduler suspended, when
+ * an interrupt lands there. The ticks that came in are then replayed by xTaskResumeAll() after
+ * the task has left the ready list, and must neither throttle it, which would change how long
+ * it blocks for, nor count an overrun. The charge is left for the next tick the task is running
+ * at, which throttles it as usual.
+ *
+ * The greedy task, with a budget of BUDGET_US every BUDGET_PERIOD ticks, stalls for STALL_TICKS
+ * where it blocks, with vSimStallNextBlock(), first in vTaskDelay() and then waiting on a queue
+ * with no timeout. After the delay it runs for a tick, and is throttled for the rest of the
+ * period. A check that fails stops the simulation, so the run exits with status 1.
+ *
+ * Usage: budget_sim [-s seed] [-d seconds] [-t trace file] [-q]
+ *
+ * See sim_variant.cpp for the options and sim.h for how time is simulated.
+ */
+#include <Arduino.h>
+
+#include "Arduino_FreeRTOS.h"
+#include "queue.h"
+#include "task.h"
+#include "sim.h"
+
+#define BUDGET_US 5000UL
+#define BUDGET_PERIOD 20
+#define STALL_TICKS 3
+#define DELAY_TICKS 5
+#define SEND_TICKS 30
+
+static TaskHandle_t giverHandle;
+static QueueHandle_t sentQueue;
+
+/**
+ * @brief Stops the simulation if the greedy task was throttled a different number of times.
+ */
+static void expectOverruns(uint16_t before, uint16_t expected, const char *where) {
+  uint16_t overruns = usTaskGetBudgetOverruns(NULL) - before;
+  if (overruns != expected) {
+    vSimFail("%s: throttled %u times, expected %u", where, overruns, expected);
+  }
+}
+
+/**
+ * @brief Uses up the budget in vTaskDelay(), which must still delay for DELAY_TICKS.
+ */
+static void checkDelay(void) {
+  vTaskSetBudget(NULL, BUDGET_US, BUDGET_PERIOD);
+  uint16_t overruns = usTaskGetBudgetOverruns(NULL);
+  TickType_t start = xTaskGetTickCount();
+
+  vSimStallNextBlock(STALL_TICKS * portTICK_PERIOD_US);
+  vTaskDelay(DELAY_TICKS);
+
+  TickType_t slept = xTaskGetTickCount() - start;
+  if (slept != DELAY_TICKS) {
+    vSimFail("vTaskDelay(%u) blocked for %lu ticks", DELAY_TICKS, (unsigned long) slept);
+  }
+  expectOverruns(overruns, 0, "blocked in vTaskDelay()");
+
+  // Still over budget, so the next tick it runs at throttles it until the period ends.
+  vSimConsume(portTICK_PERIOD_US);
+
+  TickType_t resumed = xTaskGetTickCount() - start;
+  if (resumed != BUDGET_PERIOD) {
+    vSimFail("throttled until tick %lu of the period, expected %u", (unsigned long) resumed, BUDGET_PERIOD);
+  }
+  expectOverruns(overruns, 1, "running over budget");
+}
+
+/**
+ * @brief Uses up the budget blocking on a queue with no timeout, which must wait for the item.
+ */
+static void checkQueueWait(void) {
+  vTaskSetBudget(NULL, BUDGET_US, BUDGET_PERIOD);
+  uint16_t overruns = usTaskGetBudgetOverruns(NULL);
+  TickType_t sent;
+
+  xTaskNotifyGive(giverHandle);
+  vSimStallNextBlock(STALL_TICKS * portTICK_PERIOD_US);
+  if (xQueueReceive(sentQueue, &sent, portMAX_DELAY) != pdPASS) {
+    vSimFail("xQueueReceive() with no timeout failed");
+  }
+
+  if (xTaskGetTickCount() != sent) {
+    vSimFail("woke at tick %lu for an item sent at %lu", (unsigned long) xTaskGetTickCount(), (unsigned long) sent);
+  }
+  expectOverruns(overruns, 0, "blocked on a queue");
+}
+
+/**
+ * @brief Greedy task, runs the checks over and over.
+ */
+static void TaskGreedy(void *pvParameters __attribute__((unused))) {
+  for (;;) {
+    checkDelay();
+    checkQueueWait();
+  }
+}
+
+/**
+ * @brief Giver task, sends the greedy task the tick count SEND_TICKS after it asks.
+ */
+static void TaskGiver(void *pvParameters __attribute__((unused))) {
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    vTaskDelay(SEND_TICKS);
+
+    TickType_t now = xTaskGetTickCount();
+    xQueueSend(sentQueue, &now, 0);
+  }
+}
+
+void setup() {
+  sentQueue = xQueueCreate(1, sizeof(TickType_t));
+  xTaskCreate(TaskGreedy, "Greedy", 128, NULL, 2, NULL);
+  xTaskCreate(TaskGiver, "Giver", 128, NULL, 1, &giverHandle);
+}
+
+void loop() {
+}
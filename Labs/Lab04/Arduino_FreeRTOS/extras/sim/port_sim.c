@@ -0,0 +1,901 @@
+/*
+ * This file is NOT part of the FreeRTOS distribution.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+/*
+ * The port layer of the host simulator described in sim.h.
+ *
+ * Every task gets a host stack and a ucontext of its own, and a context
+ * switch is a swapcontext() on the one host thread, so only one task ever
+ * runs at a time and nothing depends on the host's scheduler.  The task's
+ * FreeRTOS stack is still allocated, filled and checked by the kernel, but the
+ * only thing stored on it is a pointer to the host context.
+ *
+ * The virtual clock is moved on by prvAdvanceTo(), which delivers the tick
+ * and the simulated interrupts that fall due on the way.  An interrupt that
+ * falls due while interrupts are masked is latched, as the interrupt flag
+ * would be on the board, and delivered when they are unmasked.  If an
+ * interrupt readies a task that should preempt the one running, the switch
+ * happens as soon as the interrupt returns.
+ */
+
+/* Standard includes. */
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ucontext.h>
+
+/* FreeRTOS includes. */
+#include "Arduino_FreeRTOS.h"
+#include "task.h"
+#include "sim.h"
+
+#if ( configUSE_PREEMPTION != 1 )
+    #error extras/sim only implements the preemptive scheduler
+#endif
+
+#if ( configUSE_TICKLESS_IDLE == 0 )
+    #error configUSE_TICKLESS_IDLE must not be 0 in extras/sim, it is what skips idle time
+#endif
+
+#if ( configUSE_IDLE_POWER != 1 )
+    #error configUSE_IDLE_POWER must be set to 1 to use extras/sim, for xTaskIdleMaySleep()
+#endif
+
+/* The host stack given to each task.  Sketches format text and call into the
+ * C library on it, which the FreeRTOS stack depths were never sized for. */
+#define simHOST_STACK_SIZE    ( ( size_t ) 256U * 1024U )
+
+/* A time that never comes. */
+#define simNEVER              UINT64_MAX
+
+/* The FNV-1a hash of nothing, and its multiplier. */
+#define simHASH_BASIS         0x811C9DC5UL
+#define simHASH_PRIME         0x01000193UL
+
+/* The longest failure reason kept by vSimFail(). */
+#define simFAILURE_LENGTH     128
+
+/* The kernel's current TCB.  Its first member is the task's top of stack. */
+typedef void TCB_t;
+extern volatile TCB_t * volatile pxCurrentTCB;
+
+/* A task's host context, and the interrupt state it was switched out with. */
+typedef struct SimContext
+{
+    ucontext_t xContext;
+    void * pvHostStack;
+    TaskFunction_t pxCode;
+    void * pvParameters;
+    BaseType_t xInterruptsEnabled;
+    UBaseType_t uxCriticalNesting;
+    BaseType_t xEnabledBeforeCritical; /*< Restored when the outermost critical section exits. */
+    struct SimContext * pxNext;        /*< Every task's context, so they can all be freed when the scheduler ends. */
+} SimContext_t;
+
+typedef struct SimInterrupt
+{
+    SimInterruptHandler_t pxHandler;
+    uint64_t ullNextUs;
+    uint32_t ulMinGapUs;
+    uint32_t ulGapSpanUs;
+    uint32_t ulRandom;                 /*< Each interrupt draws its gaps from its own generator. */
+    BaseType_t xPending;
+} SimInterrupt_t;
+
+/* The context setup() runs in, and vTaskStartScheduler() returns to.  As on
+ * the board, interrupts are enabled before setup() is called. */
+static SimContext_t xMainContext = { .xInterruptsEnabled = pdTRUE };
+static SimContext_t * pxCurrentContext = &xMainContext;
+static SimContext_t * pxTaskContexts = NULL;
+
+static uint64_t ullNowUs = 0;
+static uint64_t ullNextTickUs = simNEVER;
+static uint64_t ullEndUs = simNEVER;
+static BaseType_t xTickPending = pdFALSE;
+static BaseType_t xRunning = pdFALSE;
+static BaseType_t xFinished = pdFALSE;
+
+static SimInterrupt_t xInterrupts[ simMAX_INTERRUPTS ];
+static UBaseType_t uxInterrupts = 0;
+static BaseType_t xInInterrupt = pdFALSE;
+static BaseType_t xSwitchPending = pdFALSE;
+static uint32_t ulBlockingStallUs = 0UL;
+
+static uint32_t ulSeed = 1UL;
+static uint32_t ulRandom = 1UL;
+
+static FILE * pxTraceFile = NULL;
+static uint32_t ulTraceHash = simHASH_BASIS;
+static uint32_t ulContextSwitches = 0UL;
+
+static char cFailure[ simFAILURE_LENGTH ];
+static BaseType_t xFailed = pdFALSE;
+
+static UBaseType_t uxCoreID = 0;
+static UBaseType_t uxNumberOfCores = 1;
+static UBaseType_t uxTasksPlaced[ simMAX_CORES ];
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Move the clock on to ullTargetUs, delivering every interrupt that falls due
+ * on the way.  May switch to another task and come back much later.
+ */
+static void prvAdvanceTo( uint64_t ullTargetUs );
+
+/*
+ * Run the interrupts that are pending, if interrupts are enabled, then switch
+ * task if one of them asked to.
+ */
+static void prvServiceInterrupts( void );
+
+/*
+ * Let the kernel pick the next task and switch to it.
+ */
+static void prvSwitchContext( void );
+
+/*-----------------------------------------------------------*/
+
+static uint32_t prvRandom( uint32_t * pulState )
+{
+    /* xorshift32. */
+    uint32_t ulX = *pulState;
+
+    ulX ^= ulX << 13;
+    ulX ^= ulX >> 17;
+    ulX ^= ulX << 5;
+    *pulState = ulX;
+
+    return ulX;
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvMixSeed( uint32_t ulValue )
+{
+    /* Spread nearby seeds apart, and never return the one state xorshift
+     * cannot leave. */
+    ulValue ^= ulValue >> 16;
+    ulValue *= 0x7FEB352DUL;
+    ulValue ^= ulValue >> 15;
+    ulValue *= 0x846CA68BUL;
+    ulValue ^= ulValue >> 16;
+
+    return ( ulValue != 0UL ) ? ulValue : 1UL;
+}
+/*-----------------------------------------------------------*/
+
+static SimContext_t * prvContextOf( volatile TCB_t * pxTCB )
+{
+    SimContext_t * pxContext;
+
+    memcpy( &pxContext, *( StackType_t * const * ) pxTCB, sizeof( pxContext ) );
+
+    return pxContext;
+}
+/*-----------------------------------------------------------*/
+
+static void prvHash( const void * pvData,
+                     size_t xLength )
+{
+    const uint8_t * pucData = ( const uint8_t * ) pvData;
+
+    while( xLength-- > 0U )
+    {
+        ulTraceHash = ( ulTraceHash ^ *pucData++ ) * simHASH_PRIME;
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvTraceSwitch( void )
+{
+    const char * pcName = pcTaskGetName( NULL );
+    uint8_t ucTime[ sizeof( uint64_t ) ];
+    size_t x;
+
+    /* Hash the time byte by byte so the result does not depend on the host's
+     * byte order. */
+    for( x = 0; x < sizeof( ucTime ); x++ )
+    {
+        ucTime[ x ] = ( uint8_t ) ( ullNowUs >> ( 8U * x ) );
+    }
+
+    prvHash( ucTime, sizeof( ucTime ) );
+    prvHash( pcName, strlen( pcName ) + 1U );
+    ulContextSwitches++;
+
+    if( pxTraceFile != NULL )
+    {
+        fprintf( pxTraceFile, "%llu %s\n", ( unsigned long long ) ullNowUs, pcName );
+    }
+}
+/*-----------------------------------------------------------*/
+
+static uint64_t prvNextInterruptTime( void )
+{
+    uint64_t ullNext = simNEVER;
+    UBaseType_t x;
+
+    for( x = 0; x < uxInterrupts; x++ )
+    {
+        if( xInterrupts[ x ].ullNextUs < ullNext )
+        {
+            ullNext = xInterrupts[ x ].ullNextUs;
+        }
+    }
+
+    return ullNext;
+}
+/*-----------------------------------------------------------*/
+
+static uint64_t prvNextEventTime( void )
+{
+    uint64_t ullNext = prvNextInterruptTime();
+
+    if( ullNextTickUs < ullNext )
+    {
+        ullNext = ullNextTickUs;
+    }
+
+    if( ( xRunning != pdFALSE ) && ( ullEndUs < ullNext ) )
+    {
+        ullNext = ullEndUs;
+    }
+
+    return ullNext;
+}
+/*-----------------------------------------------------------*/
+
+static void prvScheduleInterrupt( SimInterrupt_t * pxInterrupt )
+{
+    uint32_t ulGap = pxInterrupt->ulMinGapUs;
+
+    if( pxInterrupt->ulGapSpanUs != 0UL )
+    {
+        ulGap += prvRandom( &( pxInterrupt->ulRandom ) ) % pxInterrupt->ulGapSpanUs;
+    }
+
+    pxInterrupt->ullNextUs = ullNowUs + ulGap;
+}
+/*-----------------------------------------------------------*/
+
+static void prvEndSimulation( void )
+{
+    xFinished = pdTRUE;
+    ullEndUs = simNEVER;
+    vTaskEndScheduler();
+}
+/*-----------------------------------------------------------*/
+
+static void prvAdvanceTo( uint64_t ullTargetUs )
+{
+    uint64_t ullNext;
+    UBaseType_t x;
+
+    for( ; ; )
+    {
+        ullNext = prvNextEventTime();
+
+        if( ullNext > ullTargetUs )
+        {
+            break;
+        }
+
+        ullNowUs = ullNext;
+
+        if( ( xRunning != pdFALSE ) && ( ullNowUs == ullEndUs ) )
+        {
+            prvEndSimulation();
+        }
+
+        /* Raise every interrupt due now, in a fixed order. */
+        if( ullNextTickUs == ullNowUs )
+        {
+            xTickPending = pdTRUE;
+            ullNextTickUs += portTICK_PERIOD_US;
+        }
+
+        for( x = 0; x < uxInterrupts; x++ )
+        {
+            if( xInterrupts[ x ].ullNextUs == ullNowUs )
+            {
+                xInterrupts[ x ].xPending = pdTRUE;
+                prvScheduleInterrupt( &( xInterrupts[ x ] ) );
+            }
+        }
+
+        prvServiceInterrupts();
+    }
+
+    if( ullNowUs < ullTargetUs )
+    {
+        ullNowUs = ullTargetUs;
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvRunInterrupt( SimInterruptHandler_t pxHandler )
+{
+    /* The handler runs on the stack of whatever it interrupted, with
+     * interrupts masked as they are on entry to an AVR interrupt. */
+    xInInterrupt = pdTRUE;
+    pxCurrentContext->xInterruptsEnabled = pdFALSE;
+
+    pxHandler();
+
+    pxCurrentContext->xInterruptsEnabled = pdTRUE;
+    xInInterrupt = pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+static void prvTickInterrupt( void )
+{
+    if( xTaskIncrementTick() != pdFALSE )
+    {
+        xSwitchPending = pdTRUE;
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvServiceInterrupts( void )
+{
+    BaseType_t xServiced;
+    UBaseType_t x;
+
+    if( ( pxCurrentContext->xInterruptsEnabled == pdFALSE ) || ( xInInterrupt != pdFALSE ) )
+    {
+        return;
+    }
+
+    /* A handler can spend time, and so raise more interrupts, so keep going
+     * until none are left. */
+    do
+    {
+        xServiced = pdFALSE;
+
+        if( xTickPending != pdFALSE )
+        {
+            xTickPending = pdFALSE;
+            prvRunInterrupt( prvTickInterrupt );
+            xServiced = pdTRUE;
+        }
+
+        for( x = 0; x < uxInterrupts; x++ )
+        {
+            if( xInterrupts[ x ].xPending != pdFALSE )
+            {
+                xInterrupts[ x ].xPending = pdFALSE;
+                prvRunInterrupt( xInterrupts[ x ].pxHandler );
+                xServiced = pdTRUE;
+            }
+        }
+    } while( xServiced != pdFALSE );
+
+    if( xSwitchPending != pdFALSE )
+    {
+        if( xRunning != pdFALSE )
+        {
+            prvSwitchContext();
+        }
+        else
+        {
+            xSwitchPending = pdFALSE;
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+static void prvSwitchContext( void )
+{
+    SimContext_t * pxOld = pxCurrentContext;
+    SimContext_t * pxNew;
+    BaseType_t xWasEnabled = pxOld->xInterruptsEnabled;
+
+    /* Interrupts are masked while the kernel picks the next task, as they are
+     * in vPortYield() on the board. */
+    pxOld->xInterruptsEnabled = pdFALSE;
+    xSwitchPending = pdFALSE;
+
+    vTaskSwitchContext();
+    pxNew = prvContextOf( pxCurrentTCB );
+
+    if( pxNew != pxOld )
+    {
+        prvTraceSwitch();
+        pxCurrentContext = pxNew;
+        swapcontext( &( pxOld->xContext ), &( pxNew->xContext ) );
+
+        /* Switched back in.  Whoever switched to this task has already made
+         * it the current context. */
+    }
+
+    pxOld->xInterruptsEnabled = xWasEnabled;
+    prvServiceInterrupts();
+}
+/*-----------------------------------------------------------*/
+
+static void prvTaskEntry( void )
+{
+    SimContext_t * pxContext = pxCurrentContext;
+
+    /* Tasks start with interrupts enabled.  Deliver anything that came in
+     * while the kernel was switching to this one. */
+    pxContext->xInterruptsEnabled = pdTRUE;
+    prvServiceInterrupts();
+
+    pxContext->pxCode( pxContext->pvParameters );
+
+    /* Tasks must delete themselves rather than return. */
+    vSimFail( "task %s returned", pcTaskGetName( NULL ) );
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * See header file for description.
+ */
+StackType_t * pxPortInitialiseStack( StackType_t * pxTopOfStack,
+                                     TaskFunction_t pxCode,
+                                     void * pvParameters )
+{
+    SimContext_t * pxContext = ( SimContext_t * ) calloc( 1, sizeof( SimContext_t ) );
+
+    if( pxContext != NULL )
+    {
+        pxContext->pvHostStack = malloc( simHOST_STACK_SIZE );
+    }
+
+    if( ( pxContext == NULL ) || ( pxContext->pvHostStack == NULL ) )
+    {
+        vSimFail( "out of host memory for a task" );
+    }
+
+    pxContext->pxCode = pxCode;
+    pxContext->pvParameters = pvParameters;
+    pxContext->pxNext = pxTaskContexts;
+    pxTaskContexts = pxContext;
+
+    getcontext( &( pxContext->xContext ) );
+    pxContext->xContext.uc_stack.ss_sp = pxContext->pvHostStack;
+    pxContext->xContext.uc_stack.ss_size = simHOST_STACK_SIZE;
+    pxContext->xContext.uc_link = NULL;
+    makecontext( &( pxContext->xContext ), prvTaskEntry, 0 );
+
+    /* Keep the context where the kernel keeps the top of stack. */
+    pxTopOfStack -= sizeof( SimContext_t * );
+    memcpy( pxTopOfStack, &pxContext, sizeof( SimContext_t * ) );
+
+    return pxTopOfStack;
+}
+/*-----------------------------------------------------------*/
+
+void vPortFreeTaskContext( volatile StackType_t * pxTopOfStack )
+{
+    SimContext_t * pxContext;
+
+    /* Only ever called for a task that is not running. */
+    memcpy( &pxContext, ( const void * ) pxTopOfStack, sizeof( SimContext_t * ) );
+    configASSERT( pxContext != pxCurrentContext );
+
+    for( SimContext_t ** ppxLink = &pxTaskContexts; *ppxLink != NULL; ppxLink = &( ( *ppxLink )->pxNext ) )
+    {
+        if( *ppxLink == pxContext )
+        {
+            *ppxLink = pxContext->pxNext;
+            break;
+        }
+    }
+
+    free( pxContext->pvHostStack );
+    free( pxContext );
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xPortStartScheduler( void )
+{
+    SimContext_t * pxFirst = prvContextOf( pxCurrentTCB );
+
+    /* The first tick comes one period after the scheduler starts. */
+    ullNextTickUs = ullNowUs + portTICK_PERIOD_US;
+    xRunning = pdTRUE;
+
+    prvTraceSwitch();
+    pxCurrentContext = pxFirst;
+    swapcontext( &( xMainContext.xContext ), &( pxFirst->xContext ) );
+
+    /* vPortEndScheduler() was called.  The kernel can not be restarted, so
+     * none of the tasks will run again: give back their host stacks, which
+     * are most of the memory a run uses. */
+    while( pxTaskContexts != NULL )
+    {
+        SimContext_t * pxContext = pxTaskContexts;
+
+        pxTaskContexts = pxContext->pxNext;
+        free( pxContext->pvHostStack );
+        free( pxContext );
+    }
+
+    return pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+void vPortEndScheduler( void )
+{
+    ullNextTickUs = simNEVER;
+    xTickPending = pdFALSE;
+    xRunning = pdFALSE;
+    xInInterrupt = pdFALSE;
+    xSwitchPending = pdFALSE;
+
+    pxCurrentContext = &xMainContext;
+    setcontext( &( xMainContext.xContext ) );
+}
+/*-----------------------------------------------------------*/
+
+void vPortYield( void )
+{
+    if( xInInterrupt != pdFALSE )
+    {
+        xSwitchPending = pdTRUE;
+    }
+    else
+    {
+        prvSwitchContext();
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vPortYieldFromISR( void )
+{
+    /* Acted on when the interrupt returns. */
+    xSwitchPending = pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+void vPortEnterCritical( void )
+{
+    if( pxCurrentContext->uxCriticalNesting == 0U )
+    {
+        pxCurrentContext->xEnabledBeforeCritical = pxCurrentContext->xInterruptsEnabled;
+    }
+
+    pxCurrentContext->xInterruptsEnabled = pdFALSE;
+    pxCurrentContext->uxCriticalNesting++;
+}
+/*-----------------------------------------------------------*/
+
+void vPortExitCritical( void )
+{
+    configASSERT( pxCurrentContext->uxCriticalNesting > 0U );
+
+    pxCurrentContext->uxCriticalNesting--;
+
+    if( pxCurrentContext->uxCriticalNesting == 0U )
+    {
+        pxCurrentContext->xInterruptsEnabled = pxCurrentContext->xEnabledBeforeCritical;
+        prvServiceInterrupts();
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vPortDisableInterrupts( void )
+{
+    pxCurrentContext->xInterruptsEnabled = pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+void vPortEnableInterrupts( void )
+{
+    /* Interrupts do not nest, so a handler can not unmask them. */
+    if( xInInterrupt == pdFALSE )
+    {
+        pxCurrentContext->xInterruptsEnabled = pdTRUE;
+        prvServiceInterrupts();
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime )
+{
+    uint64_t ullWakeUs, ullTargetUs;
+    uint32_t ulSkipped;
+
+    /* Called by the idle task with the scheduler suspended.  Nothing can run
+     * until the tick xExpectedIdleTime ticks from now, unless an interrupt
+     * readies a task first. */
+    if( eTaskConfirmSleepModeStatus() == eAbortSleep )
+    {
+        return;
+    }
+
+    ullWakeUs = ullNextTickUs + ( uint64_t ) ( xExpectedIdleTime - 1U ) * portTICK_PERIOD_US;
+    ullTargetUs = prvNextInterruptTime();
+
+    if( ullWakeUs < ullTargetUs )
+    {
+        ullTargetUs = ullWakeUs;
+    }
+
+    if( ullEndUs < ullTargetUs )
+    {
+        ullTargetUs = ullEndUs;
+    }
+
+    /* Step over the ticks before then, which would find nothing to do, and
+     * let the one at ullTargetUs, if there is one, be a real tick. */
+    if( ullTargetUs > ullNextTickUs )
+    {
+        ulSkipped = ( uint32_t ) ( ( ullTargetUs - ullNextTickUs + portTICK_PERIOD_US - 1U ) / portTICK_PERIOD_US );
+        vTaskStepTick( ( TickType_t ) ulSkipped );
+        ullNextTickUs += ( uint64_t ) ulSkipped * portTICK_PERIOD_US;
+    }
+
+    prvAdvanceTo( ullTargetUs );
+}
+/*-----------------------------------------------------------*/
+
+void vSimIdle( void )
+{
+    BaseType_t xMaySleep;
+
+    vTaskSuspendAll();
+    {
+        portENTER_CRITICAL();
+        {
+            xMaySleep = xTaskIdleMaySleep();
+        }
+        portEXIT_CRITICAL();
+
+        /* Nothing to do until something happens, so make it happen. */
+        if( xMaySleep != pdFALSE )
+        {
+            prvAdvanceTo( prvNextEventTime() );
+        }
+    }
+    ( void ) xTaskResumeAll();
+}
+/*-----------------------------------------------------------*/
+
+void vSimConsume( uint32_t ulMicroseconds )
+{
+    uint64_t ullNext, ullStepUs;
+
+    while( ulMicroseconds > 0UL )
+    {
+        /* Only the time up to the next event is certain to be this task's. */
+        ullNext = prvNextEventTime();
+        ullStepUs = ulMicroseconds;
+
+        if( ( ullNext > ullNowUs ) && ( ( ullNext - ullNowUs ) < ullStepUs ) )
+        {
+            ullStepUs = ullNext - ullNowUs;
+        }
+
+        ulMicroseconds -= ( uint32_t ) ullStepUs;
+        prvAdvanceTo( ullNowUs + ullStepUs );
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vSimStallNextBlock( uint32_t ulMicroseconds )
+{
+    ulBlockingStallUs = ulMicroseconds;
+}
+/*-----------------------------------------------------------*/
+
+void vPortBlockingStall( void )
+{
+    uint32_t ulStallUs = ulBlockingStallUs;
+
+    /* Only the next task to block stalls. */
+    ulBlockingStallUs = 0UL;
+    vSimConsume( ulStallUs );
+}
+/*-----------------------------------------------------------*/
+
+void vSimWaitUntil( uint64_t ullTimeUs )
+{
+    /* Preemption may take the clock past ullTimeUs before this returns. */
+    while( ullNowUs < ullTimeUs )
+    {
+        prvAdvanceTo( ullTimeUs );
+    }
+}
+/*-----------------------------------------------------------*/
+
+void vSimSetSeed( uint32_t ulNewSeed )
+{
+    ulSeed = ulNewSeed;
+    ulRandom = prvMixSeed( ulNewSeed );
+}
+/*-----------------------------------------------------------*/
+
+void vSimSetDuration( uint64_t ullDurationUs )
+{
+    ullEndUs = ullDurationUs;
+}
+/*-----------------------------------------------------------*/
+
+void vSimSetTraceFile( FILE * pxFile )
+{
+    pxTraceFile = pxFile;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xSimAttachInterrupt( SimInterruptHandler_t pxHandler,
+                                uint32_t ulMinGapUs,
+                                uint32_t ulMaxGapUs )
+{
+    SimInterrupt_t * pxInterrupt;
+
+    configASSERT( pxHandler );
+    configASSERT( ( ulMinGapUs > 0UL ) && ( ulMinGapUs <= ulMaxGapUs ) );
+
+    if( uxInterrupts >= simMAX_INTERRUPTS )
+    {
+        return pdFAIL;
+    }
+
+    pxInterrupt = &( xInterrupts[ uxInterrupts ] );
+    pxInterrupt->pxHandler = pxHandler;
+    pxInterrupt->ulMinGapUs = ulMinGapUs;
+    pxInterrupt->ulGapSpanUs = ulMaxGapUs - ulMinGapUs + 1UL;
+    pxInterrupt->ulRandom = prvMixSeed( ulSeed + uxInterrupts + 1UL );
+    pxInterrupt->xPending = pdFALSE;
+    prvScheduleInterrupt( pxInterrupt );
+    uxInterrupts++;
+
+    return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulSimRandom( void )
+{
+    return prvRandom( &ulRandom );
+}
+/*-----------------------------------------------------------*/
+
+uint64_t ullSimGetTime( void )
+{
+    return ullNowUs;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xSimIsFinished( void )
+{
+    return xFinished;
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulSimGetContextSwitches( void )
+{
+    return ulContextSwitches;
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulSimGetTraceHash( void )
+{
+    return ulTraceHash;
+}
+/*-----------------------------------------------------------*/
+
+void vSimFail( const char * pcFormat,
+               ... )
+{
+    va_list xArgs;
+    int iLength;
+
+    if( xFailed == pdFALSE )
+    {
+        xFailed = pdTRUE;
+        iLength = snprintf( cFailure, sizeof( cFailure ), "at %llu us: ", ( unsigned long long ) ullNowUs );
+        va_start( xArgs, pcFormat );
+        vsnprintf( cFailure + iLength, sizeof( cFailure ) - ( size_t ) iLength, pcFormat, xArgs );
+        va_end( xArgs );
+    }
+
+    if( xRunning != pdFALSE )
+    {
+        /* Back to where vTaskStartScheduler() was called. */
+        prvEndSimulation();
+    }
+
+    /* Nothing to return to before the scheduler starts. */
+    fprintf( stderr, "sim: %s\n", cFailure );
+    exit( EXIT_FAILURE );
+}
+/*-----------------------------------------------------------*/
+
+const char * pcSimGetFailure( void )
+{
+    return ( xFailed != pdFALSE ) ? cFailure : NULL;
+}
+/*-----------------------------------------------------------*/
+
+void vSimSetCore( UBaseType_t uxNewCoreID,
+                  UBaseType_t uxNewNumberOfCores )
+{
+    configASSERT( ( uxNewNumberOfCores > 0U ) && ( uxNewNumberOfCores <= simMAX_CORES ) );
+    configASSERT( uxNewCoreID < uxNewNumberOfCores );
+
+    uxCoreID = uxNewCoreID;
+    uxNumberOfCores = uxNewNumberOfCores;
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxSimGetCoreID( void )
+{
+    return uxCoreID;
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxSimGetNumberOfCores( void )
+{
+    return uxNumberOfCores;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xSimTaskCreateAffinitySet( TaskFunction_t pxTaskCode,
+                                      const char * const pcName,
+                                      const configSTACK_DEPTH_TYPE usStackDepth,
+                                      void * const pvParameters,
+                                      UBaseType_t uxPriority,
+                                      UBaseType_t uxCoreAffinityMask,
+                                      TaskHandle_t * const pxCreatedTask )
+{
+    UBaseType_t uxCore, uxChosen = simMAX_CORES;
+
+    for( uxCore = 0; uxCore < uxNumberOfCores; uxCore++ )
+    {
+        if( ( ( uxCoreAffinityMask & ( 1U << uxCore ) ) != 0U ) &&
+            ( ( uxChosen == simMAX_CORES ) || ( uxTasksPlaced[ uxCore ] < uxTasksPlaced[ uxChosen ] ) ) )
+        {
+            uxChosen = uxCore;
+        }
+    }
+
+    if( uxChosen == simMAX_CORES )
+    {
+        /* None of the cores it may run on exist. */
+        return pdFAIL;
+    }
+
+    uxTasksPlaced[ uxChosen ]++;
+
+    if( uxChosen != uxCoreID )
+    {
+        if( pxCreatedTask != NULL )
+        {
+            *pxCreatedTask = NULL;
+        }
+
+        return pdPASS;
+    }
+
+    return xTaskCreate( pxTaskCode, pcName, usStackDepth, pvParameters, uxPriority, pxCreatedTask );
+}
+/*-----------------------------------------------------------*/
+
+void vPortAssert( const char * pcFile,
+                  int iLine )
+{
+    vSimFail( "assertion failed at %s:%d", pcFile, iLine );
+}
@@ -0,0 +1,145 @@
+/*
+ * This file is NOT part of the FreeRTOS distribution.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+/*
+ * Port macros for the host simulator.  portable.h picks this file instead of
+ * portmacro.h whenever __AVR__ is not defined.
+ *
+ * The types are the ones the ATmega port uses, so queue lengths, tick counts
+ * and stack depths wrap exactly as they do on the board; only pointers are
+ * wider.  Interrupts, critical sections and yields are function calls into
+ * port_sim.c, which runs every task on one host thread and keeps the time in
+ * a virtual microsecond clock.
+ */
+
+#ifndef PORTMACRO_SIM_H
+#define PORTMACRO_SIM_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*-----------------------------------------------------------
+ * Port specific definitions.
+ *-----------------------------------------------------------
+ */
+
+/* Type definitions. */
+
+typedef uint8_t                     StackType_t;
+typedef int8_t                      BaseType_t;
+typedef uint8_t                     UBaseType_t;
+
+#if configUSE_16_BIT_TICKS == 1
+    typedef uint16_t                TickType_t;
+    #define portMAX_DELAY           ( TickType_t ) 0xffff
+#else
+    typedef uint32_t                TickType_t;
+    #define portMAX_DELAY           ( TickType_t ) 0xffffffffUL
+#endif
+
+#define portPOINTER_SIZE_TYPE       uintptr_t
+/*-----------------------------------------------------------*/
+
+/* Critical section and interrupt management.  Interrupts are simulated, so
+ * masking them only holds them back until they are unmasked again. */
+
+extern void vPortEnterCritical( void );
+extern void vPortExitCritical( void );
+extern void vPortDisableInterrupts( void );
+extern void vPortEnableInterrupts( void );
+
+#define portENTER_CRITICAL()        vPortEnterCritical()
+#define portEXIT_CRITICAL()         vPortExitCritical()
+
+#define portDISABLE_INTERRUPTS()    vPortDisableInterrupts()
+#define portENABLE_INTERRUPTS()     vPortEnableInterrupts()
+/*-----------------------------------------------------------*/
+
+/* Architecture specifics. */
+
+#define portSTACK_GROWTH            ( -1 )
+#define portTICK_PERIOD_MS          ( (TickType_t) _BV( portUSE_WDTO + 4 ) )
+#define portTICK_PERIOD_US          ( (uint32_t) portTICK_PERIOD_MS * 1000UL )
+#define portBYTE_ALIGNMENT          8
+#define portNOP()
+#define portMEMORY_BARRIER()        __asm__ __volatile__ ( "" ::: "memory" )
+/*-----------------------------------------------------------*/
+
+/* Kernel utilities. */
+
+extern void vPortYield( void );
+#define portYIELD()                 vPortYield()
+
+extern void vPortYieldFromISR( void );
+#define portYIELD_FROM_ISR()        vPortYieldFromISR()
+
+/* Each task runs on a host stack of its own, which is freed with its TCB.  The
+ * port keeps a pointer to it where the task's context would be saved on the
+ * board, at the top of the task's own stack. */
+extern void vPortFreeTaskContext( volatile StackType_t * pxTopOfStack );
+#define portCLEAN_UP_TCB( pxTCB )   vPortFreeTaskContext( ( pxTCB )->pxTopOfStack )
+/*-----------------------------------------------------------*/
+
+/* Time only passes in the simulator when something spends it, so the idle task
+ * skips straight to the tick that unblocks the next task, or to the next
+ * simulated interrupt if that comes first. */
+
+#ifndef configUSE_TICKLESS_IDLE
+    #define configUSE_TICKLESS_IDLE     1
+#endif
+
+extern void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime );
+#define portSUPPRESS_TICKS_AND_SLEEP( xExpectedIdleTime )    vPortSuppressTicksAndSleep( xExpectedIdleTime )
+/*-----------------------------------------------------------*/
+
+/* Where a task blocks in vTaskDelay(), or on a queue or semaphore, the kernel
+ * has the scheduler suspended, and nothing in it takes any time.  A test can
+ * make it take some, so that ticks are pended there, with vSimStallNextBlock()
+ * in sim.h. */
+
+extern void vPortBlockingStall( void );
+#define traceTASK_DELAY()                           vPortBlockingStall()
+#define traceBLOCKING_ON_QUEUE_RECEIVE( pxQueue )   vPortBlockingStall()
+/*-----------------------------------------------------------*/
+
+/* Assertions are cheap here, so check them whenever the application has not
+ * defined its own. */
+
+#ifndef configASSERT
+    extern void vPortAssert( const char * pcFile, int iLine );
+    #define configASSERT( x )    if( ( x ) == 0 ) { vPortAssert( __FILE__, __LINE__ ); }
+#endif
+/*-----------------------------------------------------------*/
+
+/* Task function macros as described on the FreeRTOS.org WEB site. */
+
+#define portTASK_FUNCTION_PROTO( vFunction, pvParameters ) void vFunction( void *pvParameters )
+#define portTASK_FUNCTION( vFunction, pvParameters ) void vFunction( void *pvParameters )
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PORTMACRO_SIM_H */
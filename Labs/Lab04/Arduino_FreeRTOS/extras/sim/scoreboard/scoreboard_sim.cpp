@@ -0,0 +1,93 @@
+/**
+ * @file scoreboard_sim.cpp
+ * @brief The scoreboard firmware of Labs/Lab04/4.2 on the host simulator.
+ *
+ * Builds 4.2.ino unchanged against the Arduino shim, with a simulated operator working the
+ * joystick, the buttons and the rotary encoder. Every 0.5 to 4 seconds the operator lets go of
+ * whatever they are holding, or else does something new: pushes the joystick to one side or
+ * presses it, turns the encoder a detent, presses the encoder's switch or the buzzer button, or
+ * flips the clock switch. What they do, and when, comes from the seed, so a run that shows a
+ * bug shows it again every time it is repeated with the same seed.
+ *
+ * Usage: scoreboard_sim [-s seed] [-d seconds] [-t trace file] [-q]
+ *
+ * The report job prints the timing of every job every five seconds, and the countdown starts at
+ * one minute, which the operator winds back and forth with the encoder.
+ * See sim_variant.cpp for the options and sim.h for how time is simulated.
+ */
+#include <Arduino.h>
+
+#include "4.2.ino"
+
+#include "sim.h"
+
+#define OPERATOR_MIN_GAP_US 500000UL
+#define OPERATOR_MAX_GAP_US 4000000UL
+
+#define NO_PIN 0xFF
+
+// The input the operator is holding, and the level it goes back to when they let go.
+static uint8_t heldPin = NO_PIN;
+static uint16_t heldRelease;
+static bool heldAnalog;
+
+/**
+ * @brief Holds an input at a level until the operator's next move.
+ */
+static void hold(uint8_t pin, bool analog, uint16_t level, uint16_t release) {
+  if (analog) {
+    vSimSetAnalogInput(pin, level);
+  } else {
+    vSimSetDigitalInput(pin, (uint8_t) level);
+  }
+  heldPin = pin;
+  heldAnalog = analog;
+  heldRelease = release;
+}
+
+/**
+ * @brief The operator's simulated interrupt.
+ */
+static void operatorInterrupt(void) {
+  if (heldPin != NO_PIN) {
+    if (heldAnalog) {
+      vSimSetAnalogInput(heldPin, heldRelease);
+    } else {
+      vSimSetDigitalInput(heldPin, (uint8_t) heldRelease);
+    }
+    heldPin = NO_PIN;
+    return;
+  }
+
+  uint32_t move = ulSimRandom() % 100;
+  if (move < 40) {
+    uint8_t axis = (ulSimRandom() & 1) ? JOY_X : JOY_Y;
+    hold(axis, true, (ulSimRandom() & 1) ? 1023 : 0, 512);
+  } else if (move < 55) {
+    hold(JOY_SW, false, LOW, HIGH);
+  } else if (move < 80) {
+    vSimTurnEncoder(ROTARY_CLK, (ulSimRandom() & 1) ? 4 : -4);
+  } else if (move < 85) {
+    hold(ROTARY_SW, false, LOW, HIGH);
+  } else if (move < 90) {
+    hold(BUTTON_PIN, false, HIGH, LOW);
+  } else if (move < 95) {
+    static uint8_t clockSwitch = HIGH;
+    clockSwitch = !clockSwitch;
+    vSimSetDigitalInput(CLOCK_SWITCH, clockSwitch);
+  }
+}
+
+void vApplicationSimSetupHook(void) {
+  // Everything starts at rest, with the clock running.
+  vSimSetAnalogInput(JOY_X, 512);
+  vSimSetAnalogInput(JOY_Y, 512);
+  vSimSetDigitalInput(JOY_SW, HIGH);
+  vSimSetDigitalInput(BUTTON_PIN, LOW);
+  vSimSetDigitalInput(CLOCK_SWITCH, HIGH);
+  vSimSetDigitalInput(ROTARY_SW, HIGH);
+
+  xSimAttachInterrupt(operatorInterrupt, OPERATOR_MIN_GAP_US, OPERATOR_MAX_GAP_US);
+  // The host has no Timer5, so the display is refreshed from a simulated interrupt at the same rate.
+  xSimAttachInterrupt(seven_seg_refresh, SEVEN_SEG_DIGIT_US, SEVEN_SEG_DIGIT_US);
+}
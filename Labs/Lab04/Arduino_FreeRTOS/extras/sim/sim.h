@@ -0,0 +1,312 @@
+/*
+ * This file is NOT part of the FreeRTOS distribution.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+/*
+ * Discrete event simulation of the kernel on a Linux host.
+ *
+ * The kernel sources, and a sketch built against the Arduino shim in
+ * arduino/, run unchanged on one host thread with port_sim.c as their port.
+ * Time is a virtual microsecond clock that only moves when something spends
+ * it: delay(), delayMicroseconds(), analogRead() and the serial port charge
+ * roughly what they cost on a 16 MHz ATmega2560, and everything else takes no
+ * time at all.  When every task is blocked the clock jumps straight to the
+ * tick that unblocks the next one, so an hour of firmware time takes seconds.
+ *
+ * The tick interrupt comes every portTICK_PERIOD_MS as the watchdog's does.
+ * Other interrupts are simulated by handlers attached with
+ * xSimAttachInterrupt(), which fire at pseudo random intervals drawn from the
+ * seed.  Handlers run with interrupts masked and may use the FromISR API.
+ * Interrupts only land where a task spends time, or calls into the kernel, so
+ * with the same seed every run interleaves them with the tasks in exactly the
+ * same way, and schedules the tasks identically.  Every context switch is
+ * folded into a hash that can be compared between runs, and can be written to
+ * a trace file.
+ *
+ * A task that spins without calling the kernel or the Arduino shim stops the
+ * clock, and with it the simulation.  Tasks run on host stacks, so the stack
+ * each one was given is never touched and its high water mark means nothing.
+ */
+
+#ifndef SIM_H
+#define SIM_H
+
+#ifndef INC_ARDUINO_FREERTOS_H
+    #error "include Arduino_FreeRTOS.h must appear in source files before include sim.h"
+#endif
+
+#include <stdio.h>
+
+#include "task.h"
+
+/* *INDENT-OFF* */
+#if defined( __cplusplus )
+    extern "C" {
+#endif
+/* *INDENT-ON* */
+
+/* The most interrupt handlers that can be attached. */
+#define simMAX_INTERRUPTS    8
+
+/* The most cores a partitioned system can have, one per bit of an affinity
+ * mask, and the mask that lets a task run on any of them. */
+#define simMAX_CORES         8
+#define simNO_AFFINITY       ( ( UBaseType_t ) 0xFF )
+
+/* A simulated interrupt service routine. */
+typedef void ( * SimInterruptHandler_t )( void );
+
+/**
+ * Seed the pseudo random number generators.  Call before attaching any
+ * interrupts.  The same seed always gives the same run.
+ *
+ * @param ulSeed Any value.
+ */
+void vSimSetSeed( uint32_t ulSeed );
+
+/**
+ * Set how much firmware time to simulate.  The scheduler stops, and
+ * vTaskStartScheduler() returns, once the clock reaches it.
+ *
+ * @param ullDurationUs Microseconds from the start of the simulation.
+ */
+void vSimSetDuration( uint64_t ullDurationUs );
+
+/**
+ * Write a line with the time and the task name to pxFile on every context
+ * switch.
+ *
+ * @param pxFile The file to write to, or NULL to stop tracing.
+ */
+void vSimSetTraceFile( FILE * pxFile );
+
+/**
+ * Attach a simulated interrupt.  The first one fires between ulMinGapUs and
+ * ulMaxGapUs after it is attached, and each after that the same distance after
+ * the one before, picked at random each time.
+ *
+ * @param pxHandler The interrupt service routine.
+ * @param ulMinGapUs The shortest gap between interrupts, at least 1.
+ * @param ulMaxGapUs The longest gap between interrupts.
+ *
+ * @return pdPASS, or pdFAIL if simMAX_INTERRUPTS handlers are attached already.
+ */
+BaseType_t xSimAttachInterrupt( SimInterruptHandler_t pxHandler,
+                                uint32_t ulMinGapUs,
+                                uint32_t ulMaxGapUs );
+
+/**
+ * @return A pseudo random number from the seeded generator, for interrupt
+ * handlers that simulate inputs.
+ */
+uint32_t ulSimRandom( void );
+
+/**
+ * @return The virtual time in microseconds since the simulation started.
+ */
+uint64_t ullSimGetTime( void );
+
+/**
+ * Spend ulMicroseconds of CPU time, the way a busy loop would.  Interrupts
+ * and preemption happen along the way, and the time the task is switched out
+ * for does not count.
+ *
+ * @param ulMicroseconds How long the calling code would run on the board.
+ */
+void vSimConsume( uint32_t ulMicroseconds );
+
+/**
+ * Make the next task to block, in vTaskDelay() or on a queue or semaphore,
+ * spend ulMicroseconds where the kernel blocks it, with the scheduler
+ * suspended, as it would if a long interrupt landed there.  The time is
+ * charged to the task, and the ticks that come in meanwhile are pended until
+ * the scheduler resumes.  For testing how the kernel handles those ticks.
+ *
+ * @param ulMicroseconds How long the next task to block stalls for.
+ */
+void vSimStallNextBlock( uint32_t ulMicroseconds );
+
+/**
+ * Busy wait until the virtual clock reaches ullTimeUs, the way polling
+ * micros() would.  Returns at once if it already has.
+ *
+ * @param ullTimeUs The time to wait for.
+ */
+void vSimWaitUntil( uint64_t ullTimeUs );
+
+/**
+ * Called from the idle hook.  If no task is ready, moves the clock on to the
+ * next tick or interrupt.  Longer idle periods are skipped by
+ * portSUPPRESS_TICKS_AND_SLEEP().
+ */
+void vSimIdle( void );
+
+/**
+ * Provided by the application, if it simulates any hardware.  xSimRun() calls
+ * it after the seed is set and before setup(), to attach interrupts and set
+ * the inputs' starting levels.
+ */
+void vApplicationSimSetupHook( void );
+
+/**
+ * Run the sketch: vApplicationSimSetupHook(), setup(), then the scheduler
+ * until the time is up or the firmware fails.  Implemented in
+ * sim_variant.cpp, along with a main() that calls it.
+ *
+ * The kernel can not be restarted, so this can only be called once.  To run
+ * the sketch again, load a fresh copy of it, as soak/sim_soak.c does.
+ *
+ * @return pdPASS, or pdFAIL if the firmware failed, see pcSimGetFailure().
+ */
+BaseType_t xSimRun( void );
+
+/**
+ * Stop the simulation because the firmware failed: an assertion, a hook such
+ * as the malloc failed hook, or a task returning.  The reason is kept for
+ * pcSimGetFailure() and the scheduler ends, so xSimRun() returns.  Before the
+ * scheduler starts there is nothing to return to, so the reason is printed
+ * and the process exits.
+ *
+ * @param pcFormat printf() style description of the failure.
+ */
+void vSimFail( const char * pcFormat,
+               ... ) __attribute__( ( noreturn, format( printf, 1, 2 ) ) );
+
+/**
+ * @return Why the simulation failed, starting with the time it failed at, or
+ * NULL if it has not.
+ */
+const char * pcSimGetFailure( void );
+
+/*-----------------------------------------------------------
+ * Partitioned multiprocessing.
+ *
+ * A system of several cores is simulated as one copy of the firmware image
+ * per core, each with a kernel of its own - its own current task, ready
+ * lists, tick and idle task - on a host thread of its own, as smp/ does.
+ * Every core runs the same setup(), and creates the tasks with
+ * xSimTaskCreateAffinitySet(), which places each task on exactly one core.
+ * The cores share no kernel data, so they need no lock between them, and each
+ * one is as deterministic as a single core simulation.  They can not
+ * communicate: a partitioned system suits tasks that are independent.
+ *----------------------------------------------------------*/
+
+/**
+ * Make this copy of the image one core of a partitioned system.  Call before
+ * xSimRun().  A simulation is core 0 of 1 unless this is called.
+ *
+ * @param uxCoreID This core, from 0.
+ * @param uxNumberOfCores How many cores the system has, at most simMAX_CORES.
+ */
+void vSimSetCore( UBaseType_t uxCoreID,
+                  UBaseType_t uxNumberOfCores );
+
+/**
+ * @return The core this copy of the image simulates.
+ */
+UBaseType_t uxSimGetCoreID( void );
+
+/**
+ * @return How many cores the system has.
+ */
+UBaseType_t uxSimGetNumberOfCores( void );
+
+/**
+ * Create a task on one of the cores in uxCoreAffinityMask, the one with the
+ * fewest tasks placed on it so far, or the lowest numbered of those.  Every
+ * core makes the same calls in the same order, so they all agree where each
+ * task goes, and only that core creates it.
+ *
+ * Takes the same parameters as xTaskCreate(), and:
+ *
+ * @param uxCoreAffinityMask Bit n set if the task may run on core n, or
+ * simNO_AFFINITY.
+ *
+ * @return pdPASS if the task was placed, and created if it is on this core.
+ * *pxCreatedTask is only set on the core the task is on, and NULL on the
+ * others.
+ */
+BaseType_t xSimTaskCreateAffinitySet( TaskFunction_t pxTaskCode,
+                                      const char * const pcName,
+                                      const configSTACK_DEPTH_TYPE usStackDepth,
+                                      void * const pvParameters,
+                                      UBaseType_t uxPriority,
+                                      UBaseType_t uxCoreAffinityMask,
+                                      TaskHandle_t * const pxCreatedTask );
+
+/**
+ * @return pdTRUE once the simulation has run for its duration.
+ */
+BaseType_t xSimIsFinished( void );
+
+/**
+ * @return The number of context switches so far.
+ */
+uint32_t ulSimGetContextSwitches( void );
+
+/**
+ * @return A hash of the time and the task switched to for every context switch
+ * so far.  Two runs scheduled the same way if their hashes match.
+ */
+uint32_t ulSimGetTraceHash( void );
+
+/*-----------------------------------------------------------
+ * Inputs and outputs of the Arduino shim, for interrupt handlers that simulate
+ * the hardware around the sketch.  Implemented in arduino/arduino.cpp.
+ *----------------------------------------------------------*/
+
+/**
+ * Drive a digital input pin, as seen by digitalRead().
+ */
+void vSimSetDigitalInput( uint8_t ucPin,
+                          uint8_t ucLevel );
+
+/**
+ * Set the voltage on an analog pin, as a reading between 0 and 1023.
+ */
+void vSimSetAnalogInput( uint8_t ucPin,
+                         uint16_t usValue );
+
+/**
+ * @return The level last written to a pin with digitalWrite().
+ */
+uint8_t ucSimGetDigitalOutput( uint8_t ucPin );
+
+/**
+ * Turn the rotary encoder on ucPin1 by lSteps.  The Encoder library counts
+ * four steps per detent.
+ */
+void vSimTurnEncoder( uint8_t ucPin1,
+                      long lSteps );
+
+/**
+ * Stop or start copying serial output to stdout.  The serial port takes the
+ * same time either way.
+ */
+void vSimSetSerialQuiet( BaseType_t xQuiet );
+
+/* *INDENT-OFF* */
+#if defined( __cplusplus )
+    }
+#endif
+/* *INDENT-ON* */
+
+#endif /* SIM_H */
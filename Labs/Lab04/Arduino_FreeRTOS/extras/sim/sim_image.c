@@ -0,0 +1,90 @@
+/**
+ * @file sim_image.c
+ * @brief Loading private copies of a simulator firmware image, see sim_image.h.
+ */
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "sim_image.h"
+
+const char *simImageDefaultPath(const char *name) {
+  static char path[PATH_MAX];
+  ssize_t n = readlink("/proc/self/exe", path, sizeof(path) - strlen(name) - 1);
+  if (n <= 0) {
+    return name;
+  }
+  path[n] = '\0';
+  char *slash = strrchr(path, '/');
+  strcpy(slash != NULL ? slash + 1 : path, name);
+  return path;
+}
+
+int simImageCopy(const char *path, char *copyPath) {
+  const char *dir = getenv("TMPDIR");
+  char buf[65536];
+  ssize_t n;
+
+  snprintf(copyPath, PATH_MAX, "%s/sim_image.XXXXXX", dir != NULL ? dir : "/tmp");
+  int out = mkstemp(copyPath);
+  if (out < 0) {
+    perror(copyPath);
+    return -1;
+  }
+  int in = open(path, O_RDONLY);
+  if (in < 0) {
+    perror(path);
+    close(out);
+    unlink(copyPath);
+    return -1;
+  }
+
+  while ((n = read(in, buf, sizeof(buf))) > 0) {
+    if (write(out, buf, (size_t) n) != n) {
+      n = -1;
+      break;
+    }
+  }
+  close(in);
+  if (close(out) != 0 || n < 0) {
+    perror(copyPath);
+    unlink(copyPath);
+    return -1;
+  }
+  return 0;
+}
+
+int simImageOpen(const char *copyPath, SimImage *image) {
+  // RTLD_LOCAL keeps the copies from binding to each other's globals.
+  image->handle = dlopen(copyPath, RTLD_NOW | RTLD_LOCAL);
+  if (image->handle == NULL) {
+    fprintf(stderr, "%s\n", dlerror());
+    return -1;
+  }
+
+  *(void **) &image->setSeed = dlsym(image->handle, "vSimSetSeed");
+  *(void **) &image->setDuration = dlsym(image->handle, "vSimSetDuration");
+  *(void **) &image->setSerialQuiet = dlsym(image->handle, "vSimSetSerialQuiet");
+  *(void **) &image->setCore = dlsym(image->handle, "vSimSetCore");
+  *(void **) &image->run = dlsym(image->handle, "xSimRun");
+  *(void **) &image->getContextSwitches = dlsym(image->handle, "ulSimGetContextSwitches");
+  *(void **) &image->getTraceHash = dlsym(image->handle, "ulSimGetTraceHash");
+  *(void **) &image->getFailure = dlsym(image->handle, "pcSimGetFailure");
+
+  if (image->setSeed == NULL || image->setDuration == NULL || image->setSerialQuiet == NULL ||
+      image->setCore == NULL || image->run == NULL || image->getContextSwitches == NULL ||
+      image->getTraceHash == NULL || image->getFailure == NULL) {
+    fprintf(stderr, "%s is not a simulator image\n", copyPath);
+    simImageClose(image);
+    return -1;
+  }
+  return 0;
+}
+
+void simImageClose(SimImage *image) {
+  dlclose(image->handle);
+  image->handle = NULL;
+}
@@ -0,0 +1,59 @@
+/**
+ * @file sim_image.h
+ * @brief Loading private copies of a simulator firmware image, for host tools.
+ *
+ * A firmware image is a sketch, the kernel and the simulator linked into one shared module,
+ * such as scoreboard_sim_image. The kernel and the sketch keep their state in globals, so to
+ * run several instances of a sketch in one process every instance needs its own copy of the
+ * image: the loader only loads a file once, so each copy is a file of its own, and loading it
+ * afresh gives the instance a clean set of globals.
+ */
+#ifndef SIM_IMAGE_H
+#define SIM_IMAGE_H
+
+#include <limits.h>
+
+#include "Arduino_FreeRTOS.h"
+#include "sim.h"
+
+// A loaded copy of an image, and the simulator's entry points in it.
+typedef struct {
+  void *handle;
+  __typeof__(&vSimSetSeed) setSeed;
+  __typeof__(&vSimSetDuration) setDuration;
+  __typeof__(&vSimSetSerialQuiet) setSerialQuiet;
+  __typeof__(&vSimSetCore) setCore;
+  __typeof__(&xSimRun) run;
+  __typeof__(&ulSimGetContextSwitches) getContextSwitches;
+  __typeof__(&ulSimGetTraceHash) getTraceHash;
+  __typeof__(&pcSimGetFailure) getFailure;
+} SimImage;
+
+/**
+ * @brief Returns the path of the image called name in the directory of the running executable.
+ */
+const char *simImageDefaultPath(const char *name);
+
+/**
+ * @brief Copies an image to a new temporary file, in $TMPDIR or /tmp.
+ *
+ * @param path The image to copy.
+ * @param copyPath Set to the path of the copy. PATH_MAX bytes long.
+ *
+ * @return 0, or -1 with the reason printed.
+ */
+int simImageCopy(const char *path, char *copyPath);
+
+/**
+ * @brief Loads a copy of an image, with its globals as they are before the sketch starts.
+ *
+ * @return 0, or -1 with the reason printed.
+ */
+int simImageOpen(const char *copyPath, SimImage *image);
+
+/**
+ * @brief Unloads a copy of an image, throwing its globals away.
+ */
+void simImageClose(SimImage *image);
+
+#endif
@@ -0,0 +1,218 @@
+/*
+ * The host simulator's counterpart of variantHooks.cpp: xSimRun(), which does
+ * what initVariant() does on the board, a main() to call it, and the
+ * application hooks.
+ *
+ * Usage: <sketch>_sim [-s seed] [-d seconds] [-t trace file] [-q]
+ *
+ *   -s  seed for the simulated interrupts, 1 by default
+ *   -d  seconds of firmware time to run for, an hour by default
+ *   -t  write the time and task of every context switch to a file
+ *   -q  do not copy the serial port to stdout
+ *
+ * When the time is up main() prints the firmware time, the time it took, the
+ * number of context switches and their hash to stderr. Runs with the same seed
+ * print the same hash. If the firmware fails it prints why instead, and exits
+ * with status 1.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <Arduino.h>
+
+#include "Arduino_FreeRTOS.h"
+#include "task.h"
+#include "sim.h"
+
+#define DEFAULT_SECONDS 3600UL
+
+static double nowSeconds(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double) ts.tv_sec + (double) ts.tv_nsec / 1e9;
+}
+
+int main(int argc, char **argv) {
+  unsigned long seed = 1;
+  unsigned long seconds = DEFAULT_SECONDS;
+  FILE *trace = NULL;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "s:d:t:q")) != -1) {
+    switch (opt) {
+      case 's':
+        seed = strtoul(optarg, NULL, 0);
+        break;
+      case 'd':
+        seconds = strtoul(optarg, NULL, 0);
+        break;
+      case 't':
+        trace = fopen(optarg, "w");
+        if (trace == NULL) {
+          perror(optarg);
+          return 2;
+        }
+        break;
+      case 'q':
+        vSimSetSerialQuiet(pdTRUE);
+        break;
+      default:
+        fprintf(stderr, "usage: %s [-s seed] [-d seconds] [-t trace file] [-q]\n", argv[0]);
+        return 2;
+    }
+  }
+
+  vSimSetSeed((uint32_t) seed);
+  vSimSetDuration((uint64_t) seconds * 1000000U);
+  vSimSetTraceFile(trace);
+
+  double start = nowSeconds();
+  BaseType_t passed = xSimRun();
+
+  fflush(stdout);
+  if (passed == pdPASS) {
+    uint64_t us = ullSimGetTime();
+    fprintf(stderr, "sim: %llu.%06llu s of firmware time in %.2f s, %lu context switches, hash %08lx\n",
+            (unsigned long long) (us / 1000000U), (unsigned long long) (us % 1000000U), nowSeconds() - start,
+            (unsigned long) ulSimGetContextSwitches(), (unsigned long) ulSimGetTraceHash());
+  } else {
+    fprintf(stderr, "sim: %s\n", pcSimGetFailure());
+  }
+
+  if (trace != NULL) {
+    fclose(trace);
+  }
+  return passed == pdPASS ? 0 : 1;
+}
+
+BaseType_t xSimRun( void )
+{
+    static BaseType_t xStarted = pdFALSE;
+
+    if( xStarted != pdFALSE )
+    {
+        vSimFail( "xSimRun() called twice, the kernel can not be restarted" );
+    }
+    xStarted = pdTRUE;
+
+    vApplicationSimSetupHook();
+    setup();                    // the normal Arduino setup() function is run here.
+    if( xSimIsFinished() == pdFALSE )
+    {
+        vTaskStartScheduler();  // unless setup() already started the scheduler, and the run is over.
+    }
+
+    return ( pcSimGetFailure() == NULL ) ? pdPASS : pdFAIL;
+}
+
+void vApplicationSimSetupHook( void ) __attribute__((weak));
+
+void vApplicationSimSetupHook( void )
+{
+    // No simulated hardware; the sketch only gets the tick.
+}
+
+#if ( configUSE_IDLE_HOOK == 1 )
+
+void vApplicationIdleHook( void ) __attribute__((weak));
+
+void vApplicationIdleHook( void )
+{
+    loop();                     // the normal Arduino loop() function is run here.
+
+    // There is no sleep instruction to simulate, so rather than vIdlePowerEnter()
+    // just let the time pass. idle_power.h reports no sleep here.
+    vSimIdle();
+}
+
+#else
+    #error configUSE_IDLE_HOOK must be set to 1 to use extras/sim, vSimIdle() moves the clock on.
+#endif /* configUSE_IDLE_HOOK == 1 */
+
+#if ( configUSE_MALLOC_FAILED_HOOK == 1 )
+
+void vApplicationMallocFailedHook( void ) __attribute__((weak));
+
+void vApplicationMallocFailedHook( void )
+{
+    vSimFail( "malloc failed" );
+}
+
+#endif /* configUSE_MALLOC_FAILED_HOOK == 1 */
+
+#if ( configCHECK_FOR_STACK_OVERFLOW >= 1 )
+
+void vApplicationStackOverflowHook( TaskHandle_t xTask,
+                                    char * pcTaskName ) __attribute__((weak));
+
+void vApplicationStackOverflowHook( TaskHandle_t xTask __attribute__((unused)),
+                                    char * pcTaskName )
+{
+    vSimFail( "stack overflow in %s", pcTaskName );
+}
+
+#endif /* configCHECK_FOR_STACK_OVERFLOW >= 1 */
+
+#if ( configUSE_TASK_BUDGETS == 1 )
+
+void vApplicationBudgetOverrunHook( TaskHandle_t xTask,
+                                    char * pcTaskName ) __attribute__((weak));
+
+void vApplicationBudgetOverrunHook( TaskHandle_t xTask __attribute__((unused)),
+                                    char * pcTaskName __attribute__((unused)) )
+{
+    // Called from the tick interrupt. The overrun is already counted against the task,
+    // so by default there is nothing more to do. Read it with usTaskGetBudgetOverruns().
+}
+
+#endif /* configUSE_TASK_BUDGETS == 1 */
+
+#if ( configSUPPORT_STATIC_ALLOCATION >= 1 )
+
+void vApplicationGetIdleTaskMemory( StaticTask_t ** ppxIdleTaskTCBBuffer,
+                                    StackType_t ** ppxIdleTaskStackBuffer,
+                                    configSTACK_DEPTH_TYPE * pulIdleTaskStackSize ) __attribute__((weak));
+
+void vApplicationGetIdleTaskMemory( StaticTask_t ** ppxIdleTaskTCBBuffer,
+                                    StackType_t ** ppxIdleTaskStackBuffer,
+                                    configSTACK_DEPTH_TYPE * pulIdleTaskStackSize )
+{
+    static StaticTask_t xIdleTaskTCB;
+    static StackType_t uxIdleTaskStack[ configMINIMAL_STACK_SIZE ];
+
+    *ppxIdleTaskTCBBuffer = &xIdleTaskTCB;
+    *ppxIdleTaskStackBuffer = uxIdleTaskStack;
+    *pulIdleTaskStackSize = configMINIMAL_STACK_SIZE;
+}
+
+#if ( configUSE_TIMERS >= 1 )
+
+void vApplicationGetTimerTaskMemory( StaticTask_t ** ppxTimerTaskTCBBuffer,
+                                     StackType_t ** ppxTimerTaskStackBuffer,
+                                     configSTACK_DEPTH_TYPE * pulTimerTaskStackSize ) __attribute__((weak));
+
+void vApplicationGetTimerTaskMemory( StaticTask_t ** ppxTimerTaskTCBBuffer,
+                                     StackType_t ** ppxTimerTaskStackBuffer,
+                                     configSTACK_DEPTH_TYPE * pulTimerTaskStackSize )
+{
+    static StaticTask_t xTimerTaskTCB;
+    static StackType_t uxTimerTaskStack[ configTIMER_TASK_STACK_DEPTH ];
+
+    *ppxTimerTaskTCBBuffer = &xTimerTaskTCB;
+    *ppxTimerTaskStackBuffer = uxTimerTaskStack;
+    *pulTimerTaskStackSize = configTIMER_TASK_STACK_DEPTH;
+}
+
+#endif /* configUSE_TIMERS >= 1 */
+
+#endif /* configSUPPORT_STATIC_ALLOCATION >= 1 */
+
+#if configDEFAULT_ASSERT == 1
+
+void vApplicationAssertHook() {
+    vSimFail( "assertion failed" );
+}
+
+#endif
@@ -0,0 +1,108 @@
+/**
+ * @file fft_bench.cpp
+ * @brief Independent FFT tasks, the firmware that fft_smp_bench runs on 1 to N cores.
+ *
+ * setup() creates NTASKS tasks that may run on any core, so they are spread evenly over the
+ * cores of the system. Each one runs the 512 point FFT of lab_4.1 over and over on a frame of
+ * its own, and counts how many it has finished. The FFT really is computed, on the host, and
+ * every stage also charges the virtual clock what its butterflies cost in soft float on the
+ * ATmega2560, so each core gets through about as many FFTs per firmware second as a board
+ * would.
+ */
+#include <Arduino.h>
+#include <Arduino_FreeRTOS.h>
+#include <task.h>
+
+#include "sim.h"
+
+#define NTASKS 8
+#define NSAMPLES 512
+#define BUTTERFLY_US 80UL // a complex multiply and two complex adds at about 1200 cycles
+
+static uint32_t completed[NTASKS];
+
+extern "C" uint32_t ulFftBenchGetCompleted(void);
+
+/**
+ * @brief Transforms re and im in place with an iterative radix 2 FFT.
+ */
+static void fft(double *re, double *im) {
+  // put the samples in bit reversed order
+  for (int i = 1, j = 0; i < NSAMPLES; i++) {
+    int bit = NSAMPLES >> 1;
+    for (; j & bit; bit >>= 1) {
+      j ^= bit;
+    }
+    j ^= bit;
+    if (i < j) {
+      double t = re[i];
+      re[i] = re[j];
+      re[j] = t;
+      t = im[i];
+      im[i] = im[j];
+      im[j] = t;
+    }
+  }
+
+  for (int len = 2; len <= NSAMPLES; len <<= 1) {
+    double angle = -2.0 * M_PI / len;
+    double stepRe = cos(angle);
+    double stepIm = sin(angle);
+    for (int i = 0; i < NSAMPLES; i += len) {
+      double wRe = 1.0;
+      double wIm = 0.0;
+      for (int j = 0; j < len / 2; j++) {
+        int a = i + j;
+        int b = a + len / 2;
+        double tRe = re[b] * wRe - im[b] * wIm;
+        double tIm = re[b] * wIm + im[b] * wRe;
+        re[b] = re[a] - tRe;
+        im[b] = im[a] - tIm;
+        re[a] += tRe;
+        im[a] += tIm;
+        double nextRe = wRe * stepRe - wIm * stepIm;
+        wIm = wRe * stepIm + wIm * stepRe;
+        wRe = nextRe;
+      }
+    }
+    vSimConsume((NSAMPLES / 2) * BUTTERFLY_US);
+  }
+}
+
+void TaskFFT(void *pvParameters) {
+  int id = (int) (uintptr_t) pvParameters;
+  double vReal[NSAMPLES];
+  double vImag[NSAMPLES];
+
+  for (;;) {
+    // a different frame of 8-bit samples for every task, as lab_4.1's random ones
+    for (int j = 0; j < NSAMPLES; j++) {
+      vReal[j] = (double) ((j * (id + 3)) % 200 - 100);
+      vImag[j] = 0.0;
+    }
+    fft(vReal, vImag);
+    completed[id]++;
+  }
+}
+
+void setup() {
+  for (int i = 0; i < NTASKS; i++) {
+    xSimTaskCreateAffinitySet(TaskFFT, "FFT", 128, (void *) (uintptr_t) i, 1, simNO_AFFINITY, NULL);
+  }
+}
+
+void loop()
+{
+  // Empty. Things are done in Tasks.
+}
+
+/**
+ * @brief Returns how many FFTs the tasks on this core have finished.
+ */
+uint32_t ulFftBenchGetCompleted(void) {
+  uint32_t total = 0;
+  for (int i = 0; i < NTASKS; i++) {
+    total += completed[i];
+  }
+  return total;
+}
@@ -0,0 +1,143 @@
+/**
+ * @file fft_smp_bench.c
+ * @brief Throughput of independent FFT tasks on a simulated partitioned system of 1 to N cores.
+ *
+ * Runs the firmware in fft_bench.cpp - 8 tasks each doing 512 point FFTs - on 1, 2, ... N
+ * cores, see "Partitioned multiprocessing" in sim.h. Every core is a copy of the
+ * fft_bench_image module on a host thread of its own. Each row prints:
+ *  - ffts: how many FFTs the cores finished between them in the firmware time.
+ *  - per_fw_s: the same per second of firmware time, which is what the simulated system does.
+ *  - wall_s: how long the host took to simulate it.
+ *  - per_wall_s and speedup: FFTs per second of host time, and that over the 1 core row. This
+ *    only scales as far as the host has cores to run the core threads on.
+ *
+ * Usage: fft_smp_bench [-c cores] [-d seconds] [image]
+ *
+ *   -c  the most cores to try, 8 by default
+ *   -d  seconds of firmware time per run, an hour by default
+ */
+#include <dlfcn.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "sim_image.h"
+
+#define DEFAULT_SECONDS 3600UL
+#define IMAGE_NAME "fft_bench_image.so"
+
+typedef struct {
+  char copyPath[PATH_MAX];
+  UBaseType_t core;
+  UBaseType_t cores;
+  uint32_t completed;
+} Core;
+
+static unsigned long seconds = DEFAULT_SECONDS;
+
+/**
+ * @brief Returns a monotonic time stamp in seconds.
+ */
+static double nowSeconds(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double) ts.tv_sec + (double) ts.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Runs one core of the system on a fresh load of its copy of the image.
+ */
+static void *runCore(void *arg) {
+  Core *core = arg;
+  SimImage image;
+  uint32_t (*getCompleted)(void);
+
+  if (simImageOpen(core->copyPath, &image) != 0) {
+    exit(2);
+  }
+  *(void **) &getCompleted = dlsym(image.handle, "ulFftBenchGetCompleted");
+  if (getCompleted == NULL) {
+    fprintf(stderr, "fft_smp_bench: %s is not the FFT benchmark\n", core->copyPath);
+    exit(2);
+  }
+
+  image.setSeed(1);
+  image.setDuration((uint64_t) seconds * 1000000U);
+  image.setSerialQuiet(pdTRUE);
+  image.setCore(core->core, core->cores);
+  if (image.run() != pdPASS) {
+    fprintf(stderr, "fft_smp_bench: core %u: %s\n", (unsigned) core->core, image.getFailure());
+    exit(1);
+  }
+  core->completed = getCompleted();
+
+  simImageClose(&image);
+  return NULL;
+}
+
+int main(int argc, char **argv) {
+  long maxCores = simMAX_CORES;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "c:d:")) != -1) {
+    switch (opt) {
+      case 'c':
+        maxCores = strtol(optarg, NULL, 0);
+        break;
+      case 'd':
+        seconds = strtoul(optarg, NULL, 0);
+        break;
+      default:
+        maxCores = 0;
+        break;
+    }
+  }
+  if (maxCores <= 0 || maxCores > simMAX_CORES || seconds == 0 || optind + 1 < argc) {
+    fprintf(stderr, "usage: %s [-c cores, 1 to %d] [-d seconds] [image]\n", argv[0], simMAX_CORES);
+    return 2;
+  }
+  const char *imagePath = optind < argc ? argv[optind] : simImageDefaultPath(IMAGE_NAME);
+
+  Core cores[simMAX_CORES];
+  pthread_t threads[simMAX_CORES];
+  for (long c = 0; c < maxCores; c++) {
+    if (simImageCopy(imagePath, cores[c].copyPath) != 0) {
+      return 2;
+    }
+  }
+
+  double baseline = 0.0;
+  printf("%-6s %10s %10s %10s %12s %8s\n", "cores", "ffts", "per_fw_s", "wall_s", "per_wall_s", "speedup");
+  for (long n = 1; n <= maxCores; n++) {
+    double start = nowSeconds();
+    for (long c = 0; c < n; c++) {
+      cores[c].core = (UBaseType_t) c;
+      cores[c].cores = (UBaseType_t) n;
+      if (pthread_create(&threads[c], NULL, runCore, &cores[c]) != 0) {
+        perror("pthread_create");
+        return 2;
+      }
+    }
+    unsigned long ffts = 0;
+    for (long c = 0; c < n; c++) {
+      pthread_join(threads[c], NULL);
+      ffts += cores[c].completed;
+    }
+    double wall = nowSeconds() - start;
+
+    double perWall = (double) ffts / wall;
+    if (n == 1) {
+      baseline = perWall;
+    }
+    printf("%-6ld %10lu %10.2f %10.2f %12.0f %8.2f\n", n, ffts, (double) ffts / (double) seconds, wall, perWall,
+           perWall / baseline);
+    fflush(stdout);
+  }
+
+  for (long c = 0; c < maxCores; c++) {
+    unlink(cores[c].copyPath);
+  }
+  return 0;
+}
@@ -0,0 +1,167 @@
+/**
+ * @file sim_soak.c
+ * @brief Runs many simulated firmware instances in parallel, for soak and regression testing.
+ *
+ * Each instance is the simulator of sim.h running one sketch with a seed of its own. The kernel
+ * and the sketch keep their state in globals, as they do on the board, so instances can not
+ * share them. Instead every worker thread loads a private copy of the firmware image - the
+ * scoreboard_sim_image module that CMake builds next to this tool - and loads it afresh for
+ * each instance, which gives every instance a clean set of globals without the kernel having
+ * to know, see sim_image.h. Workers take the next seed as they finish, so all cores stay busy.
+ *
+ * Usage: sim_soak [-n instances] [-j threads] [-d seconds] [-s first seed] [image]
+ *
+ *   -n  how many instances to run, 200 by default
+ *   -j  how many worker threads, one per core by default
+ *   -d  seconds of firmware time per instance, 600 by default
+ *   -s  the first seed; instance i runs with seed + i, 1 by default
+ *
+ * Prints a line per instance, in seed order: the seed, the context switch count and hash, and
+ * "ok" or why the firmware failed. The output depends only on the options, never on the
+ * number of threads, so two builds can be compared with diff. A summary goes to stderr, and
+ * the exit status is 1 if any instance failed.
+ */
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "sim_image.h"
+
+#define DEFAULT_INSTANCES 200L
+#define DEFAULT_SECONDS 600UL
+#define IMAGE_NAME "scoreboard_sim_image.so"
+#define REASON_LENGTH 128
+
+typedef struct {
+  uint32_t seed;
+  uint32_t switches;
+  uint32_t hash;
+  int failed;
+  char reason[REASON_LENGTH];
+} InstanceResult;
+
+static const char *imagePath;
+static long instances = DEFAULT_INSTANCES;
+static unsigned long seconds = DEFAULT_SECONDS;
+static uint32_t firstSeed = 1;
+
+static InstanceResult *results;
+static atomic_long nextInstance;
+
+/**
+ * @brief Returns a monotonic time stamp in seconds.
+ */
+static double nowSeconds(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double) ts.tv_sec + (double) ts.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Runs instances on a private copy of the image until there are none left.
+ */
+static void *worker(void *arg) {
+  char copyPath[PATH_MAX];
+  (void) arg;
+
+  if (simImageCopy(imagePath, copyPath) != 0) {
+    exit(2);
+  }
+
+  for (long i = atomic_fetch_add(&nextInstance, 1); i < instances; i = atomic_fetch_add(&nextInstance, 1)) {
+    InstanceResult *result = &results[i];
+    SimImage image;
+
+    if (simImageOpen(copyPath, &image) != 0) {
+      exit(2);
+    }
+
+    result->seed = firstSeed + (uint32_t) i;
+    image.setSeed(result->seed);
+    image.setDuration((uint64_t) seconds * 1000000U);
+    image.setSerialQuiet(pdTRUE);
+    result->failed = image.run() != pdPASS;
+    result->switches = image.getContextSwitches();
+    result->hash = image.getTraceHash();
+    if (result->failed) {
+      snprintf(result->reason, sizeof(result->reason), "%s", image.getFailure());
+    }
+
+    // Unloading throws the instance's globals away, so the next one starts from scratch.
+    simImageClose(&image);
+  }
+
+  unlink(copyPath);
+  return NULL;
+}
+
+int main(int argc, char **argv) {
+  long threads = sysconf(_SC_NPROCESSORS_ONLN);
+  int opt;
+
+  while ((opt = getopt(argc, argv, "n:j:d:s:")) != -1) {
+    switch (opt) {
+      case 'n':
+        instances = strtol(optarg, NULL, 0);
+        break;
+      case 'j':
+        threads = strtol(optarg, NULL, 0);
+        break;
+      case 'd':
+        seconds = strtoul(optarg, NULL, 0);
+        break;
+      case 's':
+        firstSeed = (uint32_t) strtoul(optarg, NULL, 0);
+        break;
+      default:
+        instances = 0;
+        break;
+    }
+  }
+  if (instances <= 0 || threads <= 0 || optind + 1 < argc) {
+    fprintf(stderr, "usage: %s [-n instances] [-j threads] [-d seconds] [-s first seed] [image]\n", argv[0]);
+    return 2;
+  }
+  imagePath = optind < argc ? argv[optind] : simImageDefaultPath(IMAGE_NAME);
+  if (threads > instances) {
+    threads = instances;
+  }
+
+  results = calloc((size_t) instances, sizeof(InstanceResult));
+  pthread_t *pool = calloc((size_t) threads, sizeof(pthread_t));
+  if (results == NULL || pool == NULL) {
+    perror("sim_soak");
+    return 2;
+  }
+
+  double start = nowSeconds();
+  for (long t = 0; t < threads; t++) {
+    if (pthread_create(&pool[t], NULL, worker, NULL) != 0) {
+      perror("pthread_create");
+      return 2;
+    }
+  }
+  for (long t = 0; t < threads; t++) {
+    pthread_join(pool[t], NULL);
+  }
+  double elapsed = nowSeconds() - start;
+
+  long failures = 0;
+  printf("seed\tswitches\thash\tresult\n");
+  for (long i = 0; i < instances; i++) {
+    printf("%lu\t%lu\t%08lx\t%s\n", (unsigned long) results[i].seed, (unsigned long) results[i].switches,
+           (unsigned long) results[i].hash, results[i].failed ? results[i].reason : "ok");
+    failures += results[i].failed;
+  }
+
+  double firmwareSeconds = (double) instances * (double) seconds;
+  fprintf(stderr, "sim_soak: %ld instances, %ld failed, %.0f s of firmware time in %.2f s on %ld threads (%.0fx real time)\n",
+          instances, failures, firmwareSeconds, elapsed, threads, firmwareSeconds / elapsed);
+
+  free(pool);
+  free(results);
+  return failures == 0 ? 0 : 1;
+}
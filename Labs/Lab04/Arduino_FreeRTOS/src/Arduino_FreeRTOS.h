@@ -858,6 +858,22 @@
     #define configUSE_POSIX_ERRNO    0
 #endif
 
+#ifndef configUSE_TASK_BUDGETS
+    #define configUSE_TASK_BUDGETS    0
+#endif
+
+#ifndef configUSE_MUTEX_HOLD_TIMES
+    #define configUSE_MUTEX_HOLD_TIMES    0
+#endif
+
+#ifndef configUSE_RAM_ACCOUNTING
+    #define configUSE_RAM_ACCOUNTING    0
+#endif
+
+#ifndef configUSE_IDLE_POWER
+    #define configUSE_IDLE_POWER    0
+#endif
+
 #ifndef portTICK_TYPE_IS_ATOMIC
     #define portTICK_TYPE_IS_ATOMIC    0
 #endif
@@ -1185,6 +1201,11 @@ typedef struct xSTATIC_TCB
     #if ( configUSE_POSIX_ERRNO == 1 )
         int iDummy22;
     #endif
+    #if ( configUSE_TASK_BUDGETS == 1 )
+        uint32_t ulDummy23[ 2 ];
+        TickType_t xDummy24[ 2 ];
+        uint16_t usDummy25;
+    #endif
 } StaticTask_t;
 
 /*
@@ -1213,7 +1234,7 @@ typedef struct xSTATIC_QUEUE
 
     StaticList_t xDummy3[ 2 ];
     UBaseType_t uxDummy4[ 3 ];
-    uint8_t ucDummy5[ 2 ];
+    uint8_t ucDummy5[ 3 ];
 
     #if ( ( configSUPPORT_STATIC_ALLOCATION == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
         uint8_t ucDummy6;
@@ -1227,6 +1248,14 @@ typedef struct xSTATIC_QUEUE
         UBaseType_t uxDummy8;
         uint8_t ucDummy9;
     #endif
+
+    #if ( ( configUSE_MUTEXES == 1 ) && ( configUSE_MUTEX_HOLD_TIMES == 1 ) )
+        uint32_t ulDummy10[ 2 ];
+    #endif
+
+    #if ( configUSE_RAM_ACCOUNTING == 1 )
+        UBaseType_t uxDummy11;
+    #endif
 } StaticQueue_t;
 typedef StaticQueue_t StaticSemaphore_t;
 
@@ -1256,6 +1285,10 @@ typedef struct xSTATIC_EVENT_GROUP
     #if ( ( configSUPPORT_STATIC_ALLOCATION == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
         uint8_t ucDummy4;
     #endif
+
+    #if ( configUSE_RAM_ACCOUNTING == 1 )
+        UBaseType_t uxDummy5;
+    #endif
 } StaticEventGroup_t;
 
 /*
@@ -1283,6 +1316,9 @@ typedef struct xSTATIC_TIMER
         UBaseType_t uxDummy7;
     #endif
     uint8_t ucDummy8;
+    #if ( configUSE_RAM_ACCOUNTING == 1 )
+        UBaseType_t uxDummy9;
+    #endif
 } StaticTimer_t;
 
 /*
@@ -1307,6 +1343,9 @@ typedef struct xSTATIC_STREAM_BUFFER
     #if ( configUSE_TRACE_FACILITY == 1 )
         UBaseType_t uxDummy4;
     #endif
+    #if ( configUSE_RAM_ACCOUNTING == 1 )
+        UBaseType_t uxDummy5;
+    #endif
 } StaticStreamBuffer_t;
 
 /* Message buffers are built on stream buffers. */
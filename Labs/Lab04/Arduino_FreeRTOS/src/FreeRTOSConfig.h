@@ -58,8 +58,9 @@
 
 #define configQUEUE_REGISTRY_SIZE           0
 #define configCHECK_FOR_STACK_OVERFLOW      1
+#define configRECORD_STACK_HIGH_ADDRESS     1 // lets stack_monitor.h report each task's stack depth.
 
-#define configUSE_TRACE_FACILITY            0
+#define configUSE_TRACE_FACILITY            1
 #define configUSE_16_BIT_TICKS              1
 
 #define configUSE_MUTEXES                   1
@@ -68,9 +69,27 @@
 #define configUSE_TIME_SLICING              1
 #define configUSE_QUEUE_SETS                0
 #define configUSE_MALLOC_FAILED_HOOK        1
+#define configUSE_MUTEX_HOLD_TIMES          1
+
+// The options below are off, so sketches that don't use them don't pay for them. A sketch that does is
+// built with them on, e.g. with --build-property "build.extra_flags=-DconfigUSE_TASK_BUDGETS=1" to arduino-cli.
+// Task budgets read the microsecond clock at every context switch, RAM accounting keeps a table of
+// owners and updates it every time a kernel object is created or deleted, and idle power sleeps after
+// every loop(), so loop() runs once per interrupt instead of over and over.
+#ifndef configUSE_TASK_BUDGETS
+    #define configUSE_TASK_BUDGETS          0
+#endif
+
+#ifndef configUSE_RAM_ACCOUNTING
+    #define configUSE_RAM_ACCOUNTING        0
+#endif
+
+#ifndef configUSE_IDLE_POWER
+    #define configUSE_IDLE_POWER            0
+#endif
 
 #define configSUPPORT_DYNAMIC_ALLOCATION    1
-#define configSUPPORT_STATIC_ALLOCATION     0
+#define configSUPPORT_STATIC_ALLOCATION     1
 
 /* Timer definitions. */
 #define configUSE_TIMERS                    1
@@ -85,8 +104,11 @@
 /* Set the stack depth type to be uint16_t. */
 #define configSTACK_DEPTH_TYPE              uint16_t
 
-/* Set the stack pointer type to be uint16_t, otherwise it defaults to unsigned long */
+/* Set the stack pointer type to be uint16_t, otherwise it defaults to unsigned long.
+   The host simulator in extras/sim sets its own, as its pointers are wider. */
+#ifdef __AVR__
 #define portPOINTER_SIZE_TYPE               uint16_t
+#endif
 
 /* Set the following definitions to 1 to include the API function, or zero
 to exclude the API function. */
@@ -99,10 +121,11 @@ to exclude the API function. */
 #define INCLUDE_vResumeFromISR                  1
 #define INCLUDE_xTaskDelayUntil                 1
 #define INCLUDE_vTaskDelay                      1
-#define INCLUDE_xTaskGetSchedulerState          0
+#define INCLUDE_xTaskGetSchedulerState          1
 #define INCLUDE_xTaskGetIdleTaskHandle          0 // create an idle task handle.
-#define INCLUDE_xTaskGetCurrentTaskHandle       0
+#define INCLUDE_xTaskGetCurrentTaskHandle       1
 #define INCLUDE_uxTaskGetStackHighWaterMark     1
+#define INCLUDE_xTimerPendFunctionCall          1
 
 #define configMAX(a,b)  ({ __typeof__ (a) _a = (a); __typeof__ (b) _b = (b); _a > _b ? _a : _b; })
 #define configMIN(a,b)  ({ __typeof__ (a) _a = (a); __typeof__ (b) _b = (b); _a < _b ? _a : _b; })
@@ -52,6 +52,14 @@ extern "C" {
 //    xxx Watchdog Timer is 128kHz nominal, but 120 kHz at 5V DC and 25 degrees is actually more accurate, from data sheet.
 #define configTICK_RATE_HZ      ( (TickType_t)( (uint32_t)128000 >> (portUSE_WDTO + 11) ) )  // 2^11 = 2048 WDT scaler for 128kHz Timer
 
+// Run time measurements - microseconds from the Arduino core's Timer0, which is always running.
+// The tick is far too coarse to time individual jobs, so use this wherever a time stamp is needed.
+unsigned long micros( void );
+
+#ifndef portGET_RUN_TIME_COUNTER_VALUE
+    #define portGET_RUN_TIME_COUNTER_VALUE()    ( (uint32_t) micros() )
+#endif
+
 /*-----------------------------------------------------------*/
 
 #ifndef INC_TASK_H
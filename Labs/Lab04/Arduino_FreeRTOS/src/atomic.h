@@ -28,21 +28,42 @@
  * @file atomic.h
  * @brief FreeRTOS atomic operation support.
  *
- * This file implements atomic functions by disabling interrupts globally.
- * Implementations with architecture specific atomic instructions can be
- * provided under each compiler directory.
+ * Three implementations are provided, chosen when the header is compiled:
+ *
+ *   + Host builds with GCC or Clang use the compiler's __atomic builtins,
+ *     which map to lock free instructions and are safe across cores.
+ *   + AVR builds mask interrupts around the operation by saving SREG, then
+ *     restoring it, in line.  This nests, and works from tasks and from
+ *     interrupts alike.
+ *   + Anything else falls back to portENTER_CRITICAL().
+ *
+ * The _u8 operations are for flags and counters that fit in a byte.  On AVR
+ * a byte load or store is a single instruction, so Atomic_Load_u8() and
+ * Atomic_Store_u8() never mask interrupts.  A byte read-modify-write still
+ * takes a load, an operation and a store, so the other _u8 operations do mask
+ * them, but they avoid the four byte arithmetic of the _u32 versions.
  */
 
 #ifndef ATOMIC_H
 #define ATOMIC_H
 
-#ifndef INC_FREERTOS_H
-    #error "include FreeRTOS.h must appear in source files before include atomic.h"
+#ifndef INC_ARDUINO_FREERTOS_H
+    #error "include Arduino_FreeRTOS.h must appear in source files before include atomic.h"
 #endif
 
 /* Standard includes. */
 #include <stdint.h>
 
+#if defined( __GNUC__ ) && !defined( __AVR__ )
+    #define atomicUSE_BUILTINS    1
+#else
+    #define atomicUSE_BUILTINS    0
+#endif
+
+#if defined( __AVR__ )
+    #include <avr/io.h>
+#endif
+
 /* *INDENT-OFF* */
 #ifdef __cplusplus
     extern "C" {
@@ -56,23 +77,33 @@
  * Every call to ATOMIC_EXIT_CRITICAL() must be closely paired with
  * ATOMIC_ENTER_CRITICAL().
  *
+ * AVR interrupts do not nest, so this port defines
+ * portSET_INTERRUPT_MASK_FROM_ISR() as 0 and it can not be used to protect
+ * task code.  Instead SREG, with its interrupt flag, is saved and restored
+ * directly - what portENTER_CRITICAL() does, without the stack push.
+ *
  */
-#if defined( portSET_INTERRUPT_MASK_FROM_ISR )
+#if ( atomicUSE_BUILTINS == 1 )
+
+/* Not needed, the builtins are atomic by themselves. */
+
+#elif defined( __AVR__ )
 
-/* Nested interrupt scheme is supported in this port. */
-    #define ATOMIC_ENTER_CRITICAL() \
-    UBaseType_t uxCriticalSectionType = portSET_INTERRUPT_MASK_FROM_ISR()
+    #define ATOMIC_ENTER_CRITICAL()                      \
+    const uint8_t ucAtomicSavedStatus = SREG;            \
+    __asm__ __volatile__ ( "cli" ::: "memory" )
 
-    #define ATOMIC_EXIT_CRITICAL() \
-    portCLEAR_INTERRUPT_MASK_FROM_ISR( uxCriticalSectionType )
+    #define ATOMIC_EXIT_CRITICAL()                       \
+    __asm__ __volatile__ ( "" ::: "memory" );            \
+    SREG = ucAtomicSavedStatus
 
 #else
 
-/* Nested interrupt scheme is NOT supported in this port. */
+/* No interrupt masking that can be used from tasks is known for this port. */
     #define ATOMIC_ENTER_CRITICAL()    portENTER_CRITICAL()
     #define ATOMIC_EXIT_CRITICAL()     portEXIT_CRITICAL()
 
-#endif /* portSET_INTERRUPT_MASK_FROM_ISR() */
+#endif /* atomicUSE_BUILTINS */
 
 /*
  * Port specific definition -- "always inline".
@@ -109,23 +140,28 @@ static portFORCE_INLINE uint32_t Atomic_CompareAndSwap_u32( uint32_t volatile *
                                                             uint32_t ulExchange,
                                                             uint32_t ulComparand )
 {
-    uint32_t ulReturnValue;
+    #if ( atomicUSE_BUILTINS == 1 )
+        return __atomic_compare_exchange_n( pulDestination, &ulComparand, ulExchange, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST ) ?
+               ATOMIC_COMPARE_AND_SWAP_SUCCESS : ATOMIC_COMPARE_AND_SWAP_FAILURE;
+    #else
+        uint32_t ulReturnValue;
 
-    ATOMIC_ENTER_CRITICAL();
-    {
-        if( *pulDestination == ulComparand )
-        {
-            *pulDestination = ulExchange;
-            ulReturnValue = ATOMIC_COMPARE_AND_SWAP_SUCCESS;
-        }
-        else
+        ATOMIC_ENTER_CRITICAL();
         {
-            ulReturnValue = ATOMIC_COMPARE_AND_SWAP_FAILURE;
+            if( *pulDestination == ulComparand )
+            {
+                *pulDestination = ulExchange;
+                ulReturnValue = ATOMIC_COMPARE_AND_SWAP_SUCCESS;
+            }
+            else
+            {
+                ulReturnValue = ATOMIC_COMPARE_AND_SWAP_FAILURE;
+            }
         }
-    }
-    ATOMIC_EXIT_CRITICAL();
+        ATOMIC_EXIT_CRITICAL();
 
-    return ulReturnValue;
+        return ulReturnValue;
+    #endif
 }
 /*-----------------------------------------------------------*/
 
@@ -144,16 +180,20 @@ static portFORCE_INLINE uint32_t Atomic_CompareAndSwap_u32( uint32_t volatile *
 static portFORCE_INLINE void * Atomic_SwapPointers_p32( void * volatile * ppvDestination,
                                                         void * pvExchange )
 {
-    void * pReturnValue;
+    #if ( atomicUSE_BUILTINS == 1 )
+        return __atomic_exchange_n( ppvDestination, pvExchange, __ATOMIC_SEQ_CST );
+    #else
+        void * pReturnValue;
 
-    ATOMIC_ENTER_CRITICAL();
-    {
-        pReturnValue = *ppvDestination;
-        *ppvDestination = pvExchange;
-    }
-    ATOMIC_EXIT_CRITICAL();
+        ATOMIC_ENTER_CRITICAL();
+        {
+            pReturnValue = *ppvDestination;
+            *ppvDestination = pvExchange;
+        }
+        ATOMIC_EXIT_CRITICAL();
 
-    return pReturnValue;
+        return pReturnValue;
+    #endif
 }
 /*-----------------------------------------------------------*/
 
@@ -177,19 +217,24 @@ static portFORCE_INLINE uint32_t Atomic_CompareAndSwapPointers_p32( void * volat
                                                                     void * pvExchange,
                                                                     void * pvComparand )
 {
-    uint32_t ulReturnValue = ATOMIC_COMPARE_AND_SWAP_FAILURE;
+    #if ( atomicUSE_BUILTINS == 1 )
+        return __atomic_compare_exchange_n( ppvDestination, &pvComparand, pvExchange, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST ) ?
+               ATOMIC_COMPARE_AND_SWAP_SUCCESS : ATOMIC_COMPARE_AND_SWAP_FAILURE;
+    #else
+        uint32_t ulReturnValue = ATOMIC_COMPARE_AND_SWAP_FAILURE;
 
-    ATOMIC_ENTER_CRITICAL();
-    {
-        if( *ppvDestination == pvComparand )
+        ATOMIC_ENTER_CRITICAL();
         {
-            *ppvDestination = pvExchange;
-            ulReturnValue = ATOMIC_COMPARE_AND_SWAP_SUCCESS;
+            if( *ppvDestination == pvComparand )
+            {
+                *ppvDestination = pvExchange;
+                ulReturnValue = ATOMIC_COMPARE_AND_SWAP_SUCCESS;
+            }
         }
-    }
-    ATOMIC_EXIT_CRITICAL();
+        ATOMIC_EXIT_CRITICAL();
 
-    return ulReturnValue;
+        return ulReturnValue;
+    #endif
 }
 
 
@@ -209,16 +254,20 @@ static portFORCE_INLINE uint32_t Atomic_CompareAndSwapPointers_p32( void * volat
 static portFORCE_INLINE uint32_t Atomic_Add_u32( uint32_t volatile * pulAddend,
                                                  uint32_t ulCount )
 {
-    uint32_t ulCurrent;
+    #if ( atomicUSE_BUILTINS == 1 )
+        return __atomic_fetch_add( pulAddend, ulCount, __ATOMIC_SEQ_CST );
+    #else
+        uint32_t ulCurrent;
 
-    ATOMIC_ENTER_CRITICAL();
-    {
-        ulCurrent = *pulAddend;
-        *pulAddend += ulCount;
-    }
-    ATOMIC_EXIT_CRITICAL();
+        ATOMIC_ENTER_CRITICAL();
+        {
+            ulCurrent = *pulAddend;
+            *pulAddend += ulCount;
+        }
+        ATOMIC_EXIT_CRITICAL();
 
-    return ulCurrent;
+        return ulCurrent;
+    #endif
 }
 /*-----------------------------------------------------------*/
 
@@ -237,16 +286,20 @@ static portFORCE_INLINE uint32_t Atomic_Add_u32( uint32_t volatile * pulAddend,
 static portFORCE_INLINE uint32_t Atomic_Subtract_u32( uint32_t volatile * pulAddend,
                                                       uint32_t ulCount )
 {
-    uint32_t ulCurrent;
+    #if ( atomicUSE_BUILTINS == 1 )
+        return __atomic_fetch_sub( pulAddend, ulCount, __ATOMIC_SEQ_CST );
+    #else
+        uint32_t ulCurrent;
 
-    ATOMIC_ENTER_CRITICAL();
-    {
-        ulCurrent = *pulAddend;
-        *pulAddend -= ulCount;
-    }
-    ATOMIC_EXIT_CRITICAL();
+        ATOMIC_ENTER_CRITICAL();
+        {
+            ulCurrent = *pulAddend;
+            *pulAddend -= ulCount;
+        }
+        ATOMIC_EXIT_CRITICAL();
 
-    return ulCurrent;
+        return ulCurrent;
+    #endif
 }
 /*-----------------------------------------------------------*/
 
@@ -262,16 +315,20 @@ static portFORCE_INLINE uint32_t Atomic_Subtract_u32( uint32_t volatile * pulAdd
  */
 static portFORCE_INLINE uint32_t Atomic_Increment_u32( uint32_t volatile * pulAddend )
 {
-    uint32_t ulCurrent;
+    #if ( atomicUSE_BUILTINS == 1 )
+        return __atomic_fetch_add( pulAddend, 1U, __ATOMIC_SEQ_CST );
+    #else
+        uint32_t ulCurrent;
 
-    ATOMIC_ENTER_CRITICAL();
-    {
-        ulCurrent = *pulAddend;
-        *pulAddend += 1;
-    }
-    ATOMIC_EXIT_CRITICAL();
+        ATOMIC_ENTER_CRITICAL();
+        {
+            ulCurrent = *pulAddend;
+            *pulAddend += 1;
+        }
+        ATOMIC_EXIT_CRITICAL();
 
-    return ulCurrent;
+        return ulCurrent;
+    #endif
 }
 /*-----------------------------------------------------------*/
 
@@ -287,16 +344,20 @@ static portFORCE_INLINE uint32_t Atomic_Increment_u32( uint32_t volatile * pulAd
  */
 static portFORCE_INLINE uint32_t Atomic_Decrement_u32( uint32_t volatile * pulAddend )
 {
-    uint32_t ulCurrent;
+    #if ( atomicUSE_BUILTINS == 1 )
+        return __atomic_fetch_sub( pulAddend, 1U, __ATOMIC_SEQ_CST );
+    #else
+        uint32_t ulCurrent;
 
-    ATOMIC_ENTER_CRITICAL();
-    {
-        ulCurrent = *pulAddend;
-        *pulAddend -= 1;
-    }
-    ATOMIC_EXIT_CRITICAL();
+        ATOMIC_ENTER_CRITICAL();
+        {
+            ulCurrent = *pulAddend;
+            *pulAddend -= 1;
+        }
+        ATOMIC_EXIT_CRITICAL();
 
-    return ulCurrent;
+        return ulCurrent;
+    #endif
 }
 
 /*----------------------------- Bitwise Logical ------------------------------*/
@@ -315,16 +376,20 @@ static portFORCE_INLINE uint32_t Atomic_Decrement_u32( uint32_t volatile * pulAd
 static portFORCE_INLINE uint32_t Atomic_OR_u32( uint32_t volatile * pulDestination,
                                                 uint32_t ulValue )
 {
-    uint32_t ulCurrent;
+    #if ( atomicUSE_BUILTINS == 1 )
+        return __atomic_fetch_or( pulDestination, ulValue, __ATOMIC_SEQ_CST );
+    #else
+        uint32_t ulCurrent;
 
-    ATOMIC_ENTER_CRITICAL();
-    {
-        ulCurrent = *pulDestination;
-        *pulDestination |= ulValue;
-    }
-    ATOMIC_EXIT_CRITICAL();
+        ATOMIC_ENTER_CRITICAL();
+        {
+            ulCurrent = *pulDestination;
+            *pulDestination |= ulValue;
+        }
+        ATOMIC_EXIT_CRITICAL();
 
-    return ulCurrent;
+        return ulCurrent;
+    #endif
 }
 /*-----------------------------------------------------------*/
 
@@ -342,16 +407,20 @@ static portFORCE_INLINE uint32_t Atomic_OR_u32( uint32_t volatile * pulDestinati
 static portFORCE_INLINE uint32_t Atomic_AND_u32( uint32_t volatile * pulDestination,
                                                  uint32_t ulValue )
 {
-    uint32_t ulCurrent;
+    #if ( atomicUSE_BUILTINS == 1 )
+        return __atomic_fetch_and( pulDestination, ulValue, __ATOMIC_SEQ_CST );
+    #else
+        uint32_t ulCurrent;
 
-    ATOMIC_ENTER_CRITICAL();
-    {
-        ulCurrent = *pulDestination;
-        *pulDestination &= ulValue;
-    }
-    ATOMIC_EXIT_CRITICAL();
+        ATOMIC_ENTER_CRITICAL();
+        {
+            ulCurrent = *pulDestination;
+            *pulDestination &= ulValue;
+        }
+        ATOMIC_EXIT_CRITICAL();
 
-    return ulCurrent;
+        return ulCurrent;
+    #endif
 }
 /*-----------------------------------------------------------*/
 
@@ -369,16 +438,20 @@ static portFORCE_INLINE uint32_t Atomic_AND_u32( uint32_t volatile * pulDestinat
 static portFORCE_INLINE uint32_t Atomic_NAND_u32( uint32_t volatile * pulDestination,
                                                   uint32_t ulValue )
 {
-    uint32_t ulCurrent;
+    #if ( atomicUSE_BUILTINS == 1 )
+        return __atomic_fetch_nand( pulDestination, ulValue, __ATOMIC_SEQ_CST );
+    #else
+        uint32_t ulCurrent;
 
-    ATOMIC_ENTER_CRITICAL();
-    {
-        ulCurrent = *pulDestination;
-        *pulDestination = ~( ulCurrent & ulValue );
-    }
-    ATOMIC_EXIT_CRITICAL();
+        ATOMIC_ENTER_CRITICAL();
+        {
+            ulCurrent = *pulDestination;
+            *pulDestination = ~( ulCurrent & ulValue );
+        }
+        ATOMIC_EXIT_CRITICAL();
 
-    return ulCurrent;
+        return ulCurrent;
+    #endif
 }
 /*-----------------------------------------------------------*/
 
@@ -396,16 +469,294 @@ static portFORCE_INLINE uint32_t Atomic_NAND_u32( uint32_t volatile * pulDestina
 static portFORCE_INLINE uint32_t Atomic_XOR_u32( uint32_t volatile * pulDestination,
                                                  uint32_t ulValue )
 {
-    uint32_t ulCurrent;
+    #if ( atomicUSE_BUILTINS == 1 )
+        return __atomic_fetch_xor( pulDestination, ulValue, __ATOMIC_SEQ_CST );
+    #else
+        uint32_t ulCurrent;
 
-    ATOMIC_ENTER_CRITICAL();
-    {
-        ulCurrent = *pulDestination;
-        *pulDestination ^= ulValue;
-    }
-    ATOMIC_EXIT_CRITICAL();
+        ATOMIC_ENTER_CRITICAL();
+        {
+            ulCurrent = *pulDestination;
+            *pulDestination ^= ulValue;
+        }
+        ATOMIC_EXIT_CRITICAL();
+
+        return ulCurrent;
+    #endif
+}
+
+/*----------------------------- 8-bit ------------------------------*/
+
+/**
+ * Atomic load (byte)
+ *
+ * @brief Reads a byte that other tasks or interrupts may be writing.
+ *
+ * @param[in] pucSource  Pointer to the byte to read.
+ *
+ * @return The value of *pucSource.
+ *
+ * @note A byte access is a single instruction, so no critical section is
+ *       needed on AVR.
+ */
+static portFORCE_INLINE uint8_t Atomic_Load_u8( const uint8_t volatile * pucSource )
+{
+    #if ( atomicUSE_BUILTINS == 1 )
+        return __atomic_load_n( pucSource, __ATOMIC_SEQ_CST );
+    #else
+        return *pucSource;
+    #endif
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * Atomic store (byte)
+ *
+ * @brief Writes a byte that other tasks or interrupts may be reading.
+ *
+ * @param[out] pucDestination  Pointer to the byte to write.
+ * @param[in] ucValue          Value to write.
+ *
+ * @note A byte access is a single instruction, so no critical section is
+ *       needed on AVR.
+ */
+static portFORCE_INLINE void Atomic_Store_u8( uint8_t volatile * pucDestination,
+                                              uint8_t ucValue )
+{
+    #if ( atomicUSE_BUILTINS == 1 )
+        __atomic_store_n( pucDestination, ucValue, __ATOMIC_SEQ_CST );
+    #else
+        *pucDestination = ucValue;
+    #endif
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * Atomic compare-and-swap (byte)
+ *
+ * @brief Performs an atomic compare-and-swap operation on a byte.
+ *
+ * @param[in, out] pucDestination  Pointer to memory location from where value is
+ *                               to be loaded and checked.
+ * @param[in] ucExchange         If condition meets, write this value to memory.
+ * @param[in] ucComparand        Swap condition.
+ *
+ * @return Unsigned integer of value 1 or 0. 1 for swapped, 0 for not swapped.
+ */
+static portFORCE_INLINE uint32_t Atomic_CompareAndSwap_u8( uint8_t volatile * pucDestination,
+                                                           uint8_t ucExchange,
+                                                           uint8_t ucComparand )
+{
+    #if ( atomicUSE_BUILTINS == 1 )
+        return __atomic_compare_exchange_n( pucDestination, &ucComparand, ucExchange, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST ) ?
+               ATOMIC_COMPARE_AND_SWAP_SUCCESS : ATOMIC_COMPARE_AND_SWAP_FAILURE;
+    #else
+        uint32_t ulReturnValue = ATOMIC_COMPARE_AND_SWAP_FAILURE;
+
+        ATOMIC_ENTER_CRITICAL();
+        {
+            if( *pucDestination == ucComparand )
+            {
+                *pucDestination = ucExchange;
+                ulReturnValue = ATOMIC_COMPARE_AND_SWAP_SUCCESS;
+            }
+        }
+        ATOMIC_EXIT_CRITICAL();
+
+        return ulReturnValue;
+    #endif
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * Atomic add (byte)
+ *
+ * @param[in,out] pucDestination  Pointer to the byte to update.
+ * @param[in] ucCount  Value to be added to *pucDestination.
+ *
+ * @return The original value of *pucDestination.
+ */
+static portFORCE_INLINE uint8_t Atomic_Add_u8( uint8_t volatile * pucDestination,
+                                               uint8_t ucCount )
+{
+    #if ( atomicUSE_BUILTINS == 1 )
+        return __atomic_fetch_add( pucDestination, ucCount, __ATOMIC_SEQ_CST );
+    #else
+        uint8_t ucCurrent;
+
+        ATOMIC_ENTER_CRITICAL();
+        {
+            ucCurrent = *pucDestination;
+            *pucDestination += ucCount;
+        }
+        ATOMIC_EXIT_CRITICAL();
+
+        return ucCurrent;
+    #endif
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * Atomic subtract (byte)
+ *
+ * @param[in,out] pucDestination  Pointer to the byte to update.
+ * @param[in] ucCount  Value to be subtracted from *pucDestination.
+ *
+ * @return The original value of *pucDestination.
+ */
+static portFORCE_INLINE uint8_t Atomic_Subtract_u8( uint8_t volatile * pucDestination,
+                                                    uint8_t ucCount )
+{
+    #if ( atomicUSE_BUILTINS == 1 )
+        return __atomic_fetch_sub( pucDestination, ucCount, __ATOMIC_SEQ_CST );
+    #else
+        uint8_t ucCurrent;
+
+        ATOMIC_ENTER_CRITICAL();
+        {
+            ucCurrent = *pucDestination;
+            *pucDestination -= ucCount;
+        }
+        ATOMIC_EXIT_CRITICAL();
+
+        return ucCurrent;
+    #endif
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * Atomic increment (byte)
+ *
+ * @param[in,out] pucDestination  Pointer to the byte to update.
+ *
+ * @return The original value of *pucDestination.
+ */
+static portFORCE_INLINE uint8_t Atomic_Increment_u8( uint8_t volatile * pucDestination )
+{
+    #if ( atomicUSE_BUILTINS == 1 )
+        return __atomic_fetch_add( pucDestination, 1U, __ATOMIC_SEQ_CST );
+    #else
+        uint8_t ucCurrent;
+
+        ATOMIC_ENTER_CRITICAL();
+        {
+            ucCurrent = *pucDestination;
+            *pucDestination += 1;
+        }
+        ATOMIC_EXIT_CRITICAL();
+
+        return ucCurrent;
+    #endif
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * Atomic decrement (byte)
+ *
+ * @param[in,out] pucDestination  Pointer to the byte to update.
+ *
+ * @return The original value of *pucDestination.
+ */
+static portFORCE_INLINE uint8_t Atomic_Decrement_u8( uint8_t volatile * pucDestination )
+{
+    #if ( atomicUSE_BUILTINS == 1 )
+        return __atomic_fetch_sub( pucDestination, 1U, __ATOMIC_SEQ_CST );
+    #else
+        uint8_t ucCurrent;
+
+        ATOMIC_ENTER_CRITICAL();
+        {
+            ucCurrent = *pucDestination;
+            *pucDestination -= 1;
+        }
+        ATOMIC_EXIT_CRITICAL();
+
+        return ucCurrent;
+    #endif
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * Atomic OR (byte)
+ *
+ * @param[in,out] pucDestination  Pointer to the byte to update.
+ * @param[in] ucValue  Value to be ORed with *pucDestination.
+ *
+ * @return The original value of *pucDestination.
+ */
+static portFORCE_INLINE uint8_t Atomic_OR_u8( uint8_t volatile * pucDestination,
+                                              uint8_t ucValue )
+{
+    #if ( atomicUSE_BUILTINS == 1 )
+        return __atomic_fetch_or( pucDestination, ucValue, __ATOMIC_SEQ_CST );
+    #else
+        uint8_t ucCurrent;
+
+        ATOMIC_ENTER_CRITICAL();
+        {
+            ucCurrent = *pucDestination;
+            *pucDestination |= ucValue;
+        }
+        ATOMIC_EXIT_CRITICAL();
+
+        return ucCurrent;
+    #endif
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * Atomic AND (byte)
+ *
+ * @param[in,out] pucDestination  Pointer to the byte to update.
+ * @param[in] ucValue  Value to be ANDed with *pucDestination.
+ *
+ * @return The original value of *pucDestination.
+ */
+static portFORCE_INLINE uint8_t Atomic_AND_u8( uint8_t volatile * pucDestination,
+                                               uint8_t ucValue )
+{
+    #if ( atomicUSE_BUILTINS == 1 )
+        return __atomic_fetch_and( pucDestination, ucValue, __ATOMIC_SEQ_CST );
+    #else
+        uint8_t ucCurrent;
+
+        ATOMIC_ENTER_CRITICAL();
+        {
+            ucCurrent = *pucDestination;
+            *pucDestination &= ucValue;
+        }
+        ATOMIC_EXIT_CRITICAL();
+
+        return ucCurrent;
+    #endif
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * Atomic XOR (byte)
+ *
+ * @param[in,out] pucDestination  Pointer to the byte to update.
+ * @param[in] ucValue  Value to be XORed with *pucDestination.
+ *
+ * @return The original value of *pucDestination.
+ */
+static portFORCE_INLINE uint8_t Atomic_XOR_u8( uint8_t volatile * pucDestination,
+                                               uint8_t ucValue )
+{
+    #if ( atomicUSE_BUILTINS == 1 )
+        return __atomic_fetch_xor( pucDestination, ucValue, __ATOMIC_SEQ_CST );
+    #else
+        uint8_t ucCurrent;
+
+        ATOMIC_ENTER_CRITICAL();
+        {
+            ucCurrent = *pucDestination;
+            *pucDestination ^= ucValue;
+        }
+        ATOMIC_EXIT_CRITICAL();
 
-    return ulCurrent;
+        return ucCurrent;
+    #endif
 }
 
 /* *INDENT-OFF* */
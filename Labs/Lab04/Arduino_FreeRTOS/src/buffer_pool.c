@@ -0,0 +1,252 @@
+/*
+ * This file is NOT part of the FreeRTOS distribution.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+/* Standard includes. */
+#include <stddef.h>
+
+/* FreeRTOS includes. */
+#include "Arduino_FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "buffer_pool.h"
+
+/* Convert between the header and the buffer handed to the application. */
+#define bufferpoolHEADER( pvBuffer )    ( ( BufferHeader_t * ) ( ( uint8_t * ) ( pvBuffer ) - sizeof( BufferHeader_t ) ) )
+#define bufferpoolPAYLOAD( pxHeader )   ( ( void * ) ( ( uint8_t * ) ( pxHeader ) + sizeof( BufferHeader_t ) ) )
+
+/*
+ * The work of allocating, retaining and releasing.  Each must be called with
+ * interrupts masked, which the public functions below arrange with either
+ * taskENTER_CRITICAL() or taskENTER_CRITICAL_FROM_ISR().
+ */
+static void * prvAlloc( BufferPool_t * pxPool );
+static void prvRetain( BufferHeader_t * pxHeader );
+static void prvRelease( BufferHeader_t * pxHeader );
+
+/*-----------------------------------------------------------*/
+
+static void * prvAlloc( BufferPool_t * pxPool )
+{
+    BufferHeader_t * pxHeader;
+
+    if( pxPool->pxFreeList != NULL )
+    {
+        pxHeader = pxPool->pxFreeList;
+        pxPool->pxFreeList = pxHeader->pxNextFree;
+    }
+    else if( pxPool->uxNextUnused < pxPool->uxBlockCount )
+    {
+        /* Blocks are carved out of the storage the first time they are needed,
+         * so the pool doesn't have to be initialised before use. */
+        pxHeader = ( BufferHeader_t * ) ( pxPool->pucStorage + ( pxPool->uxNextUnused * pxPool->xStride ) );
+        pxHeader->pxPool = pxPool;
+        pxPool->uxNextUnused++;
+    }
+    else
+    {
+        pxPool->uxAllocFailures++;
+        return NULL;
+    }
+
+    pxHeader->pxNextFree = NULL;
+    pxHeader->uxRefCount = 1U;
+
+    pxPool->uxInUse++;
+    pxPool->ulAllocations++;
+
+    if( pxPool->uxInUse > pxPool->uxHighWater )
+    {
+        pxPool->uxHighWater = pxPool->uxInUse;
+    }
+
+    return bufferpoolPAYLOAD( pxHeader );
+}
+/*-----------------------------------------------------------*/
+
+static void prvRetain( BufferHeader_t * pxHeader )
+{
+    /* Retaining a buffer that is back in the pool is a use after free. */
+    configASSERT( pxHeader->uxRefCount > 0U );
+
+    pxHeader->uxRefCount++;
+}
+/*-----------------------------------------------------------*/
+
+static void prvRelease( BufferHeader_t * pxHeader )
+{
+    BufferPool_t * pxPool = pxHeader->pxPool;
+
+    configASSERT( pxHeader->uxRefCount > 0U );
+
+    pxHeader->uxRefCount--;
+
+    if( pxHeader->uxRefCount == 0U )
+    {
+        pxHeader->pxNextFree = pxPool->pxFreeList;
+        pxPool->pxFreeList = pxHeader;
+        pxPool->uxInUse--;
+    }
+}
+/*-----------------------------------------------------------*/
+
+void * pvBufferPoolAlloc( BufferPool_t * pxPool )
+{
+    void * pvBuffer;
+
+    configASSERT( pxPool );
+
+    taskENTER_CRITICAL();
+    {
+        pvBuffer = prvAlloc( pxPool );
+    }
+    taskEXIT_CRITICAL();
+
+    return pvBuffer;
+}
+/*-----------------------------------------------------------*/
+
+void * pvBufferPoolAllocFromISR( BufferPool_t * pxPool )
+{
+    void * pvBuffer;
+    UBaseType_t uxSavedInterruptStatus;
+
+    configASSERT( pxPool );
+
+    uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+    {
+        pvBuffer = prvAlloc( pxPool );
+    }
+    taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+
+    return pvBuffer;
+}
+/*-----------------------------------------------------------*/
+
+void vBufferRetain( void * pvBuffer )
+{
+    configASSERT( pvBuffer );
+
+    taskENTER_CRITICAL();
+    {
+        prvRetain( bufferpoolHEADER( pvBuffer ) );
+    }
+    taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+void vBufferRetainFromISR( void * pvBuffer )
+{
+    UBaseType_t uxSavedInterruptStatus;
+
+    configASSERT( pvBuffer );
+
+    uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+    {
+        prvRetain( bufferpoolHEADER( pvBuffer ) );
+    }
+    taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+}
+/*-----------------------------------------------------------*/
+
+void vBufferRelease( void * pvBuffer )
+{
+    configASSERT( pvBuffer );
+
+    taskENTER_CRITICAL();
+    {
+        prvRelease( bufferpoolHEADER( pvBuffer ) );
+    }
+    taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+void vBufferReleaseFromISR( void * pvBuffer )
+{
+    UBaseType_t uxSavedInterruptStatus;
+
+    configASSERT( pvBuffer );
+
+    uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+    {
+        prvRelease( bufferpoolHEADER( pvBuffer ) );
+    }
+    taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xBufferSendToQueue( QueueHandle_t xQueue,
+                               void * pvBuffer,
+                               TickType_t xTicksToWait )
+{
+    BaseType_t xReturn;
+
+    configASSERT( uxQueueGetQueueItemSize( xQueue ) == sizeof( void * ) );
+
+    /* Take the receiver's reference before posting, as the receiver may run
+     * and release it before xQueueSendToBack() returns. */
+    vBufferRetain( pvBuffer );
+    xReturn = xQueueSendToBack( xQueue, &pvBuffer, xTicksToWait );
+
+    if( xReturn != pdPASS )
+    {
+        vBufferRelease( pvBuffer );
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xBufferSendToQueueFromISR( QueueHandle_t xQueue,
+                                      void * pvBuffer,
+                                      BaseType_t * const pxHigherPriorityTaskWoken )
+{
+    BaseType_t xReturn;
+
+    vBufferRetainFromISR( pvBuffer );
+    xReturn = xQueueSendToBackFromISR( xQueue, &pvBuffer, pxHigherPriorityTaskWoken );
+
+    if( xReturn != pdPASS )
+    {
+        vBufferReleaseFromISR( pvBuffer );
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vBufferPoolGetStats( BufferPool_t * pxPool,
+                          BufferPoolStats_t * pxStats )
+{
+    configASSERT( pxPool );
+    configASSERT( pxStats );
+
+    taskENTER_CRITICAL();
+    {
+        pxStats->uxBlockCount = pxPool->uxBlockCount;
+        pxStats->uxInUse = pxPool->uxInUse;
+        pxStats->uxHighWater = pxPool->uxHighWater;
+        pxStats->uxAllocFailures = pxPool->uxAllocFailures;
+        pxStats->ulAllocations = pxPool->ulAllocations;
+    }
+    taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,192 @@
+/*
+ * This file is NOT part of the FreeRTOS distribution.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+/*
+ * A buffer pool hands out fixed-size buffers from statically allocated
+ * storage.  Allocation and release are O(1) and may be called from tasks or
+ * interrupts, so a captured frame can be filled in an ISR and passed on
+ * without copying.
+ *
+ * Each buffer carries a reference count.  A buffer starts with one reference
+ * when it is allocated; xBufferSendToQueue() adds one for each queue it is
+ * posted to, and every holder calls vBufferRelease() when it is done.  The
+ * buffer goes back to the pool when the last reference is released, so one
+ * frame can be shared by an FFT task, a logger and a display task without any
+ * of them knowing about the others.
+ *
+ * Queues carry buffers by reference - create them with an item size of
+ * sizeof( void * ).
+ */
+
+#ifndef BUFFER_POOL_H
+#define BUFFER_POOL_H
+
+#ifndef INC_ARDUINO_FREERTOS_H
+    #error "include Arduino_FreeRTOS.h must appear in source files before include buffer_pool.h"
+#endif
+
+#include "queue.h"
+
+/* *INDENT-OFF* */
+#if defined( __cplusplus )
+    extern "C" {
+#endif
+/* *INDENT-ON* */
+
+/**
+ * Bookkeeping stored in front of each buffer.  Private to buffer_pool.c.
+ */
+typedef struct BufferHeader
+{
+    struct BufferPool * pxPool;          /*< Pool the buffer belongs to. */
+    struct BufferHeader * pxNextFree;    /*< Next buffer on the free list. */
+    volatile UBaseType_t uxRefCount;     /*< Number of holders, 0 when free. */
+} BufferHeader_t;
+
+/**
+ * A pool of fixed-size buffers.  Declare with bufferpoolDEFINE().
+ */
+typedef struct BufferPool
+{
+    uint8_t * pucStorage;                /*< uxBlockCount blocks of xStride bytes. */
+    size_t xBlockSize;                   /*< Usable size of each buffer. */
+    size_t xStride;                      /*< Header plus buffer, rounded up to the port alignment. */
+    UBaseType_t uxBlockCount;            /*< Number of buffers in the pool. */
+    BufferHeader_t * pxFreeList;         /*< Released buffers, ready for reuse. */
+    UBaseType_t uxNextUnused;            /*< Index of the first buffer never handed out. */
+    UBaseType_t uxInUse;                 /*< Buffers currently allocated. */
+    UBaseType_t uxHighWater;             /*< Largest value uxInUse has reached. */
+    UBaseType_t uxAllocFailures;         /*< Allocations that found the pool empty. */
+    uint32_t ulAllocations;              /*< Total successful allocations. */
+} BufferPool_t;
+
+/**
+ * A snapshot of a pool's usage, see vBufferPoolGetStats().
+ */
+typedef struct BufferPoolStats
+{
+    UBaseType_t uxBlockCount;            /*< Number of buffers in the pool. */
+    UBaseType_t uxInUse;                 /*< Buffers not yet released.  Non-zero when idle means a leak. */
+    UBaseType_t uxHighWater;             /*< Most buffers ever in use at once. */
+    UBaseType_t uxAllocFailures;         /*< Allocations that found the pool empty. */
+    uint32_t ulAllocations;              /*< Total successful allocations. */
+} BufferPoolStats_t;
+
+/* Size of one block, header included, rounded up to the port alignment. */
+#define bufferpoolSTRIDE( xBlockSize ) \
+    ( ( sizeof( BufferHeader_t ) + ( xBlockSize ) + ( portBYTE_ALIGNMENT - 1 ) ) & ~( ( size_t ) ( portBYTE_ALIGNMENT - 1 ) ) )
+
+/**
+ * Define a pool of uxBlockCount buffers of xBlockSize bytes each, with the
+ * storage allocated statically.  The pool needs no further initialisation.
+ *
+ * Example usage:
+ * <pre>
+ * bufferpoolDEFINE( xFramePool, 512, 2 );
+ *
+ * void vProducer( void * pvParameters )
+ * {
+ *     int8_t * pcFrame = pvBufferPoolAlloc( &xFramePool );
+ *     ... fill the frame ...
+ *     xBufferSendToQueue( xFFTQueue, pcFrame, portMAX_DELAY );
+ *     xBufferSendToQueue( xLogQueue, pcFrame, portMAX_DELAY );
+ *     vBufferRelease( pcFrame ); // the queues hold their own references
+ * }
+ * </pre>
+ */
+#define bufferpoolDEFINE( xName, xBlockSize, uxBlockCount )                                                                  \
+    static uint8_t xName ## Storage[ ( uxBlockCount ) * bufferpoolSTRIDE( xBlockSize ) ] __attribute__( ( aligned( portBYTE_ALIGNMENT ) ) ); \
+    BufferPool_t xName = { xName ## Storage, ( xBlockSize ), bufferpoolSTRIDE( xBlockSize ), ( uxBlockCount ), NULL, 0U, 0U, 0U, 0U, 0UL }
+
+/**
+ * Take a buffer from the pool.  The caller owns the one reference it starts
+ * with.  Never blocks.
+ *
+ * @return Pointer to xBlockSize bytes, or NULL if the pool is empty.
+ */
+void * pvBufferPoolAlloc( BufferPool_t * pxPool ) PRIVILEGED_FUNCTION;
+
+/**
+ * A version of pvBufferPoolAlloc() that can be called from an interrupt
+ * service routine.
+ */
+void * pvBufferPoolAllocFromISR( BufferPool_t * pxPool ) PRIVILEGED_FUNCTION;
+
+/**
+ * Add a reference to a buffer, for a new holder that will release it later.
+ */
+void vBufferRetain( void * pvBuffer ) PRIVILEGED_FUNCTION;
+
+/**
+ * A version of vBufferRetain() that can be called from an interrupt service
+ * routine.
+ */
+void vBufferRetainFromISR( void * pvBuffer ) PRIVILEGED_FUNCTION;
+
+/**
+ * Drop a reference to a buffer.  The buffer returns to its pool when the last
+ * reference is dropped, and must not be touched by this holder afterwards.
+ */
+void vBufferRelease( void * pvBuffer ) PRIVILEGED_FUNCTION;
+
+/**
+ * A version of vBufferRelease() that can be called from an interrupt service
+ * routine.
+ */
+void vBufferReleaseFromISR( void * pvBuffer ) PRIVILEGED_FUNCTION;
+
+/**
+ * Post a buffer to a queue by reference.  A reference is added for the
+ * receiver, who must call vBufferRelease() once done with it.  If the send
+ * times out the reference is dropped again.
+ *
+ * @param xQueue Queue created with an item size of sizeof( void * ).
+ * @param pvBuffer The buffer to post.
+ * @param xTicksToWait Time to wait for space on the queue.
+ *
+ * @return pdPASS if the buffer was posted, otherwise errQUEUE_FULL.
+ */
+BaseType_t xBufferSendToQueue( QueueHandle_t xQueue,
+                               void * pvBuffer,
+                               TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * A version of xBufferSendToQueue() that can be called from an interrupt
+ * service routine.
+ */
+BaseType_t xBufferSendToQueueFromISR( QueueHandle_t xQueue,
+                                      void * pvBuffer,
+                                      BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/**
+ * Take a consistent snapshot of a pool's usage counters.
+ */
+void vBufferPoolGetStats( BufferPool_t * pxPool,
+                          BufferPoolStats_t * pxStats ) PRIVILEGED_FUNCTION;
+
+/* *INDENT-OFF* */
+#if defined( __cplusplus )
+    }
+#endif
+/* *INDENT-ON* */
+
+#endif /* BUFFER_POOL_H */
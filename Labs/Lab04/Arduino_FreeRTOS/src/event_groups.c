@@ -38,6 +38,10 @@
 #include "timers.h"
 #include "event_groups.h"
 
+#if ( configUSE_RAM_ACCOUNTING == 1 )
+    #include "ram_account.h"
+#endif
+
 /* Lint e961, e750 and e9021 are suppressed as a MISRA exception justified
  * because the MPU ports require MPU_WRAPPERS_INCLUDED_FROM_API_FILE to be defined
  * for the header files above, but not in this file, in order to generate the
@@ -71,6 +75,10 @@ typedef struct EventGroupDef_t
     #if ( ( configSUPPORT_STATIC_ALLOCATION == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
         uint8_t ucStaticallyAllocated; /*< Set to pdTRUE if the event group is statically allocated to ensure no attempt is made to free the memory. */
     #endif
+
+    #if ( configUSE_RAM_ACCOUNTING == 1 )
+        UBaseType_t uxRamOwner; /*< Number of the task that created the event group, see ram_account.h. */
+    #endif
 } EventGroup_t;
 
 /*-----------------------------------------------------------*/
@@ -125,6 +133,13 @@ static BaseType_t prvTestWaitCondition( const EventBits_t uxCurrentEventBits,
                 }
             #endif /* configSUPPORT_DYNAMIC_ALLOCATION */
 
+            #if ( configUSE_RAM_ACCOUNTING == 1 )
+                {
+                    pxEventBits->uxRamOwner = uxRamAccountOwner();
+                    vRamAccountAdd( pxEventBits->uxRamOwner, eRamEventGroup, sizeof( EventGroup_t ) );
+                }
+            #endif /* configUSE_RAM_ACCOUNTING */
+
             traceEVENT_GROUP_CREATE( pxEventBits );
         }
         else
@@ -176,6 +191,13 @@ static BaseType_t prvTestWaitCondition( const EventBits_t uxCurrentEventBits,
                 }
             #endif /* configSUPPORT_STATIC_ALLOCATION */
 
+            #if ( configUSE_RAM_ACCOUNTING == 1 )
+                {
+                    pxEventBits->uxRamOwner = uxRamAccountOwner();
+                    vRamAccountAdd( pxEventBits->uxRamOwner, eRamEventGroup, sizeof( EventGroup_t ) );
+                }
+            #endif /* configUSE_RAM_ACCOUNTING */
+
             traceEVENT_GROUP_CREATE( pxEventBits );
         }
         else
@@ -632,6 +654,12 @@ void vEventGroupDelete( EventGroupHandle_t xEventGroup )
     {
         traceEVENT_GROUP_DELETE( xEventGroup );
 
+        #if ( configUSE_RAM_ACCOUNTING == 1 )
+            {
+                vRamAccountRemove( pxEventBits->uxRamOwner, eRamEventGroup, sizeof( EventGroup_t ) );
+            }
+        #endif /* configUSE_RAM_ACCOUNTING */
+
         while( listCURRENT_LIST_LENGTH( pxTasksWaitingForBits ) > ( UBaseType_t ) 0 )
         {
             /* Unblock the task, returning 0 as the event list is being deleted
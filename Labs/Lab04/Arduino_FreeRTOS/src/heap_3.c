@@ -47,6 +47,10 @@
 #include "Arduino_FreeRTOS.h"
 #include "task.h"
 
+#if ( configUSE_RAM_ACCOUNTING == 1 )
+    #include "ram_account.h"
+#endif
+
 #undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
 
 #if( configSUPPORT_DYNAMIC_ALLOCATION > 0 )
@@ -61,6 +65,15 @@ void * pvPortMalloc( size_t xWantedSize )
     {
         pvReturn = malloc( xWantedSize );
         traceMALLOC( pvReturn, xWantedSize );
+
+        #if ( configUSE_RAM_ACCOUNTING == 1 )
+            {
+                if( pvReturn != NULL )
+                {
+                    vRamAccountAdd( 0U, eRamHeapOverhead, ramaccountHEAP_BLOCK_OVERHEAD );
+                }
+            }
+        #endif
     }
     ( void ) xTaskResumeAll();
 
@@ -86,6 +99,12 @@ void vPortFree( void * pv )
         {
             free( pv );
             traceFREE( pv, 0 );
+
+            #if ( configUSE_RAM_ACCOUNTING == 1 )
+                {
+                    vRamAccountRemove( 0U, eRamHeapOverhead, ramaccountHEAP_BLOCK_OVERHEAD );
+                }
+            #endif
         }
         ( void ) xTaskResumeAll();
     }
@@ -0,0 +1,328 @@
+/*
+ * This file is NOT part of the FreeRTOS distribution.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+/* FreeRTOS includes. */
+#include "Arduino_FreeRTOS.h"
+#include "task.h"
+#include "idle_power.h"
+
+#if ( configUSE_IDLE_POWER == 1 )
+
+    #ifndef portGET_RUN_TIME_COUNTER_VALUE
+        #error configUSE_IDLE_POWER requires portGET_RUN_TIME_COUNTER_VALUE() to return a time in microseconds.
+    #endif
+
+    #if defined( __AVR__ )
+        #include <avr/io.h>
+        #include <avr/sleep.h>
+    #endif
+
+    #define idlepowerGET_TIME_US()          ( ( uint32_t ) portGET_RUN_TIME_COUNTER_VALUE() )
+    #define idlepowerTICKS_TO_US( xTicks )    ( ( uint32_t ) ( xTicks ) * ( uint32_t ) portTICK_PERIOD_MS * 1000UL )
+
+/* The clock select bits, which are the same in every timer's TCCRnB. */
+    #define idlepowerCLOCK_SELECT_MASK      ( ( uint8_t ) 0x07 )
+
+    PRIVILEGED_DATA static eIdlePowerState eDeepestState = eIdlePowerDown;
+    PRIVILEGED_DATA static IdlePowerStats_t xStats;
+    PRIVILEGED_DATA static uint32_t ulResetTimeUs = 0UL;
+
+/*
+ * The deepest state that keeps every running peripheral running.
+ */
+    static eIdlePowerState prvPeripheralLimit( void );
+
+/*
+ * Sleep in the given state.  Called with interrupts disabled, returns with
+ * them enabled once an interrupt has woken the CPU.
+ */
+    static void prvSleep( eIdlePowerState eState );
+
+/*-----------------------------------------------------------*/
+
+    #if defined( __AVR__ )
+
+        static eIdlePowerState prvPeripheralLimit( void )
+        {
+            eIdlePowerState eLimit = eIdlePowerDown;
+
+            /* Timer 2 alone can keep counting in power-save, from its own
+             * asynchronous clock. */
+            #ifdef TCCR2B
+                if( ( TCCR2B & idlepowerCLOCK_SELECT_MASK ) != 0 )
+                {
+                    #ifdef AS2
+                        eLimit = ( ( ASSR & _BV( AS2 ) ) != 0 ) ? eIdlePowerSave : eIdlePowerIdle;
+                    #else
+                        eLimit = eIdlePowerIdle;
+                    #endif
+                }
+            #endif
+
+            /* Everything else needs the I/O clock. */
+            if( ( TCCR0B & idlepowerCLOCK_SELECT_MASK ) != 0 )
+            {
+                eLimit = eIdlePowerIdle;
+            }
+
+            #ifdef TCCR1B
+                if( ( TCCR1B & idlepowerCLOCK_SELECT_MASK ) != 0 )
+                {
+                    eLimit = eIdlePowerIdle;
+                }
+            #endif
+            #ifdef TCCR3B
+                if( ( TCCR3B & idlepowerCLOCK_SELECT_MASK ) != 0 )
+                {
+                    eLimit = eIdlePowerIdle;
+                }
+            #endif
+            #ifdef TCCR4B
+                if( ( TCCR4B & idlepowerCLOCK_SELECT_MASK ) != 0 )
+                {
+                    eLimit = eIdlePowerIdle;
+                }
+            #endif
+            #ifdef TCCR5B
+                if( ( TCCR5B & idlepowerCLOCK_SELECT_MASK ) != 0 )
+                {
+                    eLimit = eIdlePowerIdle;
+                }
+            #endif
+
+            /* The enable bits sit in the same place in every USART. */
+            #ifdef UCSR0B
+                if( ( UCSR0B & ( _BV( RXEN0 ) | _BV( TXEN0 ) ) ) != 0 )
+                {
+                    eLimit = eIdlePowerIdle;
+                }
+            #endif
+            #ifdef UCSR1B
+                if( ( UCSR1B & ( _BV( RXEN0 ) | _BV( TXEN0 ) ) ) != 0 )
+                {
+                    eLimit = eIdlePowerIdle;
+                }
+            #endif
+            #ifdef UCSR2B
+                if( ( UCSR2B & ( _BV( RXEN0 ) | _BV( TXEN0 ) ) ) != 0 )
+                {
+                    eLimit = eIdlePowerIdle;
+                }
+            #endif
+            #ifdef UCSR3B
+                if( ( UCSR3B & ( _BV( RXEN0 ) | _BV( TXEN0 ) ) ) != 0 )
+                {
+                    eLimit = eIdlePowerIdle;
+                }
+            #endif
+
+            #ifdef SPCR
+                if( ( SPCR & _BV( SPE ) ) != 0 )
+                {
+                    eLimit = eIdlePowerIdle;
+                }
+            #endif
+            #ifdef TWCR
+                if( ( TWCR & _BV( TWEN ) ) != 0 )
+                {
+                    eLimit = eIdlePowerIdle;
+                }
+            #endif
+            #ifdef ADCSRA
+                if( ( ADCSRA & _BV( ADEN ) ) != 0 )
+                {
+                    eLimit = eIdlePowerIdle;
+                }
+            #endif
+
+            return eLimit;
+        }
+/*-----------------------------------------------------------*/
+
+        static void prvSleep( eIdlePowerState eState )
+        {
+            switch( eState )
+            {
+                case eIdlePowerSave:
+                    set_sleep_mode( SLEEP_MODE_PWR_SAVE );
+                    break;
+
+                case eIdlePowerDown:
+                    set_sleep_mode( SLEEP_MODE_PWR_DOWN );
+                    break;
+
+                default:
+                    set_sleep_mode( SLEEP_MODE_IDLE );
+                    break;
+            }
+
+            /* The instruction after sei always runs before any interrupt, so an
+             * interrupt arriving now still wakes the CPU from the sleep. */
+            sleep_enable();
+            portENABLE_INTERRUPTS();
+            sleep_cpu();
+            sleep_disable();
+        }
+
+    #else /* defined( __AVR__ ) */
+
+        static eIdlePowerState prvPeripheralLimit( void )
+        {
+            return eIdlePowerIdle;
+        }
+/*-----------------------------------------------------------*/
+
+        static void prvSleep( eIdlePowerState eState )
+        {
+            ( void ) eState;
+
+            /* No sleep instruction, so wait for the interrupt that would have
+             * woken the CPU to leave some work behind. */
+            portENABLE_INTERRUPTS();
+
+            while( xTaskIdleMaySleep() != pdFALSE )
+            {
+            }
+        }
+
+    #endif /* defined( __AVR__ ) */
+/*-----------------------------------------------------------*/
+
+    eIdlePowerState eIdlePowerSelectState( void )
+    {
+        eIdlePowerState eState = prvPeripheralLimit();
+
+        if( eState > eDeepestState )
+        {
+            eState = eDeepestState;
+        }
+
+        return eState;
+    }
+/*-----------------------------------------------------------*/
+
+    void vIdlePowerEnter( void )
+    {
+        eIdlePowerState eState;
+        uint32_t ulStartUs, ulSleptUs;
+        TickType_t xStartTicks;
+        BaseType_t xSlept = pdFALSE;
+
+        eState = eIdlePowerSelectState();
+
+        if( eState == eIdlePowerNone )
+        {
+            return;
+        }
+
+        /* With the scheduler suspended an interrupt that readies a task can
+         * not switch to it, so the CPU comes back here first and the time
+         * measured is only the time spent asleep. */
+        vTaskSuspendAll();
+        {
+            ulStartUs = idlepowerGET_TIME_US();
+            xStartTicks = xTaskGetPendedTicks();
+
+            /* Keep sleeping through interrupts that leave nothing to do. */
+            for( ; ; )
+            {
+                portDISABLE_INTERRUPTS();
+
+                if( xTaskIdleMaySleep() == pdFALSE )
+                {
+                    portENABLE_INTERRUPTS();
+                    break;
+                }
+
+                prvSleep( eState );
+                xSlept = pdTRUE;
+            }
+
+            if( xSlept != pdFALSE )
+            {
+                /* The microsecond clock stops with timer 0 in the deeper
+                 * states, but the watchdog tick keeps counting. */
+                if( eState == eIdlePowerIdle )
+                {
+                    ulSleptUs = idlepowerGET_TIME_US() - ulStartUs;
+                }
+                else
+                {
+                    ulSleptUs = idlepowerTICKS_TO_US( xTaskGetPendedTicks() - xStartTicks );
+                }
+
+                xStats.ulEntries[ eState ]++;
+                xStats.ulResidencyUs[ eState ] += ulSleptUs;
+            }
+            else
+            {
+                xStats.ulEntries[ eIdlePowerNone ]++;
+            }
+        }
+        ( void ) xTaskResumeAll();
+    }
+/*-----------------------------------------------------------*/
+
+    void vIdlePowerSetDeepest( eIdlePowerState eDeepest )
+    {
+        configASSERT( eDeepest < eIdlePowerNumberOfStates );
+
+        eDeepestState = eDeepest;
+    }
+/*-----------------------------------------------------------*/
+
+    void vIdlePowerGetStats( IdlePowerStats_t * pxStats )
+    {
+        configASSERT( pxStats );
+
+        /* The statistics are only written by the idle task with the scheduler
+         * suspended. */
+        vTaskSuspendAll();
+        {
+            *pxStats = xStats;
+
+            /* Add back the time the microsecond clock was stopped for. */
+            pxStats->ulElapsedUs = ( idlepowerGET_TIME_US() - ulResetTimeUs ) + xStats.ulResidencyUs[ eIdlePowerSave ] + xStats.ulResidencyUs[ eIdlePowerDown ];
+        }
+        ( void ) xTaskResumeAll();
+    }
+/*-----------------------------------------------------------*/
+
+    void vIdlePowerResetStats( void )
+    {
+        UBaseType_t x;
+
+        vTaskSuspendAll();
+        {
+            for( x = 0; x < ( UBaseType_t ) eIdlePowerNumberOfStates; x++ )
+            {
+                xStats.ulEntries[ x ] = 0UL;
+                xStats.ulResidencyUs[ x ] = 0UL;
+            }
+
+            ulResetTimeUs = idlepowerGET_TIME_US();
+        }
+        ( void ) xTaskResumeAll();
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* configUSE_IDLE_POWER */
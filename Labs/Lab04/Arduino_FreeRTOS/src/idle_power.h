@@ -0,0 +1,122 @@
+/*
+ * This file is NOT part of the FreeRTOS distribution.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+/*
+ * Idle power management.  With configUSE_IDLE_POWER set to 1 the idle hook
+ * calls vIdlePowerEnter(), which puts the CPU to sleep until the next
+ * interrupt instead of letting the idle task spin.
+ *
+ * The sleep mode is picked from the peripherals that are running when the
+ * idle task gets there, so nothing the application relies on is stopped:
+ *
+ *   + Idle stops only the CPU.  Used while any of timers 0, 1, 3, 4 and 5,
+ *     a synchronous timer 2, a USART, SPI, TWI or the ADC is enabled.  Under
+ *     the Arduino core timer 0 always runs for millis(), so this is the usual
+ *     case.
+ *
+ *   + Power-save also stops the I/O clock, leaving an asynchronous timer 2
+ *     running.
+ *
+ *   + Power-down leaves only the watchdog, which drives the tick.
+ *
+ * Time spent in each mode is measured with portGET_RUN_TIME_COUNTER_VALUE().
+ * That clock stops with timer 0 in the deeper modes, which are measured in
+ * ticks instead.  The scheduler stays suspended while the CPU sleeps, so the
+ * time other tasks run is never counted as sleep.
+ *
+ * Host builds have no sleep instruction.  The idle task spins until the next
+ * tick or a task becomes ready instead, and that time is recorded as idle
+ * residency, so the headroom a task set leaves can be measured the same way.
+ */
+
+#ifndef IDLE_POWER_H
+#define IDLE_POWER_H
+
+#ifndef INC_ARDUINO_FREERTOS_H
+    #error "include Arduino_FreeRTOS.h must appear in source files before include idle_power.h"
+#endif
+
+#include "task.h"
+
+/* *INDENT-OFF* */
+#if defined( __cplusplus )
+    extern "C" {
+#endif
+/* *INDENT-ON* */
+
+/* Sleep states, from lightest to deepest. */
+typedef enum
+{
+    eIdlePowerNone = 0, /* Not sleeping.  Counts the times sleep was skipped because work was pending. */
+    eIdlePowerIdle,     /* CPU stopped, peripherals running. */
+    eIdlePowerSave,     /* Only an asynchronous timer 2 and the watchdog running. */
+    eIdlePowerDown,     /* Only the watchdog running. */
+    eIdlePowerNumberOfStates
+} eIdlePowerState;
+
+/**
+ * Time spent in each sleep state, see vIdlePowerGetStats().
+ */
+typedef struct IdlePowerStats
+{
+    uint32_t ulEntries[ eIdlePowerNumberOfStates ];     /*< Times each state was entered. */
+    uint32_t ulResidencyUs[ eIdlePowerNumberOfStates ]; /*< Time spent in each state. */
+    uint32_t ulElapsedUs;                               /*< Time since the statistics were reset. */
+} IdlePowerStats_t;
+
+/**
+ * Sleep until the next interrupt if no task is waiting to run.  Called from
+ * the idle hook, which must not block, so it returns as soon as the CPU wakes.
+ */
+void vIdlePowerEnter( void ) PRIVILEGED_FUNCTION;
+
+/**
+ * Limit how deep the idle task may sleep, for example to eIdlePowerIdle if a
+ * wake up from power-down takes too long.  eIdlePowerNone stops the idle task
+ * sleeping at all.  Defaults to eIdlePowerDown.
+ */
+void vIdlePowerSetDeepest( eIdlePowerState eDeepest ) PRIVILEGED_FUNCTION;
+
+/**
+ * The state vIdlePowerEnter() would sleep in now, given the running
+ * peripherals and the limit set with vIdlePowerSetDeepest().
+ */
+eIdlePowerState eIdlePowerSelectState( void ) PRIVILEGED_FUNCTION;
+
+/**
+ * Get the time spent in each state since the statistics were last reset.  The
+ * share of ulElapsedUs spent asleep is the CPU time the task set leaves free.
+ */
+void vIdlePowerGetStats( IdlePowerStats_t * pxStats ) PRIVILEGED_FUNCTION;
+
+/**
+ * Clear the statistics and restart ulElapsedUs from now.
+ */
+void vIdlePowerResetStats( void ) PRIVILEGED_FUNCTION;
+
+/* *INDENT-OFF* */
+#if defined( __cplusplus )
+    }
+#endif
+/* *INDENT-ON* */
+
+#endif /* IDLE_POWER_H */
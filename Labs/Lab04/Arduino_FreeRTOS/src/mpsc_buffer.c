@@ -0,0 +1,407 @@
+/*
+ * This file is NOT part of the FreeRTOS distribution.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+/* Standard includes. */
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "Arduino_FreeRTOS.h"
+#include "task.h"
+#include "mpsc_buffer.h"
+
+#if ( configUSE_TASK_NOTIFICATIONS != 1 )
+    #error configUSE_TASK_NOTIFICATIONS must be set to 1 to use mpsc_buffer.c
+#endif
+
+#if ( ( INCLUDE_xTaskGetCurrentTaskHandle != 1 ) && ( configUSE_MUTEXES != 1 ) )
+    #error INCLUDE_xTaskGetCurrentTaskHandle must be set to 1 to use mpsc_buffer.c
+#endif
+
+/*
+ * The first header byte holds the message state in its top two bits and the
+ * top of the length in the rest, the second byte the bottom of the length.
+ * A message is written with neither state bit set while it is reserved.
+ */
+#define mpscCOMMITTED      ( ( uint8_t ) 0x80U )
+#define mpscSKIP           ( ( uint8_t ) 0x40U )
+#define mpscLENGTH_HIGH    ( ( uint8_t ) 0x3FU )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Find room for a message of xLength bytes and write its header.  Must be
+ * called with interrupts masked.
+ */
+static uint8_t * prvReserve( MpscBuffer_t * pxBuffer,
+                             size_t xLength ) PRIVILEGED_FUNCTION;
+
+/*
+ * Mark a reserved message as committed, returning the reader if it is waiting
+ * to be woken.  Must be called with interrupts masked.
+ */
+static TaskHandle_t prvCommit( MpscBuffer_t * pxBuffer,
+                               void * pvMessage ) PRIVILEGED_FUNCTION;
+
+/*
+ * Return the oldest message if it has been committed, reclaiming any space
+ * skipped in front of it.  Must be called with interrupts masked.
+ */
+static uint8_t * prvOldestMessage( MpscBuffer_t * pxBuffer,
+                                   size_t * pxLength ) PRIVILEGED_FUNCTION;
+
+/*-----------------------------------------------------------*/
+
+static uint8_t * prvReserve( MpscBuffer_t * pxBuffer,
+                             size_t xLength )
+{
+    const size_t xNeeded = mpscbufferHEADER_BYTES + xLength;
+    size_t xHead, xSkip;
+    uint8_t * pucHeader = NULL;
+
+    configASSERT( ( xLength > 0U ) && ( xLength <= mpscbufferMAX_MESSAGE ) );
+
+    if( pxBuffer->xUsed == 0U )
+    {
+        /* Nothing is stored or reserved, so start again at the beginning
+         * where the whole storage area is contiguous. */
+        pxBuffer->xHead = 0U;
+        pxBuffer->xTail = 0U;
+    }
+
+    xHead = pxBuffer->xHead;
+
+    if( ( xHead >= pxBuffer->xTail ) && ( pxBuffer->xUsed < pxBuffer->xSize ) )
+    {
+        /* The free space is after the head and before the tail. */
+        if( xNeeded <= ( pxBuffer->xSize - xHead ) )
+        {
+            pucHeader = &( pxBuffer->pucStorage[ xHead ] );
+        }
+        else if( xNeeded <= pxBuffer->xTail )
+        {
+            /* Skip to the start.  If there is room, mark the space skipped
+             * so the reader knows to do the same, otherwise it works it out
+             * from there not being room for a header. */
+            xSkip = pxBuffer->xSize - xHead;
+
+            if( xSkip >= mpscbufferHEADER_BYTES )
+            {
+                pxBuffer->pucStorage[ xHead ] = mpscSKIP;
+                pxBuffer->pucStorage[ xHead + 1U ] = 0U;
+            }
+
+            pxBuffer->xUsed += xSkip;
+            xHead = 0U;
+            pucHeader = pxBuffer->pucStorage;
+        }
+    }
+    else if( xHead < pxBuffer->xTail )
+    {
+        if( xNeeded <= ( pxBuffer->xTail - xHead ) )
+        {
+            pucHeader = &( pxBuffer->pucStorage[ xHead ] );
+        }
+    }
+
+    if( pucHeader != NULL )
+    {
+        pucHeader[ 0 ] = ( uint8_t ) ( ( xLength >> 8 ) & mpscLENGTH_HIGH );
+        pucHeader[ 1 ] = ( uint8_t ) xLength;
+
+        pxBuffer->xUsed += xNeeded;
+        xHead += xNeeded;
+
+        if( xHead == pxBuffer->xSize )
+        {
+            xHead = 0U;
+        }
+
+        pxBuffer->xHead = xHead;
+        pucHeader += mpscbufferHEADER_BYTES;
+    }
+    else
+    {
+        pxBuffer->usDropped++;
+    }
+
+    return pucHeader;
+}
+/*-----------------------------------------------------------*/
+
+static TaskHandle_t prvCommit( MpscBuffer_t * pxBuffer,
+                               void * pvMessage )
+{
+    uint8_t * const pucHeader = ( uint8_t * ) pvMessage - mpscbufferHEADER_BYTES;
+    TaskHandle_t xReader;
+
+    configASSERT( ( pucHeader[ 0 ] & ( mpscCOMMITTED | mpscSKIP ) ) == 0U );
+
+    pucHeader[ 0 ] |= mpscCOMMITTED;
+
+    xReader = pxBuffer->xTaskWaitingToReceive;
+    pxBuffer->xTaskWaitingToReceive = NULL;
+
+    return xReader;
+}
+/*-----------------------------------------------------------*/
+
+static uint8_t * prvOldestMessage( MpscBuffer_t * pxBuffer,
+                                   size_t * pxLength )
+{
+    const uint8_t * pucHeader;
+    size_t xRemaining;
+
+    while( pxBuffer->xUsed > 0U )
+    {
+        xRemaining = pxBuffer->xSize - pxBuffer->xTail;
+        pucHeader = &( pxBuffer->pucStorage[ pxBuffer->xTail ] );
+
+        if( ( xRemaining < mpscbufferHEADER_BYTES ) || ( ( pucHeader[ 0 ] & mpscSKIP ) != 0U ) )
+        {
+            /* A writer wrapped here, follow it back to the start. */
+            pxBuffer->xUsed -= xRemaining;
+            pxBuffer->xTail = 0U;
+        }
+        else if( ( pucHeader[ 0 ] & mpscCOMMITTED ) != 0U )
+        {
+            *pxLength = ( ( size_t ) ( pucHeader[ 0 ] & mpscLENGTH_HIGH ) << 8 ) | ( size_t ) pucHeader[ 1 ];
+            return ( uint8_t * ) pucHeader + mpscbufferHEADER_BYTES;
+        }
+        else
+        {
+            /* Still being written.  Anything reserved after it waits too. */
+            break;
+        }
+    }
+
+    return NULL;
+}
+/*-----------------------------------------------------------*/
+
+void * pvMpscBufferReserve( MpscBuffer_t * pxBuffer,
+                            size_t xLength )
+{
+    void * pvMessage;
+
+    configASSERT( pxBuffer );
+
+    taskENTER_CRITICAL();
+    {
+        pvMessage = prvReserve( pxBuffer, xLength );
+    }
+    taskEXIT_CRITICAL();
+
+    return pvMessage;
+}
+/*-----------------------------------------------------------*/
+
+void vMpscBufferCommit( MpscBuffer_t * pxBuffer,
+                        void * pvMessage )
+{
+    TaskHandle_t xReader;
+
+    configASSERT( pxBuffer );
+    configASSERT( pvMessage );
+
+    taskENTER_CRITICAL();
+    {
+        xReader = prvCommit( pxBuffer, pvMessage );
+    }
+    taskEXIT_CRITICAL();
+
+    if( xReader != NULL )
+    {
+        ( void ) xTaskNotify( xReader, ( uint32_t ) 0, eNoAction );
+    }
+}
+/*-----------------------------------------------------------*/
+
+void * pvMpscBufferReserveFromISR( MpscBuffer_t * pxBuffer,
+                                   size_t xLength )
+{
+    void * pvMessage;
+    UBaseType_t uxSavedInterruptStatus;
+
+    configASSERT( pxBuffer );
+
+    uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+    {
+        pvMessage = prvReserve( pxBuffer, xLength );
+    }
+    portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+
+    return pvMessage;
+}
+/*-----------------------------------------------------------*/
+
+void vMpscBufferCommitFromISR( MpscBuffer_t * pxBuffer,
+                               void * pvMessage,
+                               BaseType_t * const pxHigherPriorityTaskWoken )
+{
+    TaskHandle_t xReader;
+    UBaseType_t uxSavedInterruptStatus;
+
+    configASSERT( pxBuffer );
+    configASSERT( pvMessage );
+
+    uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+    {
+        xReader = prvCommit( pxBuffer, pvMessage );
+    }
+    portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+
+    if( xReader != NULL )
+    {
+        ( void ) xTaskNotifyFromISR( xReader, ( uint32_t ) 0, eNoAction, pxHigherPriorityTaskWoken );
+    }
+}
+/*-----------------------------------------------------------*/
+
+size_t xMpscBufferSend( MpscBuffer_t * pxBuffer,
+                        const void * pvMessage,
+                        size_t xLength )
+{
+    void * pvSpace = pvMpscBufferReserve( pxBuffer, xLength );
+
+    if( pvSpace == NULL )
+    {
+        return 0U;
+    }
+
+    ( void ) memcpy( pvSpace, pvMessage, xLength );
+    vMpscBufferCommit( pxBuffer, pvSpace );
+
+    return xLength;
+}
+/*-----------------------------------------------------------*/
+
+size_t xMpscBufferSendFromISR( MpscBuffer_t * pxBuffer,
+                               const void * pvMessage,
+                               size_t xLength,
+                               BaseType_t * const pxHigherPriorityTaskWoken )
+{
+    void * pvSpace = pvMpscBufferReserveFromISR( pxBuffer, xLength );
+
+    if( pvSpace == NULL )
+    {
+        return 0U;
+    }
+
+    ( void ) memcpy( pvSpace, pvMessage, xLength );
+    vMpscBufferCommitFromISR( pxBuffer, pvSpace, pxHigherPriorityTaskWoken );
+
+    return xLength;
+}
+/*-----------------------------------------------------------*/
+
+size_t xMpscBufferReceive( MpscBuffer_t * pxBuffer,
+                           void * pvBuffer,
+                           size_t xBufferLength,
+                           TickType_t xTicksToWait )
+{
+    TimeOut_t xTimeOut;
+    uint8_t * pucMessage;
+    size_t xLength = 0U;
+
+    configASSERT( pxBuffer );
+    configASSERT( pvBuffer );
+
+    vTaskSetTimeOutState( &xTimeOut );
+
+    for( ; ; )
+    {
+        taskENTER_CRITICAL();
+        {
+            pucMessage = prvOldestMessage( pxBuffer, &xLength );
+
+            if( ( pucMessage == NULL ) && ( xTicksToWait != ( TickType_t ) 0 ) )
+            {
+                /* Clear any stale notification before asking writers for a
+                 * new one, as the stream buffer does. */
+                ( void ) xTaskNotifyStateClear( NULL );
+                configASSERT( pxBuffer->xTaskWaitingToReceive == NULL );
+                pxBuffer->xTaskWaitingToReceive = xTaskGetCurrentTaskHandle();
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        if( ( pucMessage != NULL ) || ( xTicksToWait == ( TickType_t ) 0 ) )
+        {
+            break;
+        }
+
+        if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE )
+        {
+            ( void ) xTaskNotifyWait( ( uint32_t ) 0, ( uint32_t ) 0, NULL, xTicksToWait );
+        }
+        else
+        {
+            xTicksToWait = ( TickType_t ) 0;
+        }
+
+        /* A commit clears this when it wakes the reader, but not on a time
+         * out.  Writers read it from interrupts, so it is never changed with
+         * interrupts enabled. */
+        taskENTER_CRITICAL();
+        {
+            pxBuffer->xTaskWaitingToReceive = NULL;
+        }
+        taskEXIT_CRITICAL();
+    }
+
+    if( pucMessage == NULL )
+    {
+        return 0U;
+    }
+
+    if( xLength > xBufferLength )
+    {
+        /* Leave it for a larger buffer, as a message buffer would. */
+        return 0U;
+    }
+
+    /* Only the reader moves the tail, so the message can be copied out with
+     * interrupts enabled. */
+    ( void ) memcpy( pvBuffer, pucMessage, xLength );
+
+    taskENTER_CRITICAL();
+    {
+        pxBuffer->xTail += mpscbufferHEADER_BYTES + xLength;
+        pxBuffer->xUsed -= mpscbufferHEADER_BYTES + xLength;
+
+        if( pxBuffer->xTail == pxBuffer->xSize )
+        {
+            pxBuffer->xTail = 0U;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    return xLength;
+}
+/*-----------------------------------------------------------*/
+
+uint16_t usMpscBufferGetDropped( const MpscBuffer_t * pxBuffer )
+{
+    configASSERT( pxBuffer );
+
+    return pxBuffer->usDropped;
+}
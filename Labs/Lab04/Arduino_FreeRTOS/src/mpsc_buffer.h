@@ -0,0 +1,196 @@
+/*
+ * This file is NOT part of the FreeRTOS distribution.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+/*
+ * A multi-producer, single-consumer message buffer.
+ *
+ * stream_buffer.c assumes a single writer, so tasks that share a stream or
+ * message buffer have to serialise every send behind a mutex.  Here writers
+ * instead reserve space for a message in a short critical section, fill it in
+ * with interrupts enabled, and then commit it.  Any number of tasks and
+ * interrupts may write at once; only the bookkeeping is serialised, never the
+ * copy.
+ *
+ * Messages are delivered in the order their space was reserved.  If a writer
+ * is preempted between reserving and committing, messages reserved after it
+ * are held back until it commits, so the reader never sees a gap.
+ *
+ * Each message is stored contiguously behind a two byte header, so a reserved
+ * region can be written in place - formatted straight into the buffer, for
+ * example.  A message that does not fit before the end of the storage area
+ * starts again at the beginning, and the space skipped is reclaimed when the
+ * reader passes it.
+ *
+ * Writers never block.  When the buffer is full the message is dropped and
+ * counted, which suits logging and telemetry, where stalling a control task
+ * would be worse than losing a line.  The single reader may block waiting for
+ * a message.
+ */
+
+#ifndef MPSC_BUFFER_H
+#define MPSC_BUFFER_H
+
+#ifndef INC_ARDUINO_FREERTOS_H
+    #error "include Arduino_FreeRTOS.h must appear in source files before include mpsc_buffer.h"
+#endif
+
+#include "task.h"
+
+/* *INDENT-OFF* */
+#if defined( __cplusplus )
+    extern "C" {
+#endif
+/* *INDENT-ON* */
+
+/* Bytes of header stored in front of each message. */
+#define mpscbufferHEADER_BYTES    ( ( size_t ) 2U )
+
+/* The largest message the header can describe. */
+#define mpscbufferMAX_MESSAGE     ( ( size_t ) 0x3FFFU )
+
+/**
+ * A multi-producer message buffer.  Declare with mpscbufferDEFINE().  The
+ * members are private to mpsc_buffer.c.
+ */
+typedef struct MpscBuffer
+{
+    uint8_t * pucStorage;                         /*< xSize bytes of message storage. */
+    size_t xSize;                                 /*< Size of the storage area. */
+    size_t xHead;                                 /*< Where the next reservation starts. */
+    size_t xTail;                                 /*< Header of the oldest message not yet read. */
+    size_t xUsed;                                 /*< Bytes between tail and head, including skipped space. */
+    volatile TaskHandle_t xTaskWaitingToReceive;  /*< The reader, while it is blocked. */
+    uint16_t usDropped;                           /*< Messages lost because the buffer was full. */
+} MpscBuffer_t;
+
+/**
+ * Define a message buffer with xSizeBytes bytes of statically allocated
+ * storage.  Each message takes its length plus mpscbufferHEADER_BYTES.
+ *
+ * Example usage:
+ * <pre>
+ * mpscbufferDEFINE( xLog, 256 );
+ *
+ * // Any task or interrupt.
+ * xMpscBufferSend( &xLog, "tick\n", 5 );
+ *
+ * // The one reader.
+ * char cLine[ 64 ];
+ * size_t xLength = xMpscBufferReceive( &xLog, cLine, sizeof( cLine ), portMAX_DELAY );
+ * </pre>
+ */
+#define mpscbufferDEFINE( xName, xSizeBytes )                                    \
+    static uint8_t xName ## Storage[ ( xSizeBytes ) ];                           \
+    MpscBuffer_t xName = { xName ## Storage, ( xSizeBytes ), 0U, 0U, 0U, NULL, 0U }
+
+/**
+ * Reserve space for a message of xLength bytes.  The caller fills in the
+ * returned space and must then pass it to vMpscBufferCommit(), promptly -
+ * later messages are not delivered until it does.  Never blocks.
+ *
+ * @param pxBuffer The buffer to write to.
+ * @param xLength The length of the message, 1 to mpscbufferMAX_MESSAGE bytes.
+ *
+ * @return Where to write the message, or NULL if the buffer is too full, in
+ * which case the message is counted as dropped.
+ */
+void * pvMpscBufferReserve( MpscBuffer_t * pxBuffer,
+                            size_t xLength ) PRIVILEGED_FUNCTION;
+
+/**
+ * Publish a message reserved with pvMpscBufferReserve(), waking the reader if
+ * it is blocked.
+ *
+ * @param pxBuffer The buffer the space was reserved from.
+ * @param pvMessage The pointer pvMpscBufferReserve() returned.
+ */
+void vMpscBufferCommit( MpscBuffer_t * pxBuffer,
+                        void * pvMessage ) PRIVILEGED_FUNCTION;
+
+/**
+ * Versions of pvMpscBufferReserve() and vMpscBufferCommit() that can be
+ * called from an interrupt service routine.
+ *
+ * @param pxHigherPriorityTaskWoken Set to pdTRUE if the commit unblocked the
+ * reader and it has a priority above the interrupted task.
+ */
+void * pvMpscBufferReserveFromISR( MpscBuffer_t * pxBuffer,
+                                   size_t xLength ) PRIVILEGED_FUNCTION;
+void vMpscBufferCommitFromISR( MpscBuffer_t * pxBuffer,
+                               void * pvMessage,
+                               BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/**
+ * Copy a message into the buffer - a reserve, copy and commit in one call.
+ * Never blocks.
+ *
+ * @param pxBuffer The buffer to write to.
+ * @param pvMessage The message to copy.
+ * @param xLength The length of the message in bytes.
+ *
+ * @return xLength, or 0 if the message was dropped because the buffer was
+ * full.
+ */
+size_t xMpscBufferSend( MpscBuffer_t * pxBuffer,
+                        const void * pvMessage,
+                        size_t xLength ) PRIVILEGED_FUNCTION;
+
+/**
+ * A version of xMpscBufferSend() that can be called from an interrupt service
+ * routine.
+ */
+size_t xMpscBufferSendFromISR( MpscBuffer_t * pxBuffer,
+                               const void * pvMessage,
+                               size_t xLength,
+                               BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/**
+ * Receive the oldest message.  Only one task may receive from a buffer.  While
+ * it is blocked the reader waits on its task notification, as a stream buffer
+ * reader does, so it should not rely on notifications for anything else.
+ *
+ * @param pxBuffer The buffer to read from.
+ * @param pvBuffer Where to copy the message.
+ * @param xBufferLength The size of pvBuffer.  As with message buffers, a
+ * message longer than this is left in the buffer and 0 is returned.
+ * @param xTicksToWait The maximum time to block for a message to be
+ * committed.
+ *
+ * @return The length of the message received, or 0 if there was none.
+ */
+size_t xMpscBufferReceive( MpscBuffer_t * pxBuffer,
+                           void * pvBuffer,
+                           size_t xBufferLength,
+                           TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * @return The number of messages dropped because the buffer was full.
+ */
+uint16_t usMpscBufferGetDropped( const MpscBuffer_t * pxBuffer ) PRIVILEGED_FUNCTION;
+
+/* *INDENT-OFF* */
+#if defined( __cplusplus )
+    }
+#endif
+/* *INDENT-ON* */
+
+#endif /* MPSC_BUFFER_H */
@@ -0,0 +1,395 @@
+/*
+ * This file is NOT part of the FreeRTOS distribution.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+/* Standard includes. */
+#include <stddef.h>
+
+/* FreeRTOS includes. */
+#include "Arduino_FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "timers.h"
+#include "object_pool.h"
+
+#if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+
+/* Recover a slot from the handle of the object embedded in it. */
+#define objectpoolSLOT( xType, xMember, pvHandle ) \
+    ( ( xType * ) ( ( uint8_t * ) ( pvHandle ) - offsetof( xType, xMember ) ) )
+
+/*
+ * Take a slot from a pool, preferring released slots over ones never used.
+ * *pxIsNew is set to pdTRUE if the object in the slot has yet to be created.
+ */
+static void * prvTakeSlot( ObjectPoolCore_t * pxCore,
+                           BaseType_t * pxIsNew );
+
+/*
+ * Return a slot to its pool.
+ */
+static void prvGiveSlot( ObjectPoolCore_t * pxCore,
+                         ObjectPoolLink_t * pxLink );
+
+static void prvGetStats( ObjectPoolCore_t * pxCore,
+                         ObjectPoolStats_t * pxStats );
+
+/*
+ * The function run by every pooled worker.
+ */
+static portTASK_FUNCTION_PROTO( prvWorkerTask, pvParameters );
+
+#if ( configUSE_TIMERS == 1 )
+    static void prvTimerTrampoline( TimerHandle_t xTimer );
+    static void prvReturnTimer( void * pvSlot,
+                                uint32_t ulUnused );
+#endif
+
+/*-----------------------------------------------------------*/
+
+static void * prvTakeSlot( ObjectPoolCore_t * pxCore,
+                           BaseType_t * pxIsNew )
+{
+    ObjectPoolLink_t * pxLink = NULL;
+
+    *pxIsNew = pdFALSE;
+
+    taskENTER_CRITICAL();
+    {
+        if( pxCore->pxFreeList != NULL )
+        {
+            pxLink = pxCore->pxFreeList;
+            pxCore->pxFreeList = pxLink->pxNext;
+        }
+        else if( pxCore->uxNextUnused < pxCore->uxCapacity )
+        {
+            pxLink = ( ObjectPoolLink_t * ) ( ( uint8_t * ) pxCore->pvSlots + ( pxCore->uxNextUnused * pxCore->xSlotSize ) );
+            pxCore->uxNextUnused++;
+            *pxIsNew = pdTRUE;
+        }
+
+        if( pxLink != NULL )
+        {
+            pxCore->uxInUse++;
+            pxCore->ulAcquisitions++;
+
+            if( pxCore->uxInUse > pxCore->uxHighWater )
+            {
+                pxCore->uxHighWater = pxCore->uxInUse;
+            }
+        }
+        else
+        {
+            pxCore->uxFailures++;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    return pxLink;
+}
+/*-----------------------------------------------------------*/
+
+static void prvGiveSlot( ObjectPoolCore_t * pxCore,
+                         ObjectPoolLink_t * pxLink )
+{
+    taskENTER_CRITICAL();
+    {
+        pxLink->pxNext = pxCore->pxFreeList;
+        pxCore->pxFreeList = pxLink;
+        pxCore->uxInUse--;
+    }
+    taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+static void prvGetStats( ObjectPoolCore_t * pxCore,
+                         ObjectPoolStats_t * pxStats )
+{
+    configASSERT( pxStats );
+
+    taskENTER_CRITICAL();
+    {
+        pxStats->uxCapacity = pxCore->uxCapacity;
+        pxStats->uxInUse = pxCore->uxInUse;
+        pxStats->uxHighWater = pxCore->uxHighWater;
+        pxStats->uxFailures = pxCore->uxFailures;
+        pxStats->ulAcquisitions = pxCore->ulAcquisitions;
+    }
+    taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+static portTASK_FUNCTION( prvWorkerTask, pvParameters )
+{
+    TaskPoolWorker_t * pxWorker = ( TaskPoolWorker_t * ) pvParameters;
+
+    for( ; ; )
+    {
+        /* A worker may be handed its next job before it gets back here, in
+         * which case the notification is already pending and this returns at
+         * once. */
+        ( void ) ulTaskNotifyTake( pdTRUE, portMAX_DELAY );
+
+        pxWorker->pxJob( pxWorker->pvParameters );
+
+        prvGiveSlot( &( pxWorker->pxPool->xCore ), &( pxWorker->xLink ) );
+    }
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xTaskPoolSpawn( TaskPool_t * pxPool,
+                           TaskPoolJob_t pxJob,
+                           void * pvParameters,
+                           UBaseType_t uxPriority,
+                           TaskHandle_t * const pxCreatedTask )
+{
+    TaskPoolWorker_t * pxWorker;
+    BaseType_t xIsNew;
+    size_t xIndex;
+
+    configASSERT( pxPool );
+    configASSERT( pxJob );
+
+    pxWorker = ( TaskPoolWorker_t * ) prvTakeSlot( &( pxPool->xCore ), &xIsNew );
+
+    if( pxWorker == NULL )
+    {
+        return errCOULD_NOT_ALLOCATE_REQUIRED_MEMORY;
+    }
+
+    pxWorker->pxJob = pxJob;
+    pxWorker->pvParameters = pvParameters;
+
+    if( xIsNew != pdFALSE )
+    {
+        /* First use of this slot, so the worker has to be created.  It starts
+         * at the requested priority and picks up the notification below. */
+        xIndex = ( size_t ) ( pxWorker - ( TaskPoolWorker_t * ) pxPool->xCore.pvSlots );
+        pxWorker->pxPool = pxPool;
+        pxWorker->xHandle = xTaskCreateStatic( prvWorkerTask,
+                                               pxPool->pcName,
+                                               pxPool->usStackDepth,
+                                               pxWorker,
+                                               uxPriority,
+                                               pxPool->puxStacks + ( xIndex * pxPool->usStackDepth ),
+                                               &( pxWorker->xTCB ) );
+    }
+    else
+    {
+        vTaskPrioritySet( pxWorker->xHandle, uxPriority );
+    }
+
+    if( pxCreatedTask != NULL )
+    {
+        *pxCreatedTask = pxWorker->xHandle;
+    }
+
+    ( void ) xTaskNotifyGive( pxWorker->xHandle );
+
+    return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+void vTaskPoolGetStats( TaskPool_t * pxPool,
+                        ObjectPoolStats_t * pxStats )
+{
+    configASSERT( pxPool );
+
+    prvGetStats( &( pxPool->xCore ), pxStats );
+}
+/*-----------------------------------------------------------*/
+
+QueueHandle_t xQueuePoolAcquire( QueuePool_t * pxPool )
+{
+    QueuePoolSlot_t * pxSlot;
+    BaseType_t xIsNew;
+    size_t xIndex;
+
+    configASSERT( pxPool );
+
+    pxSlot = ( QueuePoolSlot_t * ) prvTakeSlot( &( pxPool->xCore ), &xIsNew );
+
+    if( pxSlot == NULL )
+    {
+        return NULL;
+    }
+
+    if( xIsNew != pdFALSE )
+    {
+        xIndex = ( size_t ) ( pxSlot - ( QueuePoolSlot_t * ) pxPool->xCore.pvSlots );
+        pxSlot->pxPool = pxPool;
+        ( void ) xQueueCreateStatic( pxPool->uxQueueLength,
+                                     pxPool->uxItemSize,
+                                     pxPool->pucStorage + ( xIndex * pxPool->uxQueueLength * pxPool->uxItemSize ),
+                                     &( pxSlot->xQueueBuffer ) );
+    }
+
+    return ( QueueHandle_t ) &( pxSlot->xQueueBuffer );
+}
+/*-----------------------------------------------------------*/
+
+void vQueuePoolRelease( QueueHandle_t xQueue )
+{
+    QueuePoolSlot_t * pxSlot;
+
+    configASSERT( xQueue );
+
+    pxSlot = objectpoolSLOT( QueuePoolSlot_t, xQueueBuffer, xQueue );
+
+    /* Reset before the queue is reachable from the free list, so the next
+     * owner always starts with an empty queue. */
+    ( void ) xQueueReset( xQueue );
+    prvGiveSlot( &( pxSlot->pxPool->xCore ), &( pxSlot->xLink ) );
+}
+/*-----------------------------------------------------------*/
+
+void vQueuePoolGetStats( QueuePool_t * pxPool,
+                         ObjectPoolStats_t * pxStats )
+{
+    configASSERT( pxPool );
+
+    prvGetStats( &( pxPool->xCore ), pxStats );
+}
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_TIMERS == 1 )
+
+    static void prvTimerTrampoline( TimerHandle_t xTimer )
+    {
+        TimerPoolSlot_t * pxSlot = ( TimerPoolSlot_t * ) pvTimerGetTimerID( xTimer );
+        TimerCallbackFunction_t pxCallback = pxSlot->pxCallback;
+
+        /* NULL once the timer has been released but before the stop command
+         * has been processed. */
+        if( pxCallback != NULL )
+        {
+            pxCallback( xTimer );
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvReturnTimer( void * pvSlot,
+                                uint32_t ulUnused )
+    {
+        TimerPoolSlot_t * pxSlot = ( TimerPoolSlot_t * ) pvSlot;
+
+        ( void ) ulUnused;
+
+        prvGiveSlot( &( pxSlot->pxPool->xCore ), &( pxSlot->xLink ) );
+    }
+/*-----------------------------------------------------------*/
+
+    TimerHandle_t xTimerPoolAcquire( TimerPool_t * pxPool,
+                                     TimerCallbackFunction_t pxCallback,
+                                     void * pvTimerID,
+                                     UBaseType_t uxAutoReload )
+    {
+        TimerPoolSlot_t * pxSlot;
+        BaseType_t xIsNew;
+        TimerHandle_t xTimer;
+
+        configASSERT( pxPool );
+        configASSERT( pxCallback );
+
+        pxSlot = ( TimerPoolSlot_t * ) prvTakeSlot( &( pxPool->xCore ), &xIsNew );
+
+        if( pxSlot == NULL )
+        {
+            return NULL;
+        }
+
+        xTimer = ( TimerHandle_t ) &( pxSlot->xTimerBuffer );
+        pxSlot->pvTimerID = pvTimerID;
+        pxSlot->pxCallback = pxCallback;
+
+        if( xIsNew != pdFALSE )
+        {
+            /* The period is a placeholder, the owner sets the real one when it
+             * starts the timer with xTimerChangePeriod(). */
+            pxSlot->pxPool = pxPool;
+            ( void ) xTimerCreateStatic( pxPool->pcName,
+                                         1,
+                                         uxAutoReload,
+                                         pxSlot,
+                                         prvTimerTrampoline,
+                                         &( pxSlot->xTimerBuffer ) );
+        }
+        else
+        {
+            vTimerSetReloadMode( xTimer, uxAutoReload );
+        }
+
+        return xTimer;
+    }
+/*-----------------------------------------------------------*/
+
+    BaseType_t xTimerPoolRelease( TimerHandle_t xTimer,
+                                  TickType_t xTicksToWait )
+    {
+        TimerPoolSlot_t * pxSlot;
+        TimerCallbackFunction_t pxCallback;
+
+        configASSERT( xTimer );
+
+        pxSlot = objectpoolSLOT( TimerPoolSlot_t, xTimerBuffer, xTimer );
+        pxCallback = pxSlot->pxCallback;
+        pxSlot->pxCallback = NULL;
+
+        if( xTimerStop( xTimer, xTicksToWait ) != pdPASS )
+        {
+            pxSlot->pxCallback = pxCallback;
+            return pdFAIL;
+        }
+
+        /* Commands are processed in order, so by the time prvReturnTimer()
+         * runs in the timer service task the timer is no longer active. */
+        if( xTimerPendFunctionCall( prvReturnTimer, pxSlot, 0UL, xTicksToWait ) != pdPASS )
+        {
+            /* The stop is still ahead of anything the next owner queues, so
+             * the worst case is one expiry that was already due being
+             * dropped by the trampoline. */
+            prvGiveSlot( &( pxSlot->pxPool->xCore ), &( pxSlot->xLink ) );
+        }
+
+        return pdPASS;
+    }
+/*-----------------------------------------------------------*/
+
+    void * pvTimerPoolGetID( TimerHandle_t xTimer )
+    {
+        configASSERT( xTimer );
+
+        return ( ( TimerPoolSlot_t * ) pvTimerGetTimerID( xTimer ) )->pvTimerID;
+    }
+/*-----------------------------------------------------------*/
+
+    void vTimerPoolGetStats( TimerPool_t * pxPool,
+                             ObjectPoolStats_t * pxStats )
+    {
+        configASSERT( pxPool );
+
+        prvGetStats( &( pxPool->xCore ), pxStats );
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* configUSE_TIMERS */
+
+#endif /* configSUPPORT_STATIC_ALLOCATION */
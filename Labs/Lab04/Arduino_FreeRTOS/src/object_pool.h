@@ -0,0 +1,326 @@
+/*
+ * This file is NOT part of the FreeRTOS distribution.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+/*
+ * Pools of kernel objects whose memory is reserved up front, so tasks, queues
+ * and timers can be handed out and given back in constant time without
+ * touching the heap.
+ *
+ *   + A task pool owns a fixed set of worker tasks.  xTaskPoolSpawn() hands a
+ *     job to an idle worker and wakes it; when the job function returns the
+ *     worker goes straight back to the pool.  Nothing is deleted, so reuse
+ *     does not wait for the idle task to free the TCB and stack, and stacks
+ *     are only painted once.
+ *
+ *   + A queue pool holds queues of one length and item size.  A released
+ *     queue is reset and handed to the next caller.
+ *
+ *   + A timer pool holds software timers whose callback and ID are set when
+ *     the timer is acquired.
+ *
+ * Each object is created with the xxxCreateStatic() API the first time its
+ * slot is handed out, after which the slot is only ever recycled.  Pools are
+ * declared statically and need no initialisation.
+ *
+ * configSUPPORT_STATIC_ALLOCATION must be set to 1 in FreeRTOSConfig.h, and timer
+ * pools also need INCLUDE_xTimerPendFunctionCall.
+ */
+
+#ifndef OBJECT_POOL_H
+#define OBJECT_POOL_H
+
+#ifndef INC_ARDUINO_FREERTOS_H
+    #error "include Arduino_FreeRTOS.h must appear in source files before include object_pool.h"
+#endif
+
+#include "task.h"
+#include "queue.h"
+#include "timers.h"
+
+/* *INDENT-OFF* */
+#if defined( __cplusplus )
+    extern "C" {
+#endif
+/* *INDENT-ON* */
+
+/**
+ * Free list link placed at the start of every pool slot.  Private to
+ * object_pool.c.
+ */
+typedef struct ObjectPoolLink
+{
+    struct ObjectPoolLink * pxNext;
+} ObjectPoolLink_t;
+
+/**
+ * Bookkeeping shared by every kind of pool.  Private to object_pool.c.
+ */
+typedef struct ObjectPoolCore
+{
+    void * pvSlots;                      /*< uxCapacity slots of xSlotSize bytes. */
+    size_t xSlotSize;                    /*< Size of one slot. */
+    UBaseType_t uxCapacity;              /*< Number of slots in the pool. */
+    UBaseType_t uxNextUnused;            /*< Index of the first slot never handed out. */
+    ObjectPoolLink_t * pxFreeList;       /*< Released slots, ready for reuse. */
+    UBaseType_t uxInUse;                 /*< Slots currently handed out. */
+    UBaseType_t uxHighWater;             /*< Largest value uxInUse has reached. */
+    UBaseType_t uxFailures;              /*< Requests that found the pool empty. */
+    uint32_t ulAcquisitions;             /*< Total successful requests. */
+} ObjectPoolCore_t;
+
+/**
+ * A snapshot of a pool's usage, see vTaskPoolGetStats() and friends.
+ */
+typedef struct ObjectPoolStats
+{
+    UBaseType_t uxCapacity;              /*< Number of objects in the pool. */
+    UBaseType_t uxInUse;                 /*< Objects not yet given back. */
+    UBaseType_t uxHighWater;             /*< Most objects ever in use at once. */
+    UBaseType_t uxFailures;              /*< Requests that found the pool empty. */
+    uint32_t ulAcquisitions;             /*< Total successful requests. */
+} ObjectPoolStats_t;
+
+#define objectpoolCORE( xSlots, uxCapacity ) \
+    { ( xSlots ), sizeof( ( xSlots )[ 0 ] ), ( uxCapacity ), 0U, NULL, 0U, 0U, 0U, 0UL }
+
+/*-----------------------------------------------------------
+ * Task pools
+ *----------------------------------------------------------*/
+
+/**
+ * A job run by a pooled worker.  Unlike a task function, a job returns when
+ * it is done and must not call vTaskDelete( NULL ).
+ */
+typedef void (* TaskPoolJob_t)( void * pvParameters );
+
+/**
+ * One worker.  Private to object_pool.c.
+ */
+typedef struct TaskPoolWorker
+{
+    ObjectPoolLink_t xLink;              /*< Must be first. */
+    struct TaskPool * pxPool;            /*< Pool the worker belongs to. */
+    TaskHandle_t xHandle;                /*< NULL until the worker is first spawned. */
+    TaskPoolJob_t pxJob;                 /*< Job to run on the next wake up. */
+    void * pvParameters;                 /*< Passed to pxJob. */
+    StaticTask_t xTCB;
+} TaskPoolWorker_t;
+
+/**
+ * A pool of worker tasks.  Declare with taskpoolDEFINE().
+ */
+typedef struct TaskPool
+{
+    ObjectPoolCore_t xCore;              /*< Must be first. */
+    const char * pcName;                 /*< Name given to every worker. */
+    StackType_t * puxStacks;             /*< uxCapacity stacks of usStackDepth words. */
+    configSTACK_DEPTH_TYPE usStackDepth; /*< Stack depth of each worker. */
+} TaskPool_t;
+
+/**
+ * Define a pool of uxWorkerCount workers, each with a stack of usStackDepth
+ * words, with the TCBs and stacks allocated statically.
+ *
+ * Example usage:
+ * <pre>
+ * taskpoolDEFINE( xWorkers, 2, 128 );
+ *
+ * void vBlinkOnce( void * pvParameters )
+ * {
+ *     ... runs on a pooled worker, then returns ...
+ * }
+ *
+ * xTaskPoolSpawn( &xWorkers, vBlinkOnce, NULL, 1, NULL );
+ * </pre>
+ */
+#define taskpoolDEFINE( xName, uxWorkerCount, usStackDepth )                           \
+    static TaskPoolWorker_t xName ## Workers[ ( uxWorkerCount ) ];                      \
+    static StackType_t xName ## Stacks[ ( uxWorkerCount ) * ( size_t ) ( usStackDepth ) ]; \
+    TaskPool_t xName = { objectpoolCORE( xName ## Workers, ( uxWorkerCount ) ), #xName, xName ## Stacks, ( usStackDepth ) }
+
+/**
+ * Run a job on an idle worker from the pool.  The worker takes uxPriority
+ * while it runs the job and returns to the pool as soon as the job returns.
+ * Never blocks.
+ *
+ * @param pxPool The pool to take a worker from.
+ * @param pxJob The job to run.
+ * @param pvParameters Passed to pxJob.
+ * @param uxPriority Priority to run the job at.
+ * @param pxCreatedTask Optionally receives the worker's handle, which is only
+ * valid until the job returns.
+ *
+ * @return pdPASS, or errCOULD_NOT_ALLOCATE_REQUIRED_MEMORY if every worker is
+ * busy.
+ */
+BaseType_t xTaskPoolSpawn( TaskPool_t * pxPool,
+                           TaskPoolJob_t pxJob,
+                           void * pvParameters,
+                           UBaseType_t uxPriority,
+                           TaskHandle_t * const pxCreatedTask ) PRIVILEGED_FUNCTION;
+
+/**
+ * Take a consistent snapshot of a task pool's usage counters.
+ */
+void vTaskPoolGetStats( TaskPool_t * pxPool,
+                        ObjectPoolStats_t * pxStats ) PRIVILEGED_FUNCTION;
+
+/*-----------------------------------------------------------
+ * Queue pools
+ *----------------------------------------------------------*/
+
+/**
+ * One queue.  Private to object_pool.c.
+ */
+typedef struct QueuePoolSlot
+{
+    ObjectPoolLink_t xLink;              /*< Must be first. */
+    struct QueuePool * pxPool;           /*< Pool the queue belongs to. */
+    StaticQueue_t xQueueBuffer;          /*< The queue handle points here. */
+} QueuePoolSlot_t;
+
+/**
+ * A pool of queues of the same length and item size.  Declare with
+ * queuepoolDEFINE().
+ */
+typedef struct QueuePool
+{
+    ObjectPoolCore_t xCore;              /*< Must be first. */
+    uint8_t * pucStorage;                /*< Item storage for every queue. */
+    UBaseType_t uxQueueLength;           /*< Items each queue can hold. */
+    UBaseType_t uxItemSize;              /*< Size of one item in bytes. */
+} QueuePool_t;
+
+/**
+ * Define a pool of uxQueueCount queues that each hold uxQueueLength items of
+ * uxItemSize bytes, with the queues and their storage allocated statically.
+ */
+#define queuepoolDEFINE( xName, uxQueueCount, uxQueueLength, uxItemSize )                          \
+    static QueuePoolSlot_t xName ## Slots[ ( uxQueueCount ) ];                                      \
+    static uint8_t xName ## Storage[ ( uxQueueCount ) * ( size_t ) ( uxQueueLength ) * ( uxItemSize ) ]; \
+    QueuePool_t xName = { objectpoolCORE( xName ## Slots, ( uxQueueCount ) ), xName ## Storage, ( uxQueueLength ), ( uxItemSize ) }
+
+/**
+ * Take an empty queue from the pool.  Never blocks.
+ *
+ * @return The queue, or NULL if the pool is empty.
+ */
+QueueHandle_t xQueuePoolAcquire( QueuePool_t * pxPool ) PRIVILEGED_FUNCTION;
+
+/**
+ * Give a queue back to its pool.  Any items left in it are discarded.  No task
+ * may be blocked on the queue, or use the handle, after it is released.
+ */
+void vQueuePoolRelease( QueueHandle_t xQueue ) PRIVILEGED_FUNCTION;
+
+/**
+ * Take a consistent snapshot of a queue pool's usage counters.
+ */
+void vQueuePoolGetStats( QueuePool_t * pxPool,
+                         ObjectPoolStats_t * pxStats ) PRIVILEGED_FUNCTION;
+
+/*-----------------------------------------------------------
+ * Timer pools
+ *----------------------------------------------------------*/
+
+#if ( configUSE_TIMERS == 1 )
+
+/**
+ * One timer.  Private to object_pool.c.
+ */
+    typedef struct TimerPoolSlot
+    {
+        ObjectPoolLink_t xLink;          /*< Must be first. */
+        struct TimerPool * pxPool;       /*< Pool the timer belongs to. */
+        TimerCallbackFunction_t pxCallback; /*< NULL while the timer is in the pool. */
+        void * pvTimerID;                /*< Returned by pvTimerPoolGetID(). */
+        StaticTimer_t xTimerBuffer;      /*< The timer handle points here. */
+    } TimerPoolSlot_t;
+
+/**
+ * A pool of software timers.  Declare with timerpoolDEFINE().
+ */
+    typedef struct TimerPool
+    {
+        ObjectPoolCore_t xCore;          /*< Must be first. */
+        const char * pcName;             /*< Name given to every timer. */
+    } TimerPool_t;
+
+/**
+ * Define a pool of uxTimerCount timers, allocated statically.
+ */
+    #define timerpoolDEFINE( xName, uxTimerCount )                    \
+    static TimerPoolSlot_t xName ## Slots[ ( uxTimerCount ) ];         \
+    TimerPool_t xName = { objectpoolCORE( xName ## Slots, ( uxTimerCount ) ), #xName }
+
+/**
+ * Take a dormant timer from the pool and give it a callback.  The timer is not
+ * started - set its period and start it with xTimerChangePeriod().  The
+ * callback should read its ID with pvTimerPoolGetID(), not pvTimerGetTimerID().
+ *
+ * @param pxPool The pool to take a timer from.
+ * @param pxCallback Called each time the timer expires.
+ * @param pvTimerID Returned by pvTimerPoolGetID().
+ * @param uxAutoReload pdTRUE for a periodic timer, pdFALSE for a one-shot.
+ *
+ * @return The timer, or NULL if the pool is empty.
+ */
+    TimerHandle_t xTimerPoolAcquire( TimerPool_t * pxPool,
+                                     TimerCallbackFunction_t pxCallback,
+                                     void * pvTimerID,
+                                     UBaseType_t uxAutoReload ) PRIVILEGED_FUNCTION;
+
+/**
+ * Stop a timer and give it back to its pool.  The callback is not called again
+ * once this returns.  The timer only rejoins the pool after the timer service
+ * task has processed the stop command, so a stale expiry can never reach the
+ * timer's next owner.
+ *
+ * @param xTimer The timer to release.
+ * @param xTicksToWait Time to wait for space on the timer command queue.
+ *
+ * @return pdPASS, or pdFAIL if the stop command could not be queued, in which
+ * case the timer is still owned by the caller.
+ */
+    BaseType_t xTimerPoolRelease( TimerHandle_t xTimer,
+                                  TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * Return the ID given to xTimerPoolAcquire().
+ */
+    void * pvTimerPoolGetID( TimerHandle_t xTimer ) PRIVILEGED_FUNCTION;
+
+/**
+ * Take a consistent snapshot of a timer pool's usage counters.
+ */
+    void vTimerPoolGetStats( TimerPool_t * pxPool,
+                             ObjectPoolStats_t * pxStats ) PRIVILEGED_FUNCTION;
+
+#endif /* configUSE_TIMERS */
+
+/* *INDENT-OFF* */
+#if defined( __cplusplus )
+    }
+#endif
+/* *INDENT-ON* */
+
+#endif /* OBJECT_POOL_H */
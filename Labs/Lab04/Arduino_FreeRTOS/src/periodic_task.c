@@ -0,0 +1,247 @@
+/*
+ * This file is NOT part of the FreeRTOS distribution.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+/* Standard includes. */
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "Arduino_FreeRTOS.h"
+#include "task.h"
+#include "periodic_task.h"
+
+#if ( INCLUDE_xTaskDelayUntil != 1 )
+    #error INCLUDE_xTaskDelayUntil must be set to 1 in FreeRTOSConfig.h to use periodic tasks.
+#endif
+
+/* Without a run time counter execution times read as zero. */
+#ifdef portGET_RUN_TIME_COUNTER_VALUE
+    #define periodicGET_TIME_US()    ( ( uint32_t ) portGET_RUN_TIME_COUNTER_VALUE() )
+#else
+    #define periodicGET_TIME_US()    ( 0UL )
+#endif
+
+/* Head of the registry of periodic tasks, most recently created first. */
+PRIVILEGED_DATA static PeriodicTask_t * pxPeriodicTasks = NULL;
+
+/*
+ * The loop run by every periodic task.
+ */
+static portTASK_FUNCTION_PROTO( prvPeriodicTask, pvParameters );
+
+/*
+ * Fold the timings of one job into the statistics.
+ */
+static void prvRecordJob( PeriodicTask_t * pxPeriodicTask,
+                          TickType_t xJitter,
+                          TickType_t xResponse,
+                          uint32_t ulExecutionUs,
+                          BaseType_t xOverrun );
+
+/*-----------------------------------------------------------*/
+
+static void prvRecordJob( PeriodicTask_t * pxPeriodicTask,
+                          TickType_t xJitter,
+                          TickType_t xResponse,
+                          uint32_t ulExecutionUs,
+                          BaseType_t xOverrun )
+{
+    PeriodicTaskStats_t * pxStats = &( pxPeriodicTask->xStats );
+
+    /* Readers on other tasks copy the statistics inside a critical section,
+     * so update them inside one too. */
+    taskENTER_CRITICAL();
+    {
+        pxStats->ulReleases++;
+
+        if( xJitter > pxStats->xMaxReleaseJitter )
+        {
+            pxStats->xMaxReleaseJitter = xJitter;
+        }
+
+        if( xResponse > pxStats->xMaxResponseTime )
+        {
+            pxStats->xMaxResponseTime = xResponse;
+        }
+
+        if( xResponse >= pxPeriodicTask->xDeadline )
+        {
+            pxStats->usDeadlineMisses++;
+        }
+
+        if( xOverrun != pdFALSE )
+        {
+            pxStats->usOverruns++;
+        }
+
+        pxStats->ulLastExecutionUs = ulExecutionUs;
+
+        if( ulExecutionUs > pxStats->ulMaxExecutionUs )
+        {
+            pxStats->ulMaxExecutionUs = ulExecutionUs;
+        }
+    }
+    taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+static portTASK_FUNCTION( prvPeriodicTask, pvParameters )
+{
+    PeriodicTask_t * pxPeriodicTask = ( PeriodicTask_t * ) pvParameters;
+    TickType_t xRelease = pxPeriodicTask->xOrigin;
+    TickType_t xStart, xEnd;
+    uint32_t ulStartUs, ulExecutionUs;
+    BaseType_t xOverrun;
+
+    if( pxPeriodicTask->xPhase > 0U )
+    {
+        ( void ) xTaskDelayUntil( &xRelease, pxPeriodicTask->xPhase );
+    }
+
+    for( ; ; )
+    {
+        xStart = xTaskGetTickCount();
+        ulStartUs = periodicGET_TIME_US();
+
+        pxPeriodicTask->pxJob( pxPeriodicTask->pvParameters );
+
+        ulExecutionUs = periodicGET_TIME_US() - ulStartUs;
+        xEnd = xTaskGetTickCount();
+
+        /* Tick arithmetic is unsigned, so this is correct across overflow. */
+        xOverrun = ( ( TickType_t ) ( xEnd - xRelease ) >= pxPeriodicTask->xPeriod ) ? pdTRUE : pdFALSE;
+        prvRecordJob( pxPeriodicTask, xStart - xRelease, xEnd - xRelease, ulExecutionUs, xOverrun );
+
+        /* Releases stay on the xOrigin + xPhase + n * xPeriod grid.  After an
+         * overrun this returns without blocking, and the late start shows up
+         * as jitter on the next release. */
+        ( void ) xTaskDelayUntil( &xRelease, pxPeriodicTask->xPeriod );
+    }
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xPeriodicTaskCreate( PeriodicTask_t * pxPeriodicTask,
+                                configSTACK_DEPTH_TYPE usStackDepth,
+                                UBaseType_t uxPriority )
+{
+    BaseType_t xReturn;
+
+    configASSERT( pxPeriodicTask );
+    configASSERT( pxPeriodicTask->pxJob );
+    configASSERT( pxPeriodicTask->xPeriod > 0U );
+    configASSERT( pxPeriodicTask->xHandle == NULL );
+
+    /* Before the scheduler starts this is 0 for every task. */
+    pxPeriodicTask->xOrigin = xTaskGetTickCount();
+    ( void ) memset( &( pxPeriodicTask->xStats ), 0x00, sizeof( PeriodicTaskStats_t ) );
+
+    xReturn = xTaskCreate( prvPeriodicTask,
+                           pxPeriodicTask->pcName,
+                           usStackDepth,
+                           pxPeriodicTask,
+                           uxPriority,
+                           &( pxPeriodicTask->xHandle ) );
+
+    if( xReturn == pdPASS )
+    {
+        taskENTER_CRITICAL();
+        {
+            pxPeriodicTask->pxNext = pxPeriodicTasks;
+            pxPeriodicTasks = pxPeriodicTask;
+        }
+        taskEXIT_CRITICAL();
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vPeriodicTaskGetStats( PeriodicTask_t * pxPeriodicTask,
+                            PeriodicTaskStats_t * pxStats )
+{
+    configASSERT( pxPeriodicTask );
+    configASSERT( pxStats );
+
+    taskENTER_CRITICAL();
+    {
+        *pxStats = pxPeriodicTask->xStats;
+    }
+    taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+void vPeriodicTaskResetStats( PeriodicTask_t * pxPeriodicTask )
+{
+    configASSERT( pxPeriodicTask );
+
+    taskENTER_CRITICAL();
+    {
+        ( void ) memset( &( pxPeriodicTask->xStats ), 0x00, sizeof( PeriodicTaskStats_t ) );
+    }
+    taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+PeriodicTask_t * pxPeriodicTaskGetNext( PeriodicTask_t * pxPeriodicTask )
+{
+    PeriodicTask_t * pxNext;
+
+    taskENTER_CRITICAL();
+    {
+        pxNext = ( pxPeriodicTask == NULL ) ? pxPeriodicTasks : pxPeriodicTask->pxNext;
+    }
+    taskEXIT_CRITICAL();
+
+    return pxNext;
+}
+/*-----------------------------------------------------------*/
+
+TickType_t xPeriodicTaskGetPeriod( PeriodicTask_t * pxPeriodicTask )
+{
+    configASSERT( pxPeriodicTask );
+
+    return pxPeriodicTask->xPeriod;
+}
+/*-----------------------------------------------------------*/
+
+TickType_t xPeriodicTaskGetDeadline( PeriodicTask_t * pxPeriodicTask )
+{
+    configASSERT( pxPeriodicTask );
+
+    return pxPeriodicTask->xDeadline;
+}
+/*-----------------------------------------------------------*/
+
+TaskHandle_t xPeriodicTaskGetHandle( PeriodicTask_t * pxPeriodicTask )
+{
+    configASSERT( pxPeriodicTask );
+
+    return pxPeriodicTask->xHandle;
+}
+/*-----------------------------------------------------------*/
+
+const char * pcPeriodicTaskGetName( PeriodicTask_t * pxPeriodicTask )
+{
+    configASSERT( pxPeriodicTask );
+
+    return pxPeriodicTask->pcName;
+}
+/*-----------------------------------------------------------*/
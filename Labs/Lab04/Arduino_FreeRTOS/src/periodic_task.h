@@ -0,0 +1,183 @@
+/*
+ * This file is NOT part of the FreeRTOS distribution.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+/*
+ * Periodic tasks released on a fixed schedule with xTaskDelayUntil(), so the
+ * period does not stretch by the time the job takes to run.
+ *
+ * Each periodic task is described by a period, a phase (the offset of its
+ * first release) and a relative deadline, all in ticks.  The application
+ * supplies a job function that does one period's worth of work and returns;
+ * the library owns the loop around it and records, for every release:
+ *
+ *   + release jitter - ticks between the scheduled release and the job
+ *     actually starting, because higher or equal priority tasks were running.
+ *
+ *   + response time - ticks between the scheduled release and the job
+ *     finishing.  A response time of xDeadline ticks or more is a deadline
+ *     miss.
+ *
+ *   + execution time - microseconds from the job starting to it finishing,
+ *     measured with portGET_RUN_TIME_COUNTER_VALUE().  This includes any
+ *     time the job spent preempted.
+ *
+ * All periodic tasks created before the scheduler starts share tick 0 as
+ * their time origin, so phases line up between tasks.  Every periodic task is
+ * kept on a list that can be walked with pxPeriodicTaskGetNext() to inspect
+ * the statistics at run time.
+ */
+
+#ifndef PERIODIC_TASK_H
+#define PERIODIC_TASK_H
+
+#ifndef INC_ARDUINO_FREERTOS_H
+    #error "include Arduino_FreeRTOS.h must appear in source files before include periodic_task.h"
+#endif
+
+#include "task.h"
+
+/* *INDENT-OFF* */
+#if defined( __cplusplus )
+    extern "C" {
+#endif
+/* *INDENT-ON* */
+
+/**
+ * The work done by a periodic task in each period.  It must return, and must
+ * not block for longer than the task can afford to miss its deadline by.
+ */
+typedef void (* PeriodicJob_t)( void * pvParameters );
+
+/**
+ * Timeliness of a periodic task, see vPeriodicTaskGetStats().
+ */
+typedef struct PeriodicTaskStats
+{
+    uint32_t ulReleases;                 /*< Number of jobs completed. */
+    uint16_t usDeadlineMisses;           /*< Jobs that finished xDeadline or more ticks after their release. */
+    uint16_t usOverruns;                 /*< Jobs that finished after the next release was already due. */
+    TickType_t xMaxReleaseJitter;        /*< Worst delay from release to start, in ticks. */
+    TickType_t xMaxResponseTime;         /*< Worst delay from release to completion, in ticks. */
+    uint32_t ulLastExecutionUs;          /*< Start to finish time of the latest job. */
+    uint32_t ulMaxExecutionUs;           /*< Worst start to finish time. */
+} PeriodicTaskStats_t;
+
+/**
+ * A periodic task.  Declare with periodicDEFINE().  The members are private
+ * to periodic_task.c, use the functions below to read them.
+ */
+typedef struct PeriodicTask
+{
+    struct PeriodicTask * pxNext;        /*< Next periodic task in the registry. */
+    const char * pcName;                 /*< Name given to the task. */
+    PeriodicJob_t pxJob;                 /*< Called once per period. */
+    void * pvParameters;                 /*< Passed to pxJob. */
+    TickType_t xPeriod;                  /*< Ticks between releases. */
+    TickType_t xPhase;                   /*< Ticks from the time origin to the first release. */
+    TickType_t xDeadline;                /*< Ticks from each release to its deadline. */
+    TickType_t xOrigin;                  /*< Tick count the phase is measured from. */
+    TaskHandle_t xHandle;                /*< NULL until the task is created. */
+    PeriodicTaskStats_t xStats;
+} PeriodicTask_t;
+
+/**
+ * Define a periodic task.  Times are given in ticks, use pdMS_TO_TICKS() to
+ * convert from milliseconds.  The period must be at least one tick.
+ *
+ * Example usage:
+ * <pre>
+ * void vSampleJob( void * pvParameters )
+ * {
+ *     ... read a sensor ...
+ * }
+ *
+ * periodicDEFINE( xSampler, vSampleJob, NULL, pdMS_TO_TICKS( 100 ), 0, pdMS_TO_TICKS( 50 ) );
+ *
+ * xPeriodicTaskCreate( &xSampler, 128, 2 );
+ * </pre>
+ */
+#define periodicDEFINE( xName, pxJob, pvParameters, xPeriod, xPhase, xDeadline ) \
+    PeriodicTask_t xName = { NULL, #xName, ( pxJob ), ( pvParameters ), ( xPeriod ), ( xPhase ), ( xDeadline ), 0, NULL, { 0, 0, 0, 0, 0, 0, 0 } }
+
+/**
+ * Create the task that runs a periodic job and add it to the registry.
+ *
+ * @param pxPeriodicTask The periodic task, which must outlive the task.
+ * @param usStackDepth Stack depth of the task in words.
+ * @param uxPriority Priority of the task.
+ *
+ * @return pdPASS, or errCOULD_NOT_ALLOCATE_REQUIRED_MEMORY if the task could
+ * not be created.
+ */
+BaseType_t xPeriodicTaskCreate( PeriodicTask_t * pxPeriodicTask,
+                                configSTACK_DEPTH_TYPE usStackDepth,
+                                UBaseType_t uxPriority ) PRIVILEGED_FUNCTION;
+
+/**
+ * Take a consistent snapshot of a periodic task's statistics.
+ */
+void vPeriodicTaskGetStats( PeriodicTask_t * pxPeriodicTask,
+                            PeriodicTaskStats_t * pxStats ) PRIVILEGED_FUNCTION;
+
+/**
+ * Clear a periodic task's statistics, for example once start up is over.
+ */
+void vPeriodicTaskResetStats( PeriodicTask_t * pxPeriodicTask ) PRIVILEGED_FUNCTION;
+
+/**
+ * Walk the registry of periodic tasks.
+ *
+ * @param pxPeriodicTask NULL to get the first periodic task, otherwise the
+ * task returned by the previous call.
+ *
+ * @return The next periodic task, or NULL at the end of the registry.
+ */
+PeriodicTask_t * pxPeriodicTaskGetNext( PeriodicTask_t * pxPeriodicTask ) PRIVILEGED_FUNCTION;
+
+/**
+ * @return The period of the task, in ticks.
+ */
+TickType_t xPeriodicTaskGetPeriod( PeriodicTask_t * pxPeriodicTask ) PRIVILEGED_FUNCTION;
+
+/**
+ * @return The relative deadline of the task, in ticks.
+ */
+TickType_t xPeriodicTaskGetDeadline( PeriodicTask_t * pxPeriodicTask ) PRIVILEGED_FUNCTION;
+
+/**
+ * @return The handle of the task running the periodic job, or NULL if it has
+ * not been created.
+ */
+TaskHandle_t xPeriodicTaskGetHandle( PeriodicTask_t * pxPeriodicTask ) PRIVILEGED_FUNCTION;
+
+/**
+ * @return The name the periodic task was defined with.
+ */
+const char * pcPeriodicTaskGetName( PeriodicTask_t * pxPeriodicTask ) PRIVILEGED_FUNCTION;
+
+/* *INDENT-OFF* */
+#if defined( __cplusplus )
+    }
+#endif
+/* *INDENT-ON* */
+
+#endif /* PERIODIC_TASK_H */
@@ -48,7 +48,12 @@
  * included here.  In this case the path to the correct portmacro.h header file
  * must be set in the compiler's include path. */
 #ifndef portENTER_CRITICAL
-    #include "portmacro.h"
+    #ifdef __AVR__
+        #include "portmacro.h"
+    #else
+        /* Host builds run on the discrete event simulator in extras/sim. */
+        #include "portmacro_sim.h"
+    #endif
 #endif
 
 #if portBYTE_ALIGNMENT == 32
@@ -35,6 +35,11 @@
 #include "Arduino_FreeRTOS.h"
 #include "task.h"
 #include "queue.h"
+#include "queue_copy.h"
+
+#if ( configUSE_RAM_ACCOUNTING == 1 )
+    #include "ram_account.h"
+#endif
 
 #if ( configUSE_CO_ROUTINES == 1 )
     #include "croutine.h"
@@ -115,6 +120,7 @@ typedef struct QueueDef_t
 
     volatile int8_t cRxLock;                /*< Stores the number of items received from the queue (removed from the queue) while the queue was locked.  Set to queueUNLOCKED when the queue is not locked. */
     volatile int8_t cTxLock;                /*< Stores the number of items transmitted to the queue (added to the queue) while the queue was locked.  Set to queueUNLOCKED when the queue is not locked. */
+    uint8_t ucCopyClass;                    /*< How items are copied in and out, selected from uxItemSize when the queue is created.  See queue_copy.h. */
 
     #if ( ( configSUPPORT_STATIC_ALLOCATION == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) )
         uint8_t ucStaticallyAllocated; /*< Set to pdTRUE if the memory used by the queue was statically allocated to ensure no attempt is made to free the memory. */
@@ -128,6 +134,15 @@ typedef struct QueueDef_t
         UBaseType_t uxQueueNumber;
         uint8_t ucQueueType;
     #endif
+
+    #if ( ( configUSE_MUTEXES == 1 ) && ( configUSE_MUTEX_HOLD_TIMES == 1 ) )
+        uint32_t ulMutexTakenTime;   /*< Run time counter value when the mutex was last taken. */
+        uint32_t ulMutexMaxHoldTime; /*< Longest time the mutex has been held for, feeds the blocking terms of response time analysis. */
+    #endif
+
+    #if ( configUSE_RAM_ACCOUNTING == 1 )
+        UBaseType_t uxRamOwner; /*< Number of the task that created the queue, see ram_account.h. */
+    #endif
 } Queue_t;
 
 /*-----------------------------------------------------------*/
@@ -197,6 +212,38 @@ static BaseType_t prvCopyDataToQueue( Queue_t * const pxQueue,
 static void prvCopyDataFromQueue( Queue_t * const pxQueue,
                                   void * const pvBuffer ) PRIVILEGED_FUNCTION;
 
+/*
+ * Copy as many of uxCount items as there is space for to the back of the
+ * queue, and as many of uxCount items as are queued out of the queue,
+ * respectively.  The ring is handled as at most two contiguous runs rather
+ * than item by item.  Both update uxMessagesWaiting and return the number of
+ * items copied.  Must be called with interrupts masked.
+ */
+static UBaseType_t prvCopyItemsToQueue( Queue_t * const pxQueue,
+                                        const int8_t * pcItems,
+                                        UBaseType_t uxCount ) PRIVILEGED_FUNCTION;
+static UBaseType_t prvCopyItemsFromQueue( Queue_t * const pxQueue,
+                                          int8_t * pcBuffer,
+                                          UBaseType_t uxCount ) PRIVILEGED_FUNCTION;
+
+/*
+ * Unblock up to uxCount tasks from pxEventList.  Returns pdTRUE if any of
+ * them has a priority above the running task.
+ */
+static BaseType_t prvUnblockEventListTasks( List_t * const pxEventList,
+                                            UBaseType_t uxCount ) PRIVILEGED_FUNCTION;
+
+/*
+ * The non-blocking body of uxQueueSendMultiple() and
+ * uxQueueReceiveMultiple(), called from task context.
+ */
+static UBaseType_t prvSendMultiple( Queue_t * const pxQueue,
+                                    const int8_t * pcItems,
+                                    UBaseType_t uxCount ) PRIVILEGED_FUNCTION;
+static UBaseType_t prvReceiveMultiple( Queue_t * const pxQueue,
+                                       int8_t * pcBuffer,
+                                       UBaseType_t uxMaxItems ) PRIVILEGED_FUNCTION;
+
 #if ( configUSE_QUEUE_SETS == 1 )
 
 /*
@@ -465,6 +512,7 @@ static void prvInitialiseNewQueue( const UBaseType_t uxQueueLength,
      * defined. */
     pxNewQueue->uxLength = uxQueueLength;
     pxNewQueue->uxItemSize = uxItemSize;
+    pxNewQueue->ucCopyClass = queueCOPY_SELECT_CLASS( uxItemSize );
     ( void ) xQueueGenericReset( pxNewQueue, pdTRUE );
 
     #if ( configUSE_TRACE_FACILITY == 1 )
@@ -479,6 +527,25 @@ static void prvInitialiseNewQueue( const UBaseType_t uxQueueLength,
         }
     #endif /* configUSE_QUEUE_SETS */
 
+    #if ( ( configUSE_MUTEXES == 1 ) && ( configUSE_MUTEX_HOLD_TIMES == 1 ) )
+        {
+            pxNewQueue->ulMutexTakenTime = 0UL;
+            pxNewQueue->ulMutexMaxHoldTime = 0UL;
+        }
+    #endif
+
+    #if ( configUSE_RAM_ACCOUNTING == 1 )
+        {
+            pxNewQueue->uxRamOwner = uxRamAccountOwner();
+            vRamAccountAdd( pxNewQueue->uxRamOwner, eRamQueue, sizeof( Queue_t ) );
+
+            if( uxItemSize != ( UBaseType_t ) 0 )
+            {
+                vRamAccountAdd( pxNewQueue->uxRamOwner, eRamQueueStorage, ( size_t ) uxQueueLength * ( size_t ) uxItemSize );
+            }
+        }
+    #endif /* configUSE_RAM_ACCOUNTING */
+
     traceQUEUE_CREATE( pxNewQueue );
 }
 /*-----------------------------------------------------------*/
@@ -1507,6 +1574,12 @@ BaseType_t xQueueSemaphoreTake( QueueHandle_t xQueue,
                             /* Record the information required to implement
                              * priority inheritance should it become necessary. */
                             pxQueue->u.xSemaphore.xMutexHolder = pvTaskIncrementMutexHeldCount();
+
+                            #if ( configUSE_MUTEX_HOLD_TIMES == 1 )
+                                {
+                                    pxQueue->ulMutexTakenTime = ( uint32_t ) portGET_RUN_TIME_COUNTER_VALUE();
+                                }
+                            #endif
                         }
                         else
                         {
@@ -1974,6 +2047,226 @@ BaseType_t xQueuePeekFromISR( QueueHandle_t xQueue,
 }
 /*-----------------------------------------------------------*/
 
+UBaseType_t uxQueueSendMultiple( QueueHandle_t xQueue,
+                                 const void * pvItems,
+                                 UBaseType_t uxCount,
+                                 TickType_t xTicksToWait )
+{
+    UBaseType_t uxSent;
+    Queue_t * const pxQueue = xQueue;
+    const int8_t * pcItems = ( const int8_t * ) pvItems;
+
+    configASSERT( pxQueue );
+    configASSERT( !( ( pvItems == NULL ) && ( uxCount != ( UBaseType_t ) 0U ) ) );
+    configASSERT( pxQueue->uxItemSize != ( UBaseType_t ) 0U );
+    #if ( configUSE_QUEUE_SETS == 1 )
+        configASSERT( pxQueue->pxQueueSetContainer == NULL );
+    #endif
+    #if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+        {
+            configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+        }
+    #endif
+
+    uxSent = prvSendMultiple( pxQueue, pcItems, uxCount );
+
+    if( ( uxSent == ( UBaseType_t ) 0U ) && ( uxCount != ( UBaseType_t ) 0U ) && ( xTicksToWait != ( TickType_t ) 0U ) )
+    {
+        /* The queue was full.  Block for space the same way a single send
+         * does, using the first item, then top up with whatever else fits
+         * without blocking a second time. */
+        if( xQueueGenericSend( xQueue, pcItems, xTicksToWait, queueSEND_TO_BACK ) == pdPASS )
+        {
+            uxSent = ( UBaseType_t ) 1U + prvSendMultiple( pxQueue, pcItems + pxQueue->uxItemSize, uxCount - ( UBaseType_t ) 1U );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    return uxSent;
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxQueueReceiveMultiple( QueueHandle_t xQueue,
+                                    void * pvBuffer,
+                                    UBaseType_t uxMaxItems,
+                                    TickType_t xTicksToWait )
+{
+    UBaseType_t uxReceived;
+    Queue_t * const pxQueue = xQueue;
+    int8_t * pcBuffer = ( int8_t * ) pvBuffer;
+
+    configASSERT( pxQueue );
+    configASSERT( !( ( pvBuffer == NULL ) && ( uxMaxItems != ( UBaseType_t ) 0U ) ) );
+    configASSERT( pxQueue->uxItemSize != ( UBaseType_t ) 0U );
+    #if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+        {
+            configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+        }
+    #endif
+
+    uxReceived = prvReceiveMultiple( pxQueue, pcBuffer, uxMaxItems );
+
+    if( ( uxReceived == ( UBaseType_t ) 0U ) && ( uxMaxItems != ( UBaseType_t ) 0U ) && ( xTicksToWait != ( TickType_t ) 0U ) )
+    {
+        /* The queue was empty.  Block for the first item the same way a
+         * single receive does, then collect anything queued behind it. */
+        if( xQueueReceive( xQueue, pcBuffer, xTicksToWait ) == pdPASS )
+        {
+            uxReceived = ( UBaseType_t ) 1U + prvReceiveMultiple( pxQueue, pcBuffer + pxQueue->uxItemSize, uxMaxItems - ( UBaseType_t ) 1U );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    return uxReceived;
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxQueueSendMultipleFromISR( QueueHandle_t xQueue,
+                                        const void * pvItems,
+                                        UBaseType_t uxCount,
+                                        BaseType_t * const pxHigherPriorityTaskWoken )
+{
+    UBaseType_t uxSent;
+    UBaseType_t uxSavedInterruptStatus;
+    Queue_t * const pxQueue = xQueue;
+
+    configASSERT( pxQueue );
+    configASSERT( !( ( pvItems == NULL ) && ( uxCount != ( UBaseType_t ) 0U ) ) );
+    configASSERT( pxQueue->uxItemSize != ( UBaseType_t ) 0U );
+    #if ( configUSE_QUEUE_SETS == 1 )
+        configASSERT( pxQueue->pxQueueSetContainer == NULL );
+    #endif
+
+    /* See the comment in xQueueReceiveFromISR() regarding interrupt priority
+     * validation. */
+    portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+
+    uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+    {
+        uxSent = prvCopyItemsToQueue( pxQueue, ( const int8_t * ) pvItems, uxCount );
+
+        if( uxSent > ( UBaseType_t ) 0U )
+        {
+            const int8_t cTxLock = pxQueue->cTxLock;
+
+            traceQUEUE_SEND_FROM_ISR( pxQueue );
+
+            if( cTxLock == queueUNLOCKED )
+            {
+                if( ( prvUnblockEventListTasks( &( pxQueue->xTasksWaitingToReceive ), uxSent ) != pdFALSE ) && ( pxHigherPriorityTaskWoken != NULL ) )
+                {
+                    *pxHigherPriorityTaskWoken = pdTRUE;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else
+            {
+                /* Credit the task that unlocks the queue with one wake up per
+                 * item posted, saturating rather than overflowing the count -
+                 * any excess would only find the event list empty anyway. */
+                configASSERT( cTxLock != queueINT8_MAX );
+
+                if( uxSent >= ( UBaseType_t ) ( queueINT8_MAX - cTxLock ) )
+                {
+                    pxQueue->cTxLock = ( int8_t ) ( queueINT8_MAX - 1 );
+                }
+                else
+                {
+                    pxQueue->cTxLock = ( int8_t ) ( cTxLock + ( int8_t ) uxSent );
+                }
+            }
+        }
+        else
+        {
+            traceQUEUE_SEND_FROM_ISR_FAILED( pxQueue );
+        }
+    }
+    portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+
+    return uxSent;
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxQueueReceiveMultipleFromISR( QueueHandle_t xQueue,
+                                           void * const pvBuffer,
+                                           UBaseType_t uxMaxItems,
+                                           BaseType_t * const pxHigherPriorityTaskWoken )
+{
+    UBaseType_t uxReceived;
+    UBaseType_t uxSavedInterruptStatus;
+    Queue_t * const pxQueue = xQueue;
+
+    configASSERT( pxQueue );
+    configASSERT( !( ( pvBuffer == NULL ) && ( uxMaxItems != ( UBaseType_t ) 0U ) ) );
+    configASSERT( pxQueue->uxItemSize != ( UBaseType_t ) 0U );
+
+    /* See the comment in xQueueReceiveFromISR() regarding interrupt priority
+     * validation. */
+    portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+
+    uxSavedInterruptStatus = portSET_INTERRUPT_MASK_FROM_ISR();
+    {
+        uxReceived = prvCopyItemsFromQueue( pxQueue, ( int8_t * ) pvBuffer, uxMaxItems );
+
+        if( uxReceived > ( UBaseType_t ) 0U )
+        {
+            const int8_t cRxLock = pxQueue->cRxLock;
+
+            traceQUEUE_RECEIVE_FROM_ISR( pxQueue );
+
+            if( cRxLock == queueUNLOCKED )
+            {
+                if( ( prvUnblockEventListTasks( &( pxQueue->xTasksWaitingToSend ), uxReceived ) != pdFALSE ) && ( pxHigherPriorityTaskWoken != NULL ) )
+                {
+                    *pxHigherPriorityTaskWoken = pdTRUE;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else
+            {
+                configASSERT( cRxLock != queueINT8_MAX );
+
+                if( uxReceived >= ( UBaseType_t ) ( queueINT8_MAX - cRxLock ) )
+                {
+                    pxQueue->cRxLock = ( int8_t ) ( queueINT8_MAX - 1 );
+                }
+                else
+                {
+                    pxQueue->cRxLock = ( int8_t ) ( cRxLock + ( int8_t ) uxReceived );
+                }
+            }
+        }
+        else
+        {
+            traceQUEUE_RECEIVE_FROM_ISR_FAILED( pxQueue );
+        }
+    }
+    portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+
+    return uxReceived;
+}
+/*-----------------------------------------------------------*/
+
 UBaseType_t uxQueueMessagesWaiting( const QueueHandle_t xQueue )
 {
     UBaseType_t uxReturn;
@@ -2032,6 +2325,17 @@ void vQueueDelete( QueueHandle_t xQueue )
         }
     #endif
 
+    #if ( configUSE_RAM_ACCOUNTING == 1 )
+        {
+            vRamAccountRemove( pxQueue->uxRamOwner, eRamQueue, sizeof( Queue_t ) );
+
+            if( pxQueue->uxItemSize != ( UBaseType_t ) 0 )
+            {
+                vRamAccountRemove( pxQueue->uxRamOwner, eRamQueueStorage, ( size_t ) pxQueue->uxLength * ( size_t ) pxQueue->uxItemSize );
+            }
+        }
+    #endif /* configUSE_RAM_ACCOUNTING */
+
     #if ( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 0 ) )
         {
             /* The queue can only have been allocated dynamically - free it
@@ -2092,6 +2396,54 @@ void vQueueDelete( QueueHandle_t xQueue )
 #endif /* configUSE_TRACE_FACILITY */
 /*-----------------------------------------------------------*/
 
+UBaseType_t uxQueueGetQueueItemSize( QueueHandle_t xQueue ) /* PRIVILEGED_FUNCTION */
+{
+    configASSERT( xQueue );
+
+    return ( ( Queue_t * ) xQueue )->uxItemSize;
+}
+/*-----------------------------------------------------------*/
+
+#if ( ( configUSE_MUTEXES == 1 ) && ( configUSE_MUTEX_HOLD_TIMES == 1 ) )
+
+    #ifndef portGET_RUN_TIME_COUNTER_VALUE
+        #error configUSE_MUTEX_HOLD_TIMES requires portGET_RUN_TIME_COUNTER_VALUE() to return a time in microseconds.
+    #endif
+
+    uint32_t ulQueueGetMutexMaxHoldTime( QueueHandle_t xMutex ) /* PRIVILEGED_FUNCTION */
+    {
+        uint32_t ulReturn;
+        Queue_t * const pxMutex = ( Queue_t * ) xMutex;
+
+        configASSERT( pxMutex );
+        configASSERT( pxMutex->uxQueueType == queueQUEUE_IS_MUTEX );
+
+        taskENTER_CRITICAL();
+        {
+            ulReturn = pxMutex->ulMutexMaxHoldTime;
+        }
+        taskEXIT_CRITICAL();
+
+        return ulReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    void vQueueResetMutexMaxHoldTime( QueueHandle_t xMutex ) /* PRIVILEGED_FUNCTION */
+    {
+        Queue_t * const pxMutex = ( Queue_t * ) xMutex;
+
+        configASSERT( pxMutex );
+
+        taskENTER_CRITICAL();
+        {
+            pxMutex->ulMutexMaxHoldTime = 0UL;
+        }
+        taskEXIT_CRITICAL();
+    }
+
+#endif /* ( ( configUSE_MUTEXES == 1 ) && ( configUSE_MUTEX_HOLD_TIMES == 1 ) ) */
+/*-----------------------------------------------------------*/
+
 #if ( configUSE_MUTEXES == 1 )
 
     static UBaseType_t prvGetDisinheritPriorityAfterTimeout( const Queue_t * const pxQueue )
@@ -2137,6 +2489,22 @@ static BaseType_t prvCopyDataToQueue( Queue_t * const pxQueue,
                 if( pxQueue->uxQueueType == queueQUEUE_IS_MUTEX )
                 {
                     /* The mutex is no longer being held. */
+                    #if ( configUSE_MUTEX_HOLD_TIMES == 1 )
+                        {
+                            /* The mutex is given once when it is created, before
+                             * anything has held it. */
+                            if( pxQueue->u.xSemaphore.xMutexHolder != NULL )
+                            {
+                                const uint32_t ulHeld = ( uint32_t ) portGET_RUN_TIME_COUNTER_VALUE() - pxQueue->ulMutexTakenTime;
+
+                                if( ulHeld > pxQueue->ulMutexMaxHoldTime )
+                                {
+                                    pxQueue->ulMutexMaxHoldTime = ulHeld;
+                                }
+                            }
+                        }
+                    #endif /* configUSE_MUTEX_HOLD_TIMES */
+
                     xReturn = xTaskPriorityDisinherit( pxQueue->u.xSemaphore.xMutexHolder );
                     pxQueue->u.xSemaphore.xMutexHolder = NULL;
                 }
@@ -2149,7 +2517,7 @@ static BaseType_t prvCopyDataToQueue( Queue_t * const pxQueue,
     }
     else if( xPosition == queueSEND_TO_BACK )
     {
-        ( void ) memcpy( ( void * ) pxQueue->pcWriteTo, pvItemToQueue, ( size_t ) pxQueue->uxItemSize ); /*lint !e961 !e418 !e9087 MISRA exception as the casts are only redundant for some ports, plus previous logic ensures a null pointer can only be passed to memcpy() if the copy size is 0.  Cast to void required by function signature and safe as no alignment requirement and copy length specified in bytes. */
+        queueCOPY_ITEM( pxQueue->ucCopyClass, pxQueue->pcWriteTo, pvItemToQueue, pxQueue->uxItemSize );
         pxQueue->pcWriteTo += pxQueue->uxItemSize;                                                       /*lint !e9016 Pointer arithmetic on char types ok, especially in this use case where it is the clearest way of conveying intent. */
 
         if( pxQueue->pcWriteTo >= pxQueue->u.xQueue.pcTail )                                             /*lint !e946 MISRA exception justified as comparison of pointers is the cleanest solution. */
@@ -2163,7 +2531,7 @@ static BaseType_t prvCopyDataToQueue( Queue_t * const pxQueue,
     }
     else
     {
-        ( void ) memcpy( ( void * ) pxQueue->u.xQueue.pcReadFrom, pvItemToQueue, ( size_t ) pxQueue->uxItemSize ); /*lint !e961 !e9087 !e418 MISRA exception as the casts are only redundant for some ports.  Cast to void required by function signature and safe as no alignment requirement and copy length specified in bytes.  Assert checks null pointer only used when length is 0. */
+        queueCOPY_ITEM( pxQueue->ucCopyClass, pxQueue->u.xQueue.pcReadFrom, pvItemToQueue, pxQueue->uxItemSize );
         pxQueue->u.xQueue.pcReadFrom -= pxQueue->uxItemSize;
 
         if( pxQueue->u.xQueue.pcReadFrom < pxQueue->pcHead ) /*lint !e946 MISRA exception justified as comparison of pointers is the cleanest solution. */
@@ -2218,11 +2586,238 @@ static void prvCopyDataFromQueue( Queue_t * const pxQueue,
             mtCOVERAGE_TEST_MARKER();
         }
 
-        ( void ) memcpy( ( void * ) pvBuffer, ( void * ) pxQueue->u.xQueue.pcReadFrom, ( size_t ) pxQueue->uxItemSize ); /*lint !e961 !e418 !e9087 MISRA exception as the casts are only redundant for some ports.  Also previous logic ensures a null pointer can only be passed to memcpy() when the count is 0.  Cast to void required by function signature and safe as no alignment requirement and copy length specified in bytes. */
+        queueCOPY_ITEM( pxQueue->ucCopyClass, pvBuffer, pxQueue->u.xQueue.pcReadFrom, pxQueue->uxItemSize );
     }
 }
 /*-----------------------------------------------------------*/
 
+static UBaseType_t prvCopyItemsToQueue( Queue_t * const pxQueue,
+                                        const int8_t * pcItems,
+                                        UBaseType_t uxCount )
+{
+    const UBaseType_t uxSpace = pxQueue->uxLength - pxQueue->uxMessagesWaiting;
+    size_t xBytes, xFirst;
+
+    if( uxCount > uxSpace )
+    {
+        uxCount = uxSpace;
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    if( uxCount > ( UBaseType_t ) 0U )
+    {
+        xBytes = ( size_t ) uxCount * ( size_t ) pxQueue->uxItemSize;
+
+        /* Copy up to the end of the storage area, then wrap to the start
+         * for the rest.  There is room for all of it as uxCount was clipped
+         * to the free space above. */
+        xFirst = ( size_t ) ( pxQueue->u.xQueue.pcTail - pxQueue->pcWriteTo );
+
+        if( xFirst > xBytes )
+        {
+            xFirst = xBytes;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        ( void ) memcpy( ( void * ) pxQueue->pcWriteTo, ( const void * ) pcItems, xFirst );
+        pxQueue->pcWriteTo += xFirst;
+
+        if( pxQueue->pcWriteTo >= pxQueue->u.xQueue.pcTail )
+        {
+            pxQueue->pcWriteTo = pxQueue->pcHead;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        if( xBytes > xFirst )
+        {
+            ( void ) memcpy( ( void * ) pxQueue->pcWriteTo, ( const void * ) ( pcItems + xFirst ), xBytes - xFirst );
+            pxQueue->pcWriteTo += xBytes - xFirst;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        pxQueue->uxMessagesWaiting += uxCount;
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    return uxCount;
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvCopyItemsFromQueue( Queue_t * const pxQueue,
+                                          int8_t * pcBuffer,
+                                          UBaseType_t uxCount )
+{
+    int8_t * pcReadStart;
+    size_t xBytes, xFirst;
+
+    if( uxCount > pxQueue->uxMessagesWaiting )
+    {
+        uxCount = pxQueue->uxMessagesWaiting;
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    if( uxCount > ( UBaseType_t ) 0U )
+    {
+        xBytes = ( size_t ) uxCount * ( size_t ) pxQueue->uxItemSize;
+
+        /* pcReadFrom points at the last item read, so the oldest queued item
+         * is the one after it. */
+        pcReadStart = pxQueue->u.xQueue.pcReadFrom + pxQueue->uxItemSize;
+
+        if( pcReadStart >= pxQueue->u.xQueue.pcTail )
+        {
+            pcReadStart = pxQueue->pcHead;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        xFirst = ( size_t ) ( pxQueue->u.xQueue.pcTail - pcReadStart );
+
+        if( xFirst > xBytes )
+        {
+            xFirst = xBytes;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        ( void ) memcpy( ( void * ) pcBuffer, ( const void * ) pcReadStart, xFirst );
+
+        if( xBytes > xFirst )
+        {
+            ( void ) memcpy( ( void * ) ( pcBuffer + xFirst ), ( const void * ) pxQueue->pcHead, xBytes - xFirst );
+            pxQueue->u.xQueue.pcReadFrom = pxQueue->pcHead + ( xBytes - xFirst ) - pxQueue->uxItemSize;
+        }
+        else
+        {
+            pxQueue->u.xQueue.pcReadFrom = pcReadStart + xFirst - pxQueue->uxItemSize;
+        }
+
+        pxQueue->uxMessagesWaiting -= uxCount;
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    return uxCount;
+}
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvUnblockEventListTasks( List_t * const pxEventList,
+                                            UBaseType_t uxCount )
+{
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+    while( ( uxCount > ( UBaseType_t ) 0U ) && ( listLIST_IS_EMPTY( pxEventList ) == pdFALSE ) )
+    {
+        if( xTaskRemoveFromEventList( pxEventList ) != pdFALSE )
+        {
+            xHigherPriorityTaskWoken = pdTRUE;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        uxCount--;
+    }
+
+    return xHigherPriorityTaskWoken;
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvSendMultiple( Queue_t * const pxQueue,
+                                    const int8_t * pcItems,
+                                    UBaseType_t uxCount )
+{
+    UBaseType_t uxSent;
+
+    taskENTER_CRITICAL();
+    {
+        uxSent = prvCopyItemsToQueue( pxQueue, pcItems, uxCount );
+
+        if( uxSent > ( UBaseType_t ) 0U )
+        {
+            traceQUEUE_SEND( pxQueue );
+
+            /* One receiver can take each item posted, so there is no point
+             * waking more than that. */
+            if( prvUnblockEventListTasks( &( pxQueue->xTasksWaitingToReceive ), uxSent ) != pdFALSE )
+            {
+                queueYIELD_IF_USING_PREEMPTION();
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    return uxSent;
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvReceiveMultiple( Queue_t * const pxQueue,
+                                       int8_t * pcBuffer,
+                                       UBaseType_t uxMaxItems )
+{
+    UBaseType_t uxReceived;
+
+    taskENTER_CRITICAL();
+    {
+        uxReceived = prvCopyItemsFromQueue( pxQueue, pcBuffer, uxMaxItems );
+
+        if( uxReceived > ( UBaseType_t ) 0U )
+        {
+            traceQUEUE_RECEIVE( pxQueue );
+
+            if( prvUnblockEventListTasks( &( pxQueue->xTasksWaitingToSend ), uxReceived ) != pdFALSE )
+            {
+                queueYIELD_IF_USING_PREEMPTION();
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    return uxReceived;
+}
+/*-----------------------------------------------------------*/
+
 static void prvUnlockQueue( Queue_t * const pxQueue )
 {
     /* THIS FUNCTION MUST BE CALLED WITH THE SCHEDULER SUSPENDED. */
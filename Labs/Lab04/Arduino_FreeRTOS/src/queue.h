@@ -1424,6 +1424,124 @@ BaseType_t xQueueIsQueueEmptyFromISR( const QueueHandle_t xQueue ) PRIVILEGED_FU
 BaseType_t xQueueIsQueueFullFromISR( const QueueHandle_t xQueue ) PRIVILEGED_FUNCTION;
 UBaseType_t uxQueueMessagesWaitingFromISR( const QueueHandle_t xQueue ) PRIVILEGED_FUNCTION;
 
+/**
+ * queue. h
+ * <pre>
+ * UBaseType_t uxQueueSendMultiple( QueueHandle_t xQueue,
+ *                                  const void * pvItems,
+ *                                  UBaseType_t uxCount,
+ *                                  TickType_t xTicksToWait );
+ * </pre>
+ *
+ * Post up to uxCount items, stored back to back at pvItems, to the back of a
+ * queue.  All the items that fit are copied inside a single critical section,
+ * and at most one task waiting to receive is unblocked per item copied, so
+ * the critical section and wake up overhead of xQueueSend() is paid once per
+ * batch rather than once per item.
+ *
+ * If the queue is full on entry the calling task blocks for up to
+ * xTicksToWait ticks for space to become available, exactly as xQueueSend()
+ * would, then posts as many of the remaining items as fit without blocking
+ * again.  The function therefore never blocks once any item has been posted,
+ * and the caller must check the return value to find out how many were.
+ *
+ * Only plain queues are supported - not semaphores, mutexes, or queues that
+ * are members of a queue set.
+ *
+ * @param xQueue The handle of the queue to post to.
+ * @param pvItems Pointer to an array of uxCount items, each the queue's item
+ * size.
+ * @param uxCount The number of items in the array.
+ * @param xTicksToWait The maximum time to block if the queue is full on entry.
+ *
+ * @return The number of items posted, from 0 to uxCount.  Items are always
+ * taken from the start of the array.
+ *
+ * Example usage:
+ * <pre>
+ * uint16_t usSamples[ 8 ];
+ * UBaseType_t uxSent = 0;
+ *
+ *  // Keep going until the whole block has been posted.
+ *  while( uxSent < 8 )
+ *  {
+ *      uxSent += uxQueueSendMultiple( xQueue, &usSamples[ uxSent ], 8 - uxSent, portMAX_DELAY );
+ *  }
+ * </pre>
+ * \defgroup uxQueueSendMultiple uxQueueSendMultiple
+ * \ingroup QueueManagement
+ */
+UBaseType_t uxQueueSendMultiple( QueueHandle_t xQueue,
+                                 const void * pvItems,
+                                 UBaseType_t uxCount,
+                                 TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * queue. h
+ * <pre>
+ * UBaseType_t uxQueueReceiveMultiple( QueueHandle_t xQueue,
+ *                                     void * pvBuffer,
+ *                                     UBaseType_t uxMaxItems,
+ *                                     TickType_t xTicksToWait );
+ * </pre>
+ *
+ * Receive up to uxMaxItems items from a queue into a buffer, oldest first.
+ * This is the receive side of uxQueueSendMultiple() - everything currently
+ * queued (up to uxMaxItems) is copied out in a single critical section and at
+ * most one task waiting to send is unblocked per item removed.
+ *
+ * If the queue is empty on entry the calling task blocks for up to
+ * xTicksToWait ticks for an item to arrive, exactly as xQueueReceive() would,
+ * then takes whatever else is already queued without blocking again.  A task
+ * that drains a queue this way wakes once per burst rather than once per item.
+ *
+ * @param xQueue The handle of the queue to receive from.
+ * @param pvBuffer Buffer large enough to hold uxMaxItems items.
+ * @param uxMaxItems The most items to receive.
+ * @param xTicksToWait The maximum time to block if the queue is empty on entry.
+ *
+ * @return The number of items received, from 0 to uxMaxItems.
+ *
+ * \defgroup uxQueueReceiveMultiple uxQueueReceiveMultiple
+ * \ingroup QueueManagement
+ */
+UBaseType_t uxQueueReceiveMultiple( QueueHandle_t xQueue,
+                                    void * pvBuffer,
+                                    UBaseType_t uxMaxItems,
+                                    TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * A version of uxQueueSendMultiple() that can be called from an interrupt
+ * service routine.  Posts as many of the items as fit and never blocks.
+ *
+ * @param pxHigherPriorityTaskWoken Set to pdTRUE if posting the items
+ * unblocked a task with a priority higher than the interrupted task, in which
+ * case a context switch should be requested before the interrupt is exited.
+ *
+ * \defgroup uxQueueSendMultipleFromISR uxQueueSendMultipleFromISR
+ * \ingroup QueueManagement
+ */
+UBaseType_t uxQueueSendMultipleFromISR( QueueHandle_t xQueue,
+                                        const void * pvItems,
+                                        UBaseType_t uxCount,
+                                        BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/**
+ * A version of uxQueueReceiveMultiple() that can be called from an interrupt
+ * service routine.  Receives whatever is queued, up to uxMaxItems, and never
+ * blocks.
+ *
+ * @param pxHigherPriorityTaskWoken Set to pdTRUE if removing the items
+ * unblocked a task with a priority higher than the interrupted task.
+ *
+ * \defgroup uxQueueReceiveMultipleFromISR uxQueueReceiveMultipleFromISR
+ * \ingroup QueueManagement
+ */
+UBaseType_t uxQueueReceiveMultipleFromISR( QueueHandle_t xQueue,
+                                           void * const pvBuffer,
+                                           UBaseType_t uxMaxItems,
+                                           BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
 /*
  * The functions defined above are for passing data to and from tasks.  The
  * functions below are the equivalents for passing data to and from
@@ -1695,6 +1813,54 @@ QueueSetMemberHandle_t xQueueSelectFromSet( QueueSetHandle_t xQueueSet,
  */
 QueueSetMemberHandle_t xQueueSelectFromSetFromISR( QueueSetHandle_t xQueueSet ) PRIVILEGED_FUNCTION;
 
+/**
+ * queue. h
+ * <pre>
+ * UBaseType_t uxQueueGetQueueItemSize( QueueHandle_t xQueue );
+ * </pre>
+ *
+ * Return the size, in bytes, of each item the queue holds.  This is the
+ * uxItemSize the queue was created with.
+ *
+ * @param xQueue The handle of the queue being queried.
+ *
+ * @return The size of one queue item in bytes.
+ */
+UBaseType_t uxQueueGetQueueItemSize( QueueHandle_t xQueue ) PRIVILEGED_FUNCTION;
+
+/**
+ * queue. h
+ * <pre>
+ * uint32_t ulQueueGetMutexMaxHoldTime( QueueHandle_t xMutex );
+ * </pre>
+ *
+ * configUSE_MUTEX_HOLD_TIMES must be defined as 1 in FreeRTOSConfig.h for
+ * this function to be available.
+ *
+ * Return the longest time a mutex has been held for, from the take to the
+ * matching give, as measured with portGET_RUN_TIME_COUNTER_VALUE().  For a
+ * recursive mutex only the outermost take and give are timed.  This is the
+ * hold time a lower priority task can block a higher priority one for, and is
+ * the blocking term used by response time analysis (see rta.h).
+ *
+ * @param xMutex The handle of the mutex being queried.
+ *
+ * @return The longest hold time seen, in run time counter units.
+ */
+uint32_t ulQueueGetMutexMaxHoldTime( QueueHandle_t xMutex ) PRIVILEGED_FUNCTION;
+
+/**
+ * queue. h
+ * <pre>
+ * void vQueueResetMutexMaxHoldTime( QueueHandle_t xMutex );
+ * </pre>
+ *
+ * Forget the hold times measured so far, for example once start up is over.
+ *
+ * @param xMutex The handle of the mutex.
+ */
+void vQueueResetMutexMaxHoldTime( QueueHandle_t xMutex ) PRIVILEGED_FUNCTION;
+
 /* Not public API functions. */
 void vQueueWaitForMessageRestricted( QueueHandle_t xQueue,
                                      TickType_t xTicksToWait,
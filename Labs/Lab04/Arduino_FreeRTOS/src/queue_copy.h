@@ -0,0 +1,99 @@
+/*
+ * This file is NOT part of the FreeRTOS distribution.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+/*
+ * Item copy routines for queue.c.
+ *
+ * Most queue traffic is one, two or four bytes wide - flags, ADC samples,
+ * pointers and timestamps - yet a generic copy with a run time length costs a
+ * call, a loop and a length check per item.  When a queue is created
+ * queueCOPY_SELECT_CLASS() picks a copy class from its item size, and every
+ * send and receive then goes through queueCOPY_ITEM(), which moves those sizes
+ * with plain byte assignments and leaves memcpy() for everything else.
+ *
+ * The byte assignments carry no alignment requirement, so the items may sit
+ * anywhere in the caller's memory.  On AVR each becomes a single load and
+ * store, and host compilers merge them into one word move.
+ *
+ * This header has no kernel dependencies so the same code can be timed on the
+ * host (see extras/queue_copy).
+ */
+
+#ifndef QUEUE_COPY_H
+#define QUEUE_COPY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/* Copy classes.  queueCOPY_NONE is used by semaphores, which hold no data. */
+#define queueCOPY_NONE     ( ( uint8_t ) 0U )
+#define queueCOPY_BYTE     ( ( uint8_t ) 1U )
+#define queueCOPY_WORD     ( ( uint8_t ) 2U )
+#define queueCOPY_LONG     ( ( uint8_t ) 3U )
+#define queueCOPY_BLOCK    ( ( uint8_t ) 4U )
+
+/* The copy class for items of xItemSize bytes. */
+#define queueCOPY_SELECT_CLASS( xItemSize )                  \
+    ( ( ( xItemSize ) == 0U ) ? queueCOPY_NONE :             \
+      ( ( xItemSize ) == 1U ) ? queueCOPY_BYTE :             \
+      ( ( xItemSize ) == 2U ) ? queueCOPY_WORD :             \
+      ( ( xItemSize ) == 4U ) ? queueCOPY_LONG : queueCOPY_BLOCK )
+
+/*
+ * Copy one item of xItemSize bytes, which must be the size ucClass was
+ * selected for.
+ */
+#define queueCOPY_ITEM( ucClass, pvDest, pvSource, xItemSize )                     \
+    do {                                                                           \
+        uint8_t * const pucCopyDest = ( uint8_t * ) ( pvDest );                    \
+        const uint8_t * const pucCopySource = ( const uint8_t * ) ( pvSource );    \
+                                                                                   \
+        switch( ucClass )                                                          \
+        {                                                                          \
+            case queueCOPY_BYTE:                                                   \
+                pucCopyDest[ 0 ] = pucCopySource[ 0 ];                             \
+                break;                                                             \
+                                                                                   \
+            case queueCOPY_WORD:                                                   \
+                pucCopyDest[ 0 ] = pucCopySource[ 0 ];                             \
+                pucCopyDest[ 1 ] = pucCopySource[ 1 ];                             \
+                break;                                                             \
+                                                                                   \
+            case queueCOPY_LONG:                                                   \
+                pucCopyDest[ 0 ] = pucCopySource[ 0 ];                             \
+                pucCopyDest[ 1 ] = pucCopySource[ 1 ];                             \
+                pucCopyDest[ 2 ] = pucCopySource[ 2 ];                             \
+                pucCopyDest[ 3 ] = pucCopySource[ 3 ];                             \
+                break;                                                             \
+                                                                                   \
+            case queueCOPY_BLOCK:                                                  \
+                ( void ) memcpy( pucCopyDest, pucCopySource, ( size_t ) ( xItemSize ) ); \
+                break;                                                             \
+                                                                                   \
+            default:                                                               \
+                /* queueCOPY_NONE, nothing to copy. */                             \
+                break;                                                             \
+        }                                                                          \
+    } while( 0 )
+
+#endif /* QUEUE_COPY_H */
@@ -0,0 +1,232 @@
+/*
+ * This file is NOT part of the FreeRTOS distribution.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+/* FreeRTOS includes. */
+#include "Arduino_FreeRTOS.h"
+#include "task.h"
+#include "ram_account.h"
+
+#if ( configUSE_RAM_ACCOUNTING == 1 )
+
+    #if ( configUSE_TRACE_FACILITY != 1 ) || ( configRECORD_STACK_HIGH_ADDRESS != 1 )
+        #error configUSE_RAM_ACCOUNTING requires configUSE_TRACE_FACILITY and configRECORD_STACK_HIGH_ADDRESS to be 1
+    #endif
+
+    #if ( INCLUDE_xTaskGetCurrentTaskHandle != 1 ) || ( INCLUDE_xTaskGetSchedulerState != 1 )
+        #error configUSE_RAM_ACCOUNTING requires INCLUDE_xTaskGetCurrentTaskHandle and INCLUDE_xTaskGetSchedulerState to be 1
+    #endif
+
+/* Totals by kind of RAM. */
+    PRIVILEGED_DATA static RamUsage_t xUsage[ eRamNumberOfTypes ];
+
+/* Totals by owner.  Entry 0 is always the start up code, an entry with a task
+ * number of 0 anywhere else is free. */
+    PRIVILEGED_DATA static RamOwner_t xOwners[ ramaccountMAX_OWNERS + 1 ];
+
+/*-----------------------------------------------------------*/
+
+/* Must be called from a critical section.  Falls back to entry 0 for owners
+ * that never got an entry of their own. */
+    static RamOwner_t * prvFindOwner( UBaseType_t uxOwner )
+    {
+        UBaseType_t x;
+
+        if( uxOwner != 0U )
+        {
+            for( x = 1; x <= ( UBaseType_t ) ramaccountMAX_OWNERS; x++ )
+            {
+                if( xOwners[ x ].uxTaskNumber == uxOwner )
+                {
+                    return &( xOwners[ x ] );
+                }
+            }
+        }
+
+        return &( xOwners[ 0 ] );
+    }
+/*-----------------------------------------------------------*/
+
+/* Must be called from a critical section. */
+    static void prvReleaseIfEmpty( RamOwner_t * pxOwner )
+    {
+        if( ( pxOwner != &( xOwners[ 0 ] ) ) && ( pxOwner->xHandle == NULL ) && ( pxOwner->xBytes == 0U ) )
+        {
+            pxOwner->uxTaskNumber = 0U;
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    UBaseType_t uxRamAccountOwner( void )
+    {
+        TaskHandle_t xCurrent;
+        UBaseType_t x, uxOwner = 0U;
+
+        /* Before the scheduler starts the current task is just the highest
+         * priority task created so far, not the code creating the object. */
+        if( xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED )
+        {
+            xCurrent = xTaskGetCurrentTaskHandle();
+
+            taskENTER_CRITICAL();
+            {
+                for( x = 1; x <= ( UBaseType_t ) ramaccountMAX_OWNERS; x++ )
+                {
+                    if( ( xOwners[ x ].uxTaskNumber != 0U ) && ( xOwners[ x ].xHandle == xCurrent ) )
+                    {
+                        uxOwner = xOwners[ x ].uxTaskNumber;
+                        break;
+                    }
+                }
+            }
+            taskEXIT_CRITICAL();
+        }
+
+        return uxOwner;
+    }
+/*-----------------------------------------------------------*/
+
+    void vRamAccountAdd( UBaseType_t uxOwner,
+                         eRamObjectType eType,
+                         size_t xBytes )
+    {
+        RamOwner_t * pxOwner;
+
+        taskENTER_CRITICAL();
+        {
+            xUsage[ eType ].usObjects++;
+            xUsage[ eType ].xBytes += xBytes;
+
+            if( eType != eRamHeapOverhead )
+            {
+                pxOwner = prvFindOwner( uxOwner );
+                pxOwner->xBytes += xBytes;
+            }
+        }
+        taskEXIT_CRITICAL();
+    }
+/*-----------------------------------------------------------*/
+
+    void vRamAccountRemove( UBaseType_t uxOwner,
+                            eRamObjectType eType,
+                            size_t xBytes )
+    {
+        RamOwner_t * pxOwner;
+
+        taskENTER_CRITICAL();
+        {
+            xUsage[ eType ].usObjects--;
+            xUsage[ eType ].xBytes -= xBytes;
+
+            if( eType != eRamHeapOverhead )
+            {
+                pxOwner = prvFindOwner( uxOwner );
+                pxOwner->xBytes -= xBytes;
+                prvReleaseIfEmpty( pxOwner );
+            }
+        }
+        taskEXIT_CRITICAL();
+    }
+/*-----------------------------------------------------------*/
+
+    void vRamAccountTaskCreated( TaskHandle_t xTask,
+                                 UBaseType_t uxTaskNumber )
+    {
+        UBaseType_t x;
+
+        taskENTER_CRITICAL();
+        {
+            for( x = 1; x <= ( UBaseType_t ) ramaccountMAX_OWNERS; x++ )
+            {
+                if( xOwners[ x ].uxTaskNumber == 0U )
+                {
+                    xOwners[ x ].uxTaskNumber = uxTaskNumber;
+                    xOwners[ x ].xHandle = xTask;
+                    xOwners[ x ].xBytes = 0U;
+                    break;
+                }
+            }
+        }
+        taskEXIT_CRITICAL();
+    }
+/*-----------------------------------------------------------*/
+
+    void vRamAccountTaskDeleted( UBaseType_t uxTaskNumber )
+    {
+        RamOwner_t * pxOwner;
+
+        taskENTER_CRITICAL();
+        {
+            pxOwner = prvFindOwner( uxTaskNumber );
+
+            if( pxOwner != &( xOwners[ 0 ] ) )
+            {
+                /* Whatever the task created is still attributed to it. */
+                pxOwner->xHandle = NULL;
+                prvReleaseIfEmpty( pxOwner );
+            }
+        }
+        taskEXIT_CRITICAL();
+    }
+/*-----------------------------------------------------------*/
+
+    void vRamAccountGetUsage( RamUsage_t * pxUsage )
+    {
+        UBaseType_t x;
+
+        configASSERT( pxUsage );
+
+        taskENTER_CRITICAL();
+        {
+            for( x = 0; x < ( UBaseType_t ) eRamNumberOfTypes; x++ )
+            {
+                pxUsage[ x ] = xUsage[ x ];
+            }
+        }
+        taskEXIT_CRITICAL();
+    }
+/*-----------------------------------------------------------*/
+
+    UBaseType_t uxRamAccountGetOwners( RamOwner_t * pxOwners,
+                                       UBaseType_t uxArraySize )
+    {
+        UBaseType_t x, uxFilled = 0;
+
+        configASSERT( pxOwners );
+
+        taskENTER_CRITICAL();
+        {
+            for( x = 0; ( x <= ( UBaseType_t ) ramaccountMAX_OWNERS ) && ( uxFilled < uxArraySize ); x++ )
+            {
+                if( ( ( x == 0U ) || ( xOwners[ x ].uxTaskNumber != 0U ) ) && ( xOwners[ x ].xBytes != 0U ) )
+                {
+                    pxOwners[ uxFilled ] = xOwners[ x ];
+                    uxFilled++;
+                }
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        return uxFilled;
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* configUSE_RAM_ACCOUNTING */
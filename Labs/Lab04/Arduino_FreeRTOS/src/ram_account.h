@@ -0,0 +1,159 @@
+/*
+ * This file is NOT part of the FreeRTOS distribution.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+/*
+ * RAM accounting for kernel objects.  With configUSE_RAM_ACCOUNTING set to 1
+ * the kernel reports every task, queue, timer, event group and stream buffer
+ * it creates or deletes here, so the RAM they hold can be broken down both by
+ * object type and by the task that owns it.
+ *
+ * A task owns its own TCB and stack, and every other object it creates.
+ * Objects created before the scheduler starts belong to owner number 0,
+ * which is reported as the start up code.  Objects keep their owner after the
+ * owning task is deleted.
+ *
+ * Statically allocated objects are counted the same as ones taken from the
+ * heap, since they hold RAM all the same.  Heap overhead is the per block
+ * bookkeeping of the C library malloc() behind heap_3.c.  It has no owner.
+ *
+ * Requires configUSE_TRACE_FACILITY and configRECORD_STACK_HIGH_ADDRESS to be
+ * 1, and INCLUDE_xTaskGetCurrentTaskHandle and INCLUDE_xTaskGetSchedulerState
+ * to be 1, in FreeRTOSConfig.h.
+ */
+
+#ifndef RAM_ACCOUNT_H
+#define RAM_ACCOUNT_H
+
+#ifndef INC_ARDUINO_FREERTOS_H
+    #error "include Arduino_FreeRTOS.h must appear in source files before include ram_account.h"
+#endif
+
+#include "task.h"
+
+/* *INDENT-OFF* */
+#if defined( __cplusplus )
+    extern "C" {
+#endif
+/* *INDENT-ON* */
+
+/* The most tasks RAM can be attributed to at once.  Once the table is full
+ * further tasks, and the objects they create, are counted against owner 0. */
+#ifndef ramaccountMAX_OWNERS
+    #define ramaccountMAX_OWNERS               12
+#endif
+
+/* Bytes of bookkeeping malloc() keeps with each block, two on avr-libc. */
+#ifndef ramaccountHEAP_BLOCK_OVERHEAD
+    #define ramaccountHEAP_BLOCK_OVERHEAD      sizeof( size_t )
+#endif
+
+/* The size of each kernel object for the current FreeRTOSConfig.h.  The
+ * static structures are guaranteed to match the private ones. */
+#define ramaccountSIZEOF_TCB                   sizeof( StaticTask_t )
+#define ramaccountSIZEOF_QUEUE                 sizeof( StaticQueue_t )
+#define ramaccountSIZEOF_TIMER                 sizeof( StaticTimer_t )
+#define ramaccountSIZEOF_EVENT_GROUP           sizeof( StaticEventGroup_t )
+#define ramaccountSIZEOF_STREAM_BUFFER         sizeof( StaticStreamBuffer_t )
+
+/* Kinds of RAM that are accounted for. */
+typedef enum
+{
+    eRamTCB = 0,              /* Task control blocks. */
+    eRamStack,                /* Task stacks. */
+    eRamQueue,                /* Queue_t, including semaphores and mutexes. */
+    eRamQueueStorage,         /* Queue item storage. */
+    eRamTimer,                /* Software timers. */
+    eRamEventGroup,           /* Event groups. */
+    eRamStreamBuffer,         /* StreamBuffer_t, including message buffers. */
+    eRamStreamBufferStorage,  /* Stream and message buffer storage. */
+    eRamHeapOverhead,         /* malloc() bookkeeping, one object per block. */
+    eRamNumberOfTypes
+} eRamObjectType;
+
+/**
+ * Live objects and bytes of one kind of RAM, see vRamAccountGetUsage().
+ */
+typedef struct RamUsage
+{
+    uint16_t usObjects;
+    size_t xBytes;
+} RamUsage_t;
+
+/**
+ * RAM held by one owner, see uxRamAccountGetOwners().
+ */
+typedef struct RamOwner
+{
+    UBaseType_t uxTaskNumber; /*< 0 for the start up code. */
+    TaskHandle_t xHandle;     /*< NULL for the start up code or a deleted task. */
+    size_t xBytes;            /*< Bytes of every kind except heap overhead. */
+} RamOwner_t;
+
+/**
+ * Get the live objects and bytes of every kind of RAM.
+ *
+ * @param pxUsage Array of eRamNumberOfTypes entries, indexed by
+ * eRamObjectType.
+ */
+void vRamAccountGetUsage( RamUsage_t * pxUsage ) PRIVILEGED_FUNCTION;
+
+/**
+ * Get the RAM held by each owner that still holds any.
+ *
+ * @param pxOwners Array to fill.
+ * @param uxArraySize Number of entries in pxOwners.
+ *
+ * @return The number of entries filled in.
+ */
+UBaseType_t uxRamAccountGetOwners( RamOwner_t * pxOwners,
+                                   UBaseType_t uxArraySize ) PRIVILEGED_FUNCTION;
+
+/*
+ * THE FOLLOWING FUNCTIONS ARE CALLED BY THE KERNEL AS OBJECTS ARE CREATED AND
+ * DELETED, THEY SHOULD NOT BE CALLED FROM APPLICATION CODE.
+ */
+
+/* The owner number to record in an object created by the calling task. */
+UBaseType_t uxRamAccountOwner( void ) PRIVILEGED_FUNCTION;
+
+void vRamAccountAdd( UBaseType_t uxOwner,
+                     eRamObjectType eType,
+                     size_t xBytes ) PRIVILEGED_FUNCTION;
+
+void vRamAccountRemove( UBaseType_t uxOwner,
+                        eRamObjectType eType,
+                        size_t xBytes ) PRIVILEGED_FUNCTION;
+
+/* Give a new task its own owner entry, before its TCB and stack are added. */
+void vRamAccountTaskCreated( TaskHandle_t xTask,
+                             UBaseType_t uxTaskNumber ) PRIVILEGED_FUNCTION;
+
+/* Called once the TCB and stack of a deleted task have been removed. */
+void vRamAccountTaskDeleted( UBaseType_t uxTaskNumber ) PRIVILEGED_FUNCTION;
+
+/* *INDENT-OFF* */
+#if defined( __cplusplus )
+    }
+#endif
+/* *INDENT-ON* */
+
+#endif /* RAM_ACCOUNT_H */
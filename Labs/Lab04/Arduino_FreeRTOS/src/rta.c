@@ -0,0 +1,197 @@
+/*
+ * This file is NOT part of the FreeRTOS distribution.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+#include "rta.h"
+
+/*
+ * The blocking term of task uxTask, see rta.h.
+ */
+static uint32_t prvBlocking( const RtaTask_t * pxTasks,
+                             size_t uxTaskCount,
+                             size_t uxTask,
+                             const RtaMutex_t * pxMutexes,
+                             size_t uxMutexCount );
+
+/*
+ * The highest priority of any task using a mutex.
+ */
+static uint8_t prvCeiling( const RtaTask_t * pxTasks,
+                           size_t uxTaskCount,
+                           const RtaMutex_t * pxMutex );
+
+/*-----------------------------------------------------------*/
+
+static uint8_t prvCeiling( const RtaTask_t * pxTasks,
+                           size_t uxTaskCount,
+                           const RtaMutex_t * pxMutex )
+{
+    uint8_t ucCeiling = 0U;
+    size_t x;
+
+    for( x = 0; x < uxTaskCount; x++ )
+    {
+        if( ( ( pxMutex->ulUsers >> x ) & 1UL ) && ( pxTasks[ x ].ucPriority > ucCeiling ) )
+        {
+            ucCeiling = pxTasks[ x ].ucPriority;
+        }
+    }
+
+    return ucCeiling;
+}
+/*-----------------------------------------------------------*/
+
+static uint32_t prvBlocking( const RtaTask_t * pxTasks,
+                             size_t uxTaskCount,
+                             size_t uxTask,
+                             const RtaMutex_t * pxMutexes,
+                             size_t uxMutexCount )
+{
+    const uint8_t ucPriority = pxTasks[ uxTask ].ucPriority;
+    uint32_t ulByTask = 0UL, ulByMutex = 0UL, ulLongest;
+    uint32_t ulLower = 0UL;
+    size_t x, m;
+
+    /* Tasks that can block this one - strictly lower priority.  Equal
+     * priority tasks are already counted as interference. */
+    for( x = 0; x < uxTaskCount; x++ )
+    {
+        if( pxTasks[ x ].ucPriority < ucPriority )
+        {
+            ulLower |= 1UL << x;
+        }
+    }
+
+    /* Once per lower priority task: its longest critical section on any mutex
+     * that can block this task. */
+    for( x = 0; x < uxTaskCount; x++ )
+    {
+        if( ( ( ulLower >> x ) & 1UL ) == 0UL )
+        {
+            continue;
+        }
+
+        ulLongest = 0UL;
+
+        for( m = 0; m < uxMutexCount; m++ )
+        {
+            if( ( ( pxMutexes[ m ].ulUsers >> x ) & 1UL ) &&
+                ( prvCeiling( pxTasks, uxTaskCount, &pxMutexes[ m ] ) >= ucPriority ) &&
+                ( pxMutexes[ m ].ulHoldTime > ulLongest ) )
+            {
+                ulLongest = pxMutexes[ m ].ulHoldTime;
+            }
+        }
+
+        ulByTask += ulLongest;
+    }
+
+    /* Once per mutex that a lower priority task can hold while this task, or
+     * a task it inherits from, waits for it. */
+    for( m = 0; m < uxMutexCount; m++ )
+    {
+        if( ( ( pxMutexes[ m ].ulUsers & ulLower ) != 0UL ) &&
+            ( prvCeiling( pxTasks, uxTaskCount, &pxMutexes[ m ] ) >= ucPriority ) )
+        {
+            ulByMutex += pxMutexes[ m ].ulHoldTime;
+        }
+    }
+
+    return ( ulByTask < ulByMutex ) ? ulByTask : ulByMutex;
+}
+/*-----------------------------------------------------------*/
+
+size_t xRtaAnalyse( RtaTask_t * pxTasks,
+                    size_t uxTaskCount,
+                    const RtaMutex_t * pxMutexes,
+                    size_t uxMutexCount )
+{
+    size_t uxMisses = 0;
+    size_t x, j;
+    uint32_t ulDeadline;
+    uint64_t ullResponse, ullNext;
+
+    if( uxTaskCount > rtaMAX_TASKS )
+    {
+        uxTaskCount = rtaMAX_TASKS;
+    }
+
+    if( pxMutexes == NULL )
+    {
+        uxMutexCount = 0;
+    }
+
+    for( x = 0; x < uxTaskCount; x++ )
+    {
+        RtaTask_t * const pxTask = &pxTasks[ x ];
+
+        ulDeadline = ( pxTask->ulDeadline != 0UL ) ? pxTask->ulDeadline : pxTask->ulPeriod;
+        pxTask->ulBlocking = prvBlocking( pxTasks, uxTaskCount, x, pxMutexes, uxMutexCount );
+
+        /* The response time only grows from one iteration to the next, so
+         * either it settles or it passes the deadline and the search stops. */
+        ullNext = ( uint64_t ) pxTask->ulWcet + pxTask->ulBlocking;
+
+        do
+        {
+            ullResponse = ullNext;
+            ullNext = ( uint64_t ) pxTask->ulWcet + pxTask->ulBlocking;
+
+            for( j = 0; j < uxTaskCount; j++ )
+            {
+                if( ( j != x ) && ( pxTasks[ j ].ucPriority >= pxTask->ucPriority ) && ( pxTasks[ j ].ulPeriod != 0UL ) )
+                {
+                    ullNext += ( ( ullResponse + pxTasks[ j ].ulPeriod - 1U ) / pxTasks[ j ].ulPeriod ) * pxTasks[ j ].ulWcet;
+                }
+            }
+        } while( ( ullNext != ullResponse ) && ( ullNext <= ulDeadline ) );
+
+        pxTask->ulResponse = ( ullNext > UINT32_MAX ) ? UINT32_MAX : ( uint32_t ) ullNext;
+        pxTask->ucSchedulable = ( ullNext <= ulDeadline ) ? 1U : 0U;
+        pxTask->lSlack = ( int32_t ) ( ( int64_t ) ulDeadline - ( int64_t ) pxTask->ulResponse );
+
+        if( pxTask->ucSchedulable == 0U )
+        {
+            uxMisses++;
+        }
+    }
+
+    return uxMisses;
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulRtaUtilisation( const RtaTask_t * pxTasks,
+                           size_t uxTaskCount )
+{
+    uint32_t ulUtilisation = 0UL;
+    size_t x;
+
+    for( x = 0; x < uxTaskCount; x++ )
+    {
+        if( pxTasks[ x ].ulPeriod != 0UL )
+        {
+            ulUtilisation += ( uint32_t ) ( ( ( uint64_t ) pxTasks[ x ].ulWcet * 1000U ) / pxTasks[ x ].ulPeriod );
+        }
+    }
+
+    return ulUtilisation;
+}
+/*-----------------------------------------------------------*/
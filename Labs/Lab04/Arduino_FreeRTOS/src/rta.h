@@ -0,0 +1,128 @@
+/*
+ * This file is NOT part of the FreeRTOS distribution.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+/*
+ * Response time analysis (RTA) for fixed priority preemptive scheduling.
+ *
+ * Given each task's period, deadline, priority, worst case execution time
+ * (WCET) and the mutexes it shares, xRtaAnalyse() computes the worst case
+ * response time of every task by iterating
+ *
+ *     R = C + B + sum over interfering tasks j of ceil( R / Tj ) * Cj
+ *
+ * to a fixed point, where C is the task's WCET and B its blocking term.  A
+ * task is schedulable when R is no more than its deadline, and its slack is
+ * the difference.
+ *
+ * Tasks of equal priority are time sliced by FreeRTOS, so each is counted as
+ * interference for the others.  This is safe but pessimistic.
+ *
+ * The blocking term is derived from mutex hold times, as measured by
+ * ulQueueGetMutexMaxHoldTime().  A mutex's ceiling is the highest priority of
+ * the tasks that use it.  With priority inheritance a task can be blocked once
+ * by each lower priority task, and once per mutex, so B is the smaller of
+ *
+ *   + the sum, over lower priority tasks, of the longest hold of any mutex
+ *     whose ceiling is at least the task's priority, and
+ *   + the sum, over those mutexes, of the longest hold by a lower priority
+ *     task.
+ *
+ * The analysis is plain C with no kernel dependencies, so the same code runs
+ * on the board against live measurements and on the host (see extras/rta).
+ * Times may be in any unit, as long as they are all in the same one.
+ */
+
+#ifndef RTA_H
+#define RTA_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* *INDENT-OFF* */
+#if defined( __cplusplus )
+    extern "C" {
+#endif
+/* *INDENT-ON* */
+
+/* The largest number of tasks one analysis can take, one bit per task in
+ * RtaMutex_t::ulUsers. */
+#define rtaMAX_TASKS    32U
+
+/**
+ * One task.  Fill in the inputs, xRtaAnalyse() fills in the results.
+ */
+typedef struct RtaTask
+{
+    /* Inputs. */
+    const char * pcName;         /*< Only used for reporting. */
+    uint32_t ulPeriod;           /*< Minimum time between releases. */
+    uint32_t ulDeadline;         /*< Relative deadline, 0 for the period. */
+    uint32_t ulWcet;             /*< Worst case execution time. */
+    uint8_t ucPriority;          /*< FreeRTOS priority, higher runs first. */
+
+    /* Results. */
+    uint32_t ulBlocking;         /*< Blocking term derived from the mutexes. */
+    uint32_t ulResponse;         /*< Worst case response time, or the first value past the deadline. */
+    int32_t lSlack;              /*< Deadline minus response time, negative if unschedulable. */
+    uint8_t ucSchedulable;       /*< 1 if the response time meets the deadline. */
+} RtaTask_t;
+
+/**
+ * One mutex shared between tasks.
+ */
+typedef struct RtaMutex
+{
+    const char * pcName;         /*< Only used for reporting. */
+    uint32_t ulHoldTime;         /*< Longest time any task holds the mutex. */
+    uint32_t ulUsers;            /*< Bit n set if task n takes the mutex. */
+} RtaMutex_t;
+
+/**
+ * Run response time analysis on a task set.
+ *
+ * @param pxTasks The tasks, in any order.  Results are written back.
+ * @param uxTaskCount Number of tasks, at most rtaMAX_TASKS.
+ * @param pxMutexes The mutexes the tasks share, may be NULL.
+ * @param uxMutexCount Number of mutexes.
+ *
+ * @return The number of tasks that can miss their deadline, so 0 means the
+ * task set is schedulable.
+ */
+size_t xRtaAnalyse( RtaTask_t * pxTasks,
+                    size_t uxTaskCount,
+                    const RtaMutex_t * pxMutexes,
+                    size_t uxMutexCount );
+
+/**
+ * @return The total utilisation of a task set in parts per thousand.  Above
+ * 1000 no analysis can make it schedulable.
+ */
+uint32_t ulRtaUtilisation( const RtaTask_t * pxTasks,
+                           size_t uxTaskCount );
+
+/* *INDENT-OFF* */
+#if defined( __cplusplus )
+    }
+#endif
+/* *INDENT-ON* */
+
+#endif /* RTA_H */
@@ -0,0 +1,115 @@
+/*
+ * This file is NOT part of the FreeRTOS distribution.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+/* FreeRTOS includes. */
+#include "Arduino_FreeRTOS.h"
+#include "task.h"
+#include "stack_monitor.h"
+
+#if ( configUSE_TRACE_FACILITY != 1 ) || ( configRECORD_STACK_HIGH_ADDRESS != 1 )
+    #error "stack_monitor.c requires configUSE_TRACE_FACILITY and configRECORD_STACK_HIGH_ADDRESS to be 1"
+#endif
+
+/* Work area for uxTaskGetSystemState(). */
+PRIVILEGED_DATA static TaskStatus_t xStatus[ stackmonitorMAX_TASKS ];
+
+/*-----------------------------------------------------------*/
+
+static void prvFillUsage( const TaskStatus_t * pxStatus,
+                          StackUsage_t * pxUsage )
+{
+    pxUsage->xHandle = pxStatus->xHandle;
+    pxUsage->pcTaskName = pxStatus->pcTaskName;
+    pxUsage->usStackDepth = pxStatus->usStackDepth;
+    pxUsage->usHighWaterMark = pxStatus->usStackHighWaterMark;
+    pxUsage->usRecommended = usStackMonitorRecommend( pxStatus->usStackDepth, pxStatus->usStackHighWaterMark );
+}
+/*-----------------------------------------------------------*/
+
+configSTACK_DEPTH_TYPE usStackMonitorRecommend( configSTACK_DEPTH_TYPE usStackDepth,
+                                                configSTACK_DEPTH_TYPE usHighWaterMark )
+{
+    uint32_t ulUsed, ulMargin;
+
+    ulUsed = ( uint32_t ) usStackDepth - ( uint32_t ) usHighWaterMark;
+    ulMargin = ( ulUsed * ( uint32_t ) stackmonitorMARGIN_PERCENT + 99UL ) / 100UL;
+
+    if( ulMargin < ( uint32_t ) stackmonitorMARGIN_MIN )
+    {
+        ulMargin = ( uint32_t ) stackmonitorMARGIN_MIN;
+    }
+
+    return ( configSTACK_DEPTH_TYPE ) ( ulUsed + ulMargin );
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxStackMonitorSample( StackUsage_t * pxUsage,
+                                  UBaseType_t uxArraySize )
+{
+    UBaseType_t uxTasks, x;
+
+    configASSERT( pxUsage );
+
+    /* Scans every painted stack with the scheduler suspended. */
+    uxTasks = uxTaskGetSystemState( xStatus, stackmonitorMAX_TASKS, NULL );
+
+    if( uxTasks > uxArraySize )
+    {
+        uxTasks = 0;
+    }
+
+    for( x = 0; x < uxTasks; x++ )
+    {
+        prvFillUsage( &( xStatus[ x ] ), &( pxUsage[ x ] ) );
+    }
+
+    return uxTasks;
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxStackMonitorCheck( StackLowCallback_t pxCallback )
+{
+    UBaseType_t uxTasks, uxLow = 0, x;
+    StackUsage_t xUsage;
+
+    uxTasks = uxTaskGetSystemState( xStatus, stackmonitorMAX_TASKS, NULL );
+
+    /* An undersized work area should not pass silently as "all stacks fine". */
+    configASSERT( uxTasks > 0 );
+
+    for( x = 0; x < uxTasks; x++ )
+    {
+        if( xStatus[ x ].usStackHighWaterMark < ( configSTACK_DEPTH_TYPE ) stackmonitorWARN_FREE )
+        {
+            uxLow++;
+
+            if( pxCallback != NULL )
+            {
+                prvFillUsage( &( xStatus[ x ] ), &xUsage );
+                pxCallback( &xUsage );
+            }
+        }
+    }
+
+    return uxLow;
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,137 @@
+/*
+ * This file is NOT part of the FreeRTOS distribution.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+/*
+ * Stack monitoring for every task in the system, including the idle and
+ * timer service tasks that the application does not create itself.
+ *
+ * configCHECK_FOR_STACK_OVERFLOW only reports an overflow after the damage is
+ * done.  New stacks are painted with a known byte, so the deepest a task has
+ * ever reached is the first unpainted byte from the far end of its stack.
+ * uxStackMonitorCheck() looks at that high-water mark for every task and
+ * warns about tasks running low before they overflow, and
+ * uxStackMonitorSample() turns it into a recommended stack depth so
+ * over-provisioned stacks can be cut back.
+ *
+ * A high-water mark only covers the code paths a task has actually run, so
+ * take the report after the application has been through its heavy cases.
+ * Interrupts are serviced on the stack of whichever task they interrupt,
+ * which is what the minimum margin allows for.
+ *
+ * The monitor samples into a shared work area, so only call it from one task
+ * at a time.  Requires configUSE_TRACE_FACILITY and
+ * configRECORD_STACK_HIGH_ADDRESS to be 1 in FreeRTOSConfig.h.
+ */
+
+#ifndef STACK_MONITOR_H
+#define STACK_MONITOR_H
+
+#ifndef INC_ARDUINO_FREERTOS_H
+    #error "include Arduino_FreeRTOS.h must appear in source files before include stack_monitor.h"
+#endif
+
+#include "task.h"
+
+/* *INDENT-OFF* */
+#if defined( __cplusplus )
+    extern "C" {
+#endif
+/* *INDENT-ON* */
+
+/* The most tasks that can be monitored at once, including idle and timer. */
+#ifndef stackmonitorMAX_TASKS
+    #define stackmonitorMAX_TASKS         12
+#endif
+
+/* The recommended depth is the deepest use seen plus this percentage... */
+#ifndef stackmonitorMARGIN_PERCENT
+    #define stackmonitorMARGIN_PERCENT    25
+#endif
+
+/* ...but never less than this many words.  An AVR interrupt saves about 40
+ * bytes of context on the interrupted task's stack. */
+#ifndef stackmonitorMARGIN_MIN
+    #define stackmonitorMARGIN_MIN        48
+#endif
+
+/* uxStackMonitorCheck() warns about tasks with fewer words than this left. */
+#ifndef stackmonitorWARN_FREE
+    #define stackmonitorWARN_FREE         stackmonitorMARGIN_MIN
+#endif
+
+/**
+ * Stack usage of one task, filled in by uxStackMonitorSample().  All sizes are
+ * in words, the unit xTaskCreate() takes.
+ */
+typedef struct StackUsage
+{
+    TaskHandle_t xHandle;                   /*< The task. */
+    const char * pcTaskName;                /*< Invalid once the task is deleted. */
+    configSTACK_DEPTH_TYPE usStackDepth;    /*< Depth the task was created with. */
+    configSTACK_DEPTH_TYPE usHighWaterMark; /*< Fewest words ever left free. */
+    configSTACK_DEPTH_TYPE usRecommended;   /*< Deepest use plus the safety margin. */
+} StackUsage_t;
+
+/**
+ * Called by uxStackMonitorCheck() for a task that is running low on stack.
+ */
+typedef void (* StackLowCallback_t)( const StackUsage_t * pxUsage );
+
+/**
+ * Sample the stack usage of every task.  The scheduler is suspended while the
+ * painted stacks are scanned, which takes longer the more unused stack there
+ * is.
+ *
+ * @param pxUsage Array to fill, one entry per task.
+ * @param uxArraySize Number of entries in pxUsage.
+ *
+ * @return The number of entries filled in, or 0 if there are more tasks than
+ * uxArraySize or stackmonitorMAX_TASKS.
+ */
+UBaseType_t uxStackMonitorSample( StackUsage_t * pxUsage,
+                                  UBaseType_t uxArraySize ) PRIVILEGED_FUNCTION;
+
+/**
+ * Check every task's stack and report each one with fewer than
+ * stackmonitorWARN_FREE words left.  Call it periodically, for example from a
+ * low priority periodic task, to catch a stack closing in on overflow.
+ *
+ * @param pxCallback Called once per task running low, may be NULL.
+ *
+ * @return The number of tasks running low.
+ */
+UBaseType_t uxStackMonitorCheck( StackLowCallback_t pxCallback ) PRIVILEGED_FUNCTION;
+
+/**
+ * The depth recommended for a task created with usStackDepth words whose
+ * high-water mark is usHighWaterMark.
+ */
+configSTACK_DEPTH_TYPE usStackMonitorRecommend( configSTACK_DEPTH_TYPE usStackDepth,
+                                                configSTACK_DEPTH_TYPE usHighWaterMark ) PRIVILEGED_FUNCTION;
+
+/* *INDENT-OFF* */
+#if defined( __cplusplus )
+    }
+#endif
+/* *INDENT-ON* */
+
+#endif /* STACK_MONITOR_H */
@@ -38,6 +38,10 @@
 #include "task.h"
 #include "stream_buffer.h"
 
+#if ( configUSE_RAM_ACCOUNTING == 1 )
+    #include "ram_account.h"
+#endif
+
 #if ( configUSE_TASK_NOTIFICATIONS != 1 )
     #error configUSE_TASK_NOTIFICATIONS must be set to 1 to build stream_buffer.c
 #endif
@@ -151,6 +155,9 @@ typedef struct StreamBufferDef_t                 /*lint !e9058 Style convention
     #if ( configUSE_TRACE_FACILITY == 1 )
         UBaseType_t uxStreamBufferNumber; /* Used for tracing purposes. */
     #endif
+    #if ( configUSE_RAM_ACCOUNTING == 1 )
+        UBaseType_t uxRamOwner; /* Number of the task that created the stream buffer, see ram_account.h. */
+    #endif
 } StreamBuffer_t;
 
 /*
@@ -213,6 +220,16 @@ static void prvInitialiseNewStreamBuffer( StreamBuffer_t * const pxStreamBuffer,
                                           size_t xTriggerLevelBytes,
                                           uint8_t ucFlags ) PRIVILEGED_FUNCTION;
 
+#if ( configUSE_RAM_ACCOUNTING == 1 )
+
+/*
+ * Record the owner of a newly created stream buffer and account for it.  Not
+ * done in prvInitialiseNewStreamBuffer() as that is also used to reset one.
+ */
+    static void prvAccountNewStreamBuffer( StreamBuffer_t * const pxStreamBuffer ) PRIVILEGED_FUNCTION;
+
+#endif
+
 /*-----------------------------------------------------------*/
 
 #if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
@@ -277,6 +294,12 @@ static void prvInitialiseNewStreamBuffer( StreamBuffer_t * const pxStreamBuffer,
                                           xTriggerLevelBytes,
                                           ucFlags );
 
+            #if ( configUSE_RAM_ACCOUNTING == 1 )
+                {
+                    prvAccountNewStreamBuffer( ( StreamBuffer_t * ) pucAllocatedMemory );
+                }
+            #endif
+
             traceSTREAM_BUFFER_CREATE( ( ( StreamBuffer_t * ) pucAllocatedMemory ), xIsMessageBuffer );
         }
         else
@@ -352,6 +375,12 @@ static void prvInitialiseNewStreamBuffer( StreamBuffer_t * const pxStreamBuffer,
              * again. */
             pxStreamBuffer->ucFlags |= sbFLAGS_IS_STATICALLY_ALLOCATED;
 
+            #if ( configUSE_RAM_ACCOUNTING == 1 )
+                {
+                    prvAccountNewStreamBuffer( pxStreamBuffer );
+                }
+            #endif
+
             traceSTREAM_BUFFER_CREATE( pxStreamBuffer, xIsMessageBuffer );
 
             xReturn = ( StreamBufferHandle_t ) pxStaticStreamBuffer; /*lint !e9087 Data hiding requires cast to opaque type. */
@@ -376,6 +405,13 @@ void vStreamBufferDelete( StreamBufferHandle_t xStreamBuffer )
 
     traceSTREAM_BUFFER_DELETE( xStreamBuffer );
 
+    #if ( configUSE_RAM_ACCOUNTING == 1 )
+        {
+            vRamAccountRemove( pxStreamBuffer->uxRamOwner, eRamStreamBuffer, sizeof( StreamBuffer_t ) );
+            vRamAccountRemove( pxStreamBuffer->uxRamOwner, eRamStreamBufferStorage, pxStreamBuffer->xLength );
+        }
+    #endif
+
     if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_STATICALLY_ALLOCATED ) == ( uint8_t ) pdFALSE )
     {
         #if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
@@ -410,6 +446,10 @@ BaseType_t xStreamBufferReset( StreamBufferHandle_t xStreamBuffer )
         UBaseType_t uxStreamBufferNumber;
     #endif
 
+    #if ( configUSE_RAM_ACCOUNTING == 1 )
+        UBaseType_t uxRamOwner = pxStreamBuffer->uxRamOwner;
+    #endif
+
     configASSERT( pxStreamBuffer );
 
     #if ( configUSE_TRACE_FACILITY == 1 )
@@ -440,6 +480,12 @@ BaseType_t xStreamBufferReset( StreamBufferHandle_t xStreamBuffer )
                     }
                 #endif
 
+                #if ( configUSE_RAM_ACCOUNTING == 1 )
+                    {
+                        pxStreamBuffer->uxRamOwner = uxRamOwner;
+                    }
+                #endif
+
                 traceSTREAM_BUFFER_RESET( xStreamBuffer );
             }
         }
@@ -1282,6 +1328,18 @@ static void prvInitialiseNewStreamBuffer( StreamBuffer_t * const pxStreamBuffer,
     pxStreamBuffer->ucFlags = ucFlags;
 }
 
+#if ( configUSE_RAM_ACCOUNTING == 1 )
+
+    static void prvAccountNewStreamBuffer( StreamBuffer_t * const pxStreamBuffer )
+    {
+        pxStreamBuffer->uxRamOwner = uxRamAccountOwner();
+        vRamAccountAdd( pxStreamBuffer->uxRamOwner, eRamStreamBuffer, sizeof( StreamBuffer_t ) );
+        vRamAccountAdd( pxStreamBuffer->uxRamOwner, eRamStreamBufferStorage, pxStreamBuffer->xLength );
+    }
+
+#endif /* configUSE_RAM_ACCOUNTING */
+/*-----------------------------------------------------------*/
+
 #if ( configUSE_TRACE_FACILITY == 1 )
 
     UBaseType_t uxStreamBufferGetStreamBufferNumber( StreamBufferHandle_t xStreamBuffer )
@@ -153,6 +153,7 @@ typedef struct xTASK_STATUS
     uint32_t ulRunTimeCounter;                       /* The total run time allocated to the task so far, as defined by the run time stats clock.  See https://www.FreeRTOS.org/rtos-run-time-stats.html.  Only valid when configGENERATE_RUN_TIME_STATS is defined as 1 in FreeRTOSConfig.h. */
     StackType_t * pxStackBase;                       /* Points to the lowest address of the task's stack area. */
     configSTACK_DEPTH_TYPE usStackHighWaterMark;     /* The minimum amount of stack space that has remained for the task since the task was created.  The closer this value is to zero the closer the task has come to overflowing its stack. */
+    configSTACK_DEPTH_TYPE usStackDepth;             /* The size of the task's stack in words.  Only valid if portSTACK_GROWTH is greater than 0 or configRECORD_STACK_HIGH_ADDRESS is defined as 1 in FreeRTOSConfig.h, otherwise 0. */
 } TaskStatus_t;
 
 /* Possible return values for eTaskConfirmSleepModeStatus(). */
@@ -879,6 +880,63 @@ BaseType_t xTaskDelayUntil( TickType_t * const pxPreviousWakeTime,
  */
 BaseType_t xTaskAbortDelay( TaskHandle_t xTask ) PRIVILEGED_FUNCTION;
 
+/**
+ * task. h
+ * <pre>
+ * void vTaskSetBudget( TaskHandle_t xTask, uint32_t ulBudgetUs, TickType_t xPeriod );
+ * </pre>
+ *
+ * configUSE_TASK_BUDGETS must be defined as 1 in FreeRTOSConfig.h for this
+ * function to be available.
+ *
+ * Reserve a share of the CPU for a task.  The task may run for ulBudgetUs
+ * microseconds in each period of xPeriod ticks.  Once the budget is used up
+ * the task is throttled - moved to the Blocked state - until the start of the
+ * next period, when the budget is replenished in full (deferrable server
+ * semantics).  Every throttle is counted and reported through
+ * vApplicationBudgetOverrunHook().
+ *
+ * Execution time is measured with portGET_RUN_TIME_COUNTER_VALUE() each time
+ * the task is switched out, but the budget is only enforced at a tick, so a
+ * task can overrun its budget by up to one tick.  A task that uses up its
+ * budget as it blocks is only throttled at the next tick it is running at, so
+ * its timeout is left alone.  A task throttled while it holds a mutex keeps it
+ * until it runs again.
+ *
+ * @param xTask The task to limit.  Passing NULL limits the calling task.
+ *
+ * @param ulBudgetUs Execution time allowed per period, or 0 to remove the
+ * limit.
+ *
+ * @param xPeriod The replenishment period in ticks.  The first period starts
+ * when this function is called.
+ *
+ * \defgroup vTaskSetBudget vTaskSetBudget
+ * \ingroup TaskCtrl
+ */
+void vTaskSetBudget( TaskHandle_t xTask,
+                     uint32_t ulBudgetUs,
+                     TickType_t xPeriod ) PRIVILEGED_FUNCTION;
+
+/**
+ * task. h
+ * <pre>
+ * uint16_t usTaskGetBudgetOverruns( TaskHandle_t xTask );
+ * </pre>
+ *
+ * configUSE_TASK_BUDGETS must be defined as 1 in FreeRTOSConfig.h for this
+ * function to be available.
+ *
+ * @param xTask The task to query.  Passing NULL queries the calling task.
+ *
+ * @return The number of times the task has been throttled for using up its
+ * budget.
+ *
+ * \defgroup usTaskGetBudgetOverruns usTaskGetBudgetOverruns
+ * \ingroup TaskCtrl
+ */
+uint16_t usTaskGetBudgetOverruns( TaskHandle_t xTask ) PRIVILEGED_FUNCTION;
+
 /**
  * task. h
  * <pre>
@@ -1597,6 +1655,23 @@ configSTACK_DEPTH_TYPE uxTaskGetStackHighWaterMark( TaskHandle_t xTask ) PRIVILE
 
 #endif
 
+#if ( configUSE_TASK_BUDGETS == 1 )
+    /**
+     *  task.h
+     *  <pre>void vApplicationBudgetOverrunHook( TaskHandle_t xTask, char * pcTaskName ); </pre>
+     *
+     * This hook function is called from the tick interrupt each time a task is
+     * throttled for using up its budget, see vTaskSetBudget().  It must not
+     * call any API function that might block.
+     *
+     * @param xTask the task that used up its budget.
+     * @param pcTaskName A character string containing the name of the task.
+     */
+    void vApplicationBudgetOverrunHook( TaskHandle_t xTask,
+                                        char * pcTaskName ); /*lint !e526 Symbol not defined as it is an application callback. */
+
+#endif
+
 #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
     /**
      * task.h
@@ -3000,6 +3075,22 @@ void vTaskStepTick( const TickType_t xTicksToJump ) PRIVILEGED_FUNCTION;
  */
 eSleepModeStatus eTaskConfirmSleepModeStatus( void ) PRIVILEGED_FUNCTION;
 
+/*
+ * Only available when configUSE_IDLE_POWER is set to 1.
+ * Called by the idle power manager (idle_power.h) from the idle task, with the
+ * scheduler suspended and interrupts disabled, to check it is ok to sleep
+ * until the next interrupt: no other task at the idle priority is ready to
+ * run, and nothing has been held pending since the scheduler was suspended.
+ */
+BaseType_t xTaskIdleMaySleep( void ) PRIVILEGED_FUNCTION;
+
+/*
+ * Only available when configUSE_IDLE_POWER is set to 1.
+ * Returns the number of tick interrupts that occurred while the scheduler was
+ * suspended and have not been processed yet.
+ */
+TickType_t xTaskGetPendedTicks( void ) PRIVILEGED_FUNCTION;
+
 /*
  * For internal use only.  Increment the mutex held count when a mutex is
  * taken and return the handle of the task that has taken the mutex.
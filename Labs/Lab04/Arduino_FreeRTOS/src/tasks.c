@@ -39,6 +39,10 @@
 #include "timers.h"
 #include "stack_macros.h"
 
+#if ( configUSE_RAM_ACCOUNTING == 1 )
+    #include "ram_account.h"
+#endif
+
 /* Lint e9021, e961 and e750 are suppressed as a MISRA exception justified
  * because the MPU ports require MPU_WRAPPERS_INCLUDED_FROM_API_FILE to be defined
  * for the header files above, but not in this file, in order to generate the
@@ -327,6 +331,14 @@ typedef struct tskTaskControlBlock       /* The old naming convention is used to
     #if ( configUSE_POSIX_ERRNO == 1 )
         int iTaskErrno;
     #endif
+
+    #if ( configUSE_TASK_BUDGETS == 1 )
+        uint32_t ulBudgetUs;              /*< Execution time the task may use in each budget period, 0 for no limit. */
+        uint32_t ulBudgetUsedUs;          /*< Execution time used so far in the current budget period. */
+        TickType_t xBudgetPeriod;         /*< Ticks between replenishments. */
+        TickType_t xBudgetPeriodStart;    /*< Tick at which the current budget period began. */
+        uint16_t usBudgetOverruns;        /*< Number of times the task was throttled for exhausting its budget. */
+    #endif
 } TCB_t;
 
 /*lint -save -e956 A manual analysis and inspection has been used to determine
@@ -399,6 +411,16 @@ PRIVILEGED_DATA static volatile UBaseType_t uxSchedulerSuspended = ( UBaseType_t
 
 #endif
 
+#if ( configUSE_TASK_BUDGETS == 1 )
+
+    #ifndef portGET_RUN_TIME_COUNTER_VALUE
+        #error configUSE_TASK_BUDGETS requires portGET_RUN_TIME_COUNTER_VALUE() to return a time in microseconds.
+    #endif
+
+    PRIVILEGED_DATA static uint32_t ulBudgetSwitchedInTime = 0UL; /*< Run time counter value when the running task was last charged. */
+
+#endif
+
 /*lint -restore */
 
 /*-----------------------------------------------------------*/
@@ -462,6 +484,23 @@ static void prvCheckTasksWaitingTermination( void ) PRIVILEGED_FUNCTION;
 static void prvAddCurrentTaskToDelayedList( TickType_t xTicksToWait,
                                             const BaseType_t xCanBlockIndefinitely ) PRIVILEGED_FUNCTION;
 
+#if ( configUSE_TASK_BUDGETS == 1 )
+
+/*
+ * Charge the running task for the time since it was last charged, starting a
+ * new budget period first if the current one has ended.  Called with
+ * interrupts disabled.
+ */
+    static void prvChargeBudget( void ) PRIVILEGED_FUNCTION;
+
+/*
+ * Move the running task to the delayed list until its budget is next
+ * replenished, and report the overrun.  Only called from the tick interrupt.
+ */
+    static void prvThrottleCurrentTask( const TickType_t xConstTickCount ) PRIVILEGED_FUNCTION;
+
+#endif
+
 /*
  * Fills an TaskStatus_t structure with information on each task that is
  * referenced from the pxList list (which may be a ready list, a delayed list,
@@ -996,6 +1035,16 @@ static void prvInitialiseNewTask( TaskFunction_t pxTaskCode,
         }
     #endif
 
+    #if ( configUSE_TASK_BUDGETS == 1 )
+        {
+            pxNewTCB->ulBudgetUs = 0UL;
+            pxNewTCB->ulBudgetUsedUs = 0UL;
+            pxNewTCB->xBudgetPeriod = 0U;
+            pxNewTCB->xBudgetPeriodStart = 0U;
+            pxNewTCB->usBudgetOverruns = 0U;
+        }
+    #endif
+
     /* Initialize the TCB stack to look as if the task was already running,
      * but had been interrupted by the scheduler.  The return address is set
      * to the start of the task function. Once the stack has been initialised
@@ -1117,6 +1166,15 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB )
                 pxNewTCB->uxTCBNumber = uxTaskNumber;
             }
         #endif /* configUSE_TRACE_FACILITY */
+
+        #if ( configUSE_RAM_ACCOUNTING == 1 )
+            {
+                /* A task owns its own TCB and stack. */
+                vRamAccountTaskCreated( ( TaskHandle_t ) pxNewTCB, pxNewTCB->uxTCBNumber );
+                vRamAccountAdd( pxNewTCB->uxTCBNumber, eRamTCB, sizeof( TCB_t ) );
+                vRamAccountAdd( pxNewTCB->uxTCBNumber, eRamStack, ( size_t ) ( ( pxNewTCB->pxEndOfStack - pxNewTCB->pxStack ) + 1 ) * sizeof( StackType_t ) );
+            }
+        #endif /* configUSE_RAM_ACCOUNTING */
         traceTASK_CREATE( pxNewTCB );
 
         prvAddTaskToReadyList( pxNewTCB );
@@ -2750,6 +2808,31 @@ BaseType_t xTaskIncrementTick( void )
             mtCOVERAGE_TEST_MARKER();
         }
 
+        /* Budgets can only be enforced at a tick, so a task may run up to one
+         * tick past its budget before it is throttled.  The running task may
+         * already have blocked, if this tick was pended while it did so and is
+         * being replayed by xTaskResumeAll(), or landed before it yielded.
+         * Throttling it then would move it off the list it is blocked on, so
+         * only a ready task is throttled, and the charge stays on the task for
+         * the next tick it is running at. */
+        #if ( configUSE_TASK_BUDGETS == 1 )
+            {
+                prvChargeBudget();
+
+                if( ( pxCurrentTCB->ulBudgetUs != 0UL ) &&
+                    ( pxCurrentTCB->ulBudgetUsedUs >= pxCurrentTCB->ulBudgetUs ) &&
+                    ( listIS_CONTAINED_WITHIN( &( pxReadyTasksLists[ pxCurrentTCB->uxPriority ] ), &( pxCurrentTCB->xStateListItem ) ) != pdFALSE ) )
+                {
+                    prvThrottleCurrentTask( xConstTickCount );
+                    xSwitchRequired = pdTRUE;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+        #endif /* configUSE_TASK_BUDGETS */
+
         /* See if this tick has made a timeout expire.  Tasks are stored in
          * the  queue in the order of their wake time - meaning once one task
          * has been found whose block time has not expired there is no need to
@@ -3046,6 +3129,12 @@ void vTaskSwitchContext( void )
             }
         #endif /* configGENERATE_RUN_TIME_STATS */
 
+        #if ( configUSE_TASK_BUDGETS == 1 )
+            {
+                prvChargeBudget();
+            }
+        #endif
+
         /* Check for stack overflow, if configured. */
         taskCHECK_FOR_STACK_OVERFLOW();
 
@@ -3377,7 +3466,7 @@ void vTaskMissedYield( void )
 
         if( xTask != NULL )
         {
-            pxTCB = xTask;
+            pxTCB = ( TCB_t const * ) xTask;
             uxReturn = pxTCB->uxTaskNumber;
         }
         else
@@ -3400,7 +3489,7 @@ void vTaskMissedYield( void )
 
         if( xTask != NULL )
         {
-            pxTCB = xTask;
+            pxTCB = ( TCB_t * ) xTask;
             pxTCB->uxTaskNumber = uxHandle;
         }
     }
@@ -3583,6 +3672,49 @@ static portTASK_FUNCTION( prvIdleTask, pvParameters )
 #endif /* configUSE_TICKLESS_IDLE */
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_IDLE_POWER == 1 )
+
+    BaseType_t xTaskIdleMaySleep( void )
+    {
+        BaseType_t xReturn = pdTRUE;
+
+        /* This function must be called from the idle task with the scheduler
+         * suspended and interrupts disabled. */
+
+        if( listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ tskIDLE_PRIORITY ] ) ) > ( UBaseType_t ) 1 )
+        {
+            /* Another task shares the idle priority and is ready to run. */
+            xReturn = pdFALSE;
+        }
+        else if( listCURRENT_LIST_LENGTH( &xPendingReadyList ) != 0 )
+        {
+            xReturn = pdFALSE;
+        }
+        else if( xYieldPending != pdFALSE )
+        {
+            xReturn = pdFALSE;
+        }
+        else if( xPendedTicks != 0 )
+        {
+            xReturn = pdFALSE;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    TickType_t xTaskGetPendedTicks( void )
+    {
+        return xPendedTicks;
+    }
+
+#endif /* configUSE_IDLE_POWER */
+/*-----------------------------------------------------------*/
+
 #if ( configNUM_THREAD_LOCAL_STORAGE_POINTERS != 0 )
 
     void vTaskSetThreadLocalStoragePointer( TaskHandle_t xTaskToSet,
@@ -3721,6 +3853,16 @@ static void prvCheckTasksWaitingTermination( void )
         pxTaskStatus->pxStackBase = pxTCB->pxStack;
         pxTaskStatus->xTaskNumber = pxTCB->uxTCBNumber;
 
+        #if ( ( portSTACK_GROWTH > 0 ) || ( configRECORD_STACK_HIGH_ADDRESS == 1 ) )
+            {
+                pxTaskStatus->usStackDepth = ( configSTACK_DEPTH_TYPE ) ( ( pxTCB->pxEndOfStack - pxTCB->pxStack ) + 1 );
+            }
+        #else
+            {
+                pxTaskStatus->usStackDepth = 0;
+            }
+        #endif
+
         #if ( configUSE_MUTEXES == 1 )
             {
                 pxTaskStatus->uxBasePriority = pxTCB->uxBasePriority;
@@ -3776,7 +3918,7 @@ static void prvCheckTasksWaitingTermination( void )
         }
         else
         {
-            pxTaskStatus->eCurrentState = eTaskGetState( pxTCB );
+            pxTaskStatus->eCurrentState = eTaskGetState( ( TaskHandle_t ) pxTCB );
         }
 
         /* Obtaining the stack space takes some time, so the xGetFreeStackSpace
@@ -3935,6 +4077,14 @@ static void prvCheckTasksWaitingTermination( void )
          * want to allocate and clean RAM statically. */
         portCLEAN_UP_TCB( pxTCB );
 
+        #if ( configUSE_RAM_ACCOUNTING == 1 )
+            {
+                vRamAccountRemove( pxTCB->uxTCBNumber, eRamTCB, sizeof( TCB_t ) );
+                vRamAccountRemove( pxTCB->uxTCBNumber, eRamStack, ( size_t ) ( ( pxTCB->pxEndOfStack - pxTCB->pxStack ) + 1 ) * sizeof( StackType_t ) );
+                vRamAccountTaskDeleted( pxTCB->uxTCBNumber );
+            }
+        #endif /* configUSE_RAM_ACCOUNTING */
+
         /* Free up the memory allocated by the scheduler for the task.  It is up
          * to the task to free any memory allocated at the application level.
          * See the third party link http://www.nadler.com/embedded/newlibAndFreeRTOS.html
@@ -5371,6 +5521,100 @@ static void prvAddCurrentTaskToDelayedList( TickType_t xTicksToWait,
     #endif /* INCLUDE_vTaskSuspend */
 }
 
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_TASK_BUDGETS == 1 )
+
+    static void prvChargeBudget( void )
+    {
+        const uint32_t ulNow = ( uint32_t ) portGET_RUN_TIME_COUNTER_VALUE();
+        TickType_t xElapsed;
+
+        if( pxCurrentTCB->ulBudgetUs != 0UL )
+        {
+            /* Deferrable server - the whole budget comes back at each period
+             * boundary, however much of it was used. */
+            xElapsed = xTickCount - pxCurrentTCB->xBudgetPeriodStart;
+
+            if( xElapsed >= pxCurrentTCB->xBudgetPeriod )
+            {
+                pxCurrentTCB->xBudgetPeriodStart += xElapsed - ( xElapsed % pxCurrentTCB->xBudgetPeriod );
+                pxCurrentTCB->ulBudgetUsedUs = 0UL;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            /* Unsigned subtraction copes with the counter wrapping. */
+            pxCurrentTCB->ulBudgetUsedUs += ulNow - ulBudgetSwitchedInTime;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        ulBudgetSwitchedInTime = ulNow;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvThrottleCurrentTask( const TickType_t xConstTickCount )
+    {
+        /* The period has not ended, or prvChargeBudget() would have started a
+         * new one, so the wait is at least one tick. */
+        const TickType_t xTicksToReplenish = ( pxCurrentTCB->xBudgetPeriodStart + pxCurrentTCB->xBudgetPeriod ) - xConstTickCount;
+
+        if( pxCurrentTCB->usBudgetOverruns < ( uint16_t ) 0xffffU )
+        {
+            pxCurrentTCB->usBudgetOverruns++;
+        }
+
+        vApplicationBudgetOverrunHook( ( TaskHandle_t ) pxCurrentTCB, pxCurrentTCB->pcTaskName );
+
+        prvAddCurrentTaskToDelayedList( xTicksToReplenish, pdFALSE );
+    }
+/*-----------------------------------------------------------*/
+
+    void vTaskSetBudget( TaskHandle_t xTask,
+                         uint32_t ulBudgetUs,
+                         TickType_t xPeriod )
+    {
+        TCB_t * pxTCB;
+
+        configASSERT( ( ulBudgetUs == 0UL ) || ( xPeriod > ( TickType_t ) 0U ) );
+
+        taskENTER_CRITICAL();
+        {
+            pxTCB = prvGetTCBFromHandle( xTask );
+
+            /* Throttling the idle task would leave nothing to run. */
+            configASSERT( ( TaskHandle_t ) pxTCB != xIdleTaskHandle );
+
+            pxTCB->ulBudgetUs = ulBudgetUs;
+            pxTCB->ulBudgetUsedUs = 0UL;
+            pxTCB->xBudgetPeriod = xPeriod;
+            pxTCB->xBudgetPeriodStart = xTickCount;
+        }
+        taskEXIT_CRITICAL();
+    }
+/*-----------------------------------------------------------*/
+
+    uint16_t usTaskGetBudgetOverruns( TaskHandle_t xTask )
+    {
+        uint16_t usReturn;
+
+        taskENTER_CRITICAL();
+        {
+            usReturn = prvGetTCBFromHandle( xTask )->usBudgetOverruns;
+        }
+        taskEXIT_CRITICAL();
+
+        return usReturn;
+    }
+
+#endif /* configUSE_TASK_BUDGETS */
+/*-----------------------------------------------------------*/
+
 /* Code below here allows additional code to be inserted into this source file,
  * especially where access to file scope functions and data is needed (for example
  * when performing module tests). */
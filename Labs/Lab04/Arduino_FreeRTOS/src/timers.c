@@ -37,6 +37,10 @@
 #include "queue.h"
 #include "timers.h"
 
+#if ( configUSE_RAM_ACCOUNTING == 1 )
+    #include "ram_account.h"
+#endif
+
 #if ( INCLUDE_xTimerPendFunctionCall == 1 ) && ( configUSE_TIMERS == 0 )
     #error configUSE_TIMERS must be set to 1 to make the xTimerPendFunctionCall() function available.
 #endif
@@ -80,6 +84,9 @@
             UBaseType_t uxTimerNumber;              /*<< An ID assigned by trace tools such as FreeRTOS+Trace */
         #endif
         uint8_t ucStatus;                           /*<< Holds bits to say if the timer was statically allocated or not, and if it is active or not. */
+        #if ( configUSE_RAM_ACCOUNTING == 1 )
+            UBaseType_t uxRamOwner;                 /*<< Number of the task that created the timer, see ram_account.h. */
+        #endif
     } Timer_t;
 
 /* The definition of messages that can be sent and received on the timer queue.
@@ -365,6 +372,13 @@
                 pxNewTimer->ucStatus |= tmrSTATUS_IS_AUTORELOAD;
             }
 
+            #if ( configUSE_RAM_ACCOUNTING == 1 )
+                {
+                    pxNewTimer->uxRamOwner = uxRamAccountOwner();
+                    vRamAccountAdd( pxNewTimer->uxRamOwner, eRamTimer, sizeof( Timer_t ) );
+                }
+            #endif /* configUSE_RAM_ACCOUNTING */
+
             traceTIMER_CREATE( pxNewTimer );
         }
     }
@@ -852,6 +866,12 @@
                         break;
 
                     case tmrCOMMAND_DELETE:
+                        #if ( configUSE_RAM_ACCOUNTING == 1 )
+                            {
+                                vRamAccountRemove( pxTimer->uxRamOwner, eRamTimer, sizeof( Timer_t ) );
+                            }
+                        #endif /* configUSE_RAM_ACCOUNTING */
+
                         #if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
                             {
                                 /* The timer has already been removed from the active list,
@@ -0,0 +1,223 @@
+/*
+ * This file is NOT part of the FreeRTOS distribution.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+/* Standard includes. */
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "Arduino_FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "topic_bus.h"
+
+/*-----------------------------------------------------------*/
+
+static void prvAddSubscriber( Topic_t * pxTopic,
+                              TopicSubscriber_t * pxSubscriber )
+{
+    pxSubscriber->xMessageSize = pxTopic->xMessageSize;
+    pxSubscriber->ucFresh = pdFALSE;
+    pxSubscriber->usDropped = 0U;
+
+    /* Publishers walk the list without a lock, so the new subscriber must be
+     * completely initialised before it becomes reachable from the head. */
+    taskENTER_CRITICAL();
+    {
+        pxSubscriber->pxNext = pxTopic->pxSubscribers;
+        pxTopic->pxSubscribers = pxSubscriber;
+    }
+    taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xTopicSubscribeQueue( Topic_t * pxTopic,
+                                 TopicSubscriber_t * pxSubscriber,
+                                 QueueHandle_t xQueue )
+{
+    configASSERT( pxTopic );
+    configASSERT( pxSubscriber );
+    configASSERT( xQueue );
+
+    if( uxQueueGetQueueItemSize( xQueue ) != pxTopic->xMessageSize )
+    {
+        return pdFAIL;
+    }
+
+    pxSubscriber->xQueue = xQueue;
+    pxSubscriber->pvSlot = NULL;
+    pxSubscriber->xTaskToNotify = NULL;
+    prvAddSubscriber( pxTopic, pxSubscriber );
+
+    return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xTopicSubscribeLatest( Topic_t * pxTopic,
+                                  TopicSubscriber_t * pxSubscriber,
+                                  void * pvSlot,
+                                  TaskHandle_t xTaskToNotify )
+{
+    configASSERT( pxTopic );
+    configASSERT( pxSubscriber );
+    configASSERT( pvSlot );
+
+    pxSubscriber->xQueue = NULL;
+    pxSubscriber->pvSlot = pvSlot;
+    pxSubscriber->xTaskToNotify = xTaskToNotify;
+    prvAddSubscriber( pxTopic, pxSubscriber );
+
+    return pdPASS;
+}
+/*-----------------------------------------------------------*/
+
+static void prvWriteSlot( TopicSubscriber_t * pxSubscriber,
+                          const void * pvMessage )
+{
+    /* The slot may be written from an interrupt, so the copy has to be
+     * atomic with respect to both the reader and other publishers. */
+    taskENTER_CRITICAL();
+    {
+        memcpy( pxSubscriber->pvSlot, pvMessage, pxSubscriber->xMessageSize );
+        pxSubscriber->ucFresh = pdTRUE;
+    }
+    taskEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxTopicPublish( Topic_t * pxTopic,
+                            const void * pvMessage )
+{
+    TopicSubscriber_t * pxSubscriber;
+    UBaseType_t uxDelivered = 0U;
+
+    configASSERT( pxTopic );
+    configASSERT( pvMessage );
+
+    /* Deliver to every subscriber before any of them gets to run, so a
+     * high priority subscriber can't preempt the fan-out half way through and
+     * the publisher pays for at most one context switch. */
+    vTaskSuspendAll();
+    {
+        taskENTER_CRITICAL();
+        {
+            pxTopic->usPublished++;
+        }
+        taskEXIT_CRITICAL();
+
+        for( pxSubscriber = pxTopic->pxSubscribers; pxSubscriber != NULL; pxSubscriber = pxSubscriber->pxNext )
+        {
+            if( pxSubscriber->xQueue != NULL )
+            {
+                if( xQueueSendToBack( pxSubscriber->xQueue, pvMessage, 0 ) == pdPASS )
+                {
+                    uxDelivered++;
+                }
+                else
+                {
+                    taskENTER_CRITICAL();
+                    {
+                        pxSubscriber->usDropped++;
+                    }
+                    taskEXIT_CRITICAL();
+                }
+            }
+            else
+            {
+                prvWriteSlot( pxSubscriber, pvMessage );
+
+                if( pxSubscriber->xTaskToNotify != NULL )
+                {
+                    ( void ) xTaskNotifyGive( pxSubscriber->xTaskToNotify );
+                }
+
+                uxDelivered++;
+            }
+        }
+    }
+    ( void ) xTaskResumeAll();
+
+    return uxDelivered;
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxTopicPublishFromISR( Topic_t * pxTopic,
+                                   const void * pvMessage,
+                                   BaseType_t * const pxHigherPriorityTaskWoken )
+{
+    TopicSubscriber_t * pxSubscriber;
+    UBaseType_t uxDelivered = 0U;
+
+    configASSERT( pxTopic );
+    configASSERT( pvMessage );
+
+    pxTopic->usPublished++;
+
+    for( pxSubscriber = pxTopic->pxSubscribers; pxSubscriber != NULL; pxSubscriber = pxSubscriber->pxNext )
+    {
+        if( pxSubscriber->xQueue != NULL )
+        {
+            if( xQueueSendToBackFromISR( pxSubscriber->xQueue, pvMessage, pxHigherPriorityTaskWoken ) == pdPASS )
+            {
+                uxDelivered++;
+            }
+            else
+            {
+                pxSubscriber->usDropped++;
+            }
+        }
+        else
+        {
+            memcpy( pxSubscriber->pvSlot, pvMessage, pxSubscriber->xMessageSize );
+            pxSubscriber->ucFresh = pdTRUE;
+
+            if( pxSubscriber->xTaskToNotify != NULL )
+            {
+                vTaskNotifyGiveFromISR( pxSubscriber->xTaskToNotify, pxHigherPriorityTaskWoken );
+            }
+
+            uxDelivered++;
+        }
+    }
+
+    return uxDelivered;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xTopicReadLatest( TopicSubscriber_t * pxSubscriber,
+                             void * pvBuffer )
+{
+    BaseType_t xFresh;
+
+    configASSERT( pxSubscriber );
+    configASSERT( pxSubscriber->pvSlot );
+
+    taskENTER_CRITICAL();
+    {
+        memcpy( pvBuffer, pxSubscriber->pvSlot, pxSubscriber->xMessageSize );
+        xFresh = ( BaseType_t ) pxSubscriber->ucFresh;
+        pxSubscriber->ucFresh = pdFALSE;
+    }
+    taskEXIT_CRITICAL();
+
+    return xFresh;
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,178 @@
+/*
+ * This file is NOT part of the FreeRTOS distribution.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+/*
+ * A topic bus lets one publisher fan a message out to any number of
+ * subscribers without knowing who they are.  Topics and subscribers are
+ * declared statically, so the bus itself never allocates.
+ *
+ * Each subscriber picks how it wants to receive messages:
+ *
+ *   + Queue subscribers get every message, copied into a bounded FreeRTOS
+ *     queue the subscriber owns.  A full queue never blocks the publisher -
+ *     the message is dropped for that subscriber and counted in usDropped.
+ *
+ *   + Latest-value subscribers get a single slot that is overwritten by each
+ *     publish, plus an optional task notification.  This suits state such as
+ *     a joystick position, where only the newest value matters.
+ *
+ * Messages larger than a pointer should be published on a reference topic
+ * (topicDEFINE_REF), which fans out the pointer rather than the data.  The
+ * publisher must keep the referenced data valid until every subscriber is
+ * done with it.
+ *
+ * Subscribers may be added at any time, but can not be removed.
+ */
+
+#ifndef TOPIC_BUS_H
+#define TOPIC_BUS_H
+
+#ifndef INC_ARDUINO_FREERTOS_H
+    #error "include Arduino_FreeRTOS.h must appear in source files before include topic_bus.h"
+#endif
+
+#include "queue.h"
+
+/* *INDENT-OFF* */
+#if defined( __cplusplus )
+    extern "C" {
+#endif
+/* *INDENT-ON* */
+
+/**
+ * A subscription to a topic.  Declare one per consumer with static storage
+ * duration and hand it to xTopicSubscribeQueue() or xTopicSubscribeLatest().
+ * The members are private to topic_bus.c.
+ */
+typedef struct TopicSubscriber
+{
+    struct TopicSubscriber * pxNext; /*< Next subscriber of the same topic. */
+    QueueHandle_t xQueue;            /*< Queue to copy into, or NULL for a latest-value slot. */
+    void * pvSlot;                   /*< Latest-value storage, xMessageSize bytes. */
+    size_t xMessageSize;             /*< Copied from the topic on subscribe. */
+    TaskHandle_t xTaskToNotify;      /*< Task notified when the slot is written, may be NULL. */
+    volatile uint8_t ucFresh;        /*< pdTRUE if the slot holds a value not yet read. */
+    uint16_t usDropped;              /*< Messages lost because the queue was full. */
+} TopicSubscriber_t;
+
+/**
+ * A topic.  Declare with topicDEFINE() or topicDEFINE_REF().
+ */
+typedef struct Topic
+{
+    const char * pcName;                 /*< Text name, only used for debugging. */
+    size_t xMessageSize;                 /*< Size of one message in bytes. */
+    TopicSubscriber_t * pxSubscribers;   /*< Singly linked list of subscribers. */
+    uint16_t usPublished;                /*< Number of messages published. */
+} Topic_t;
+
+/**
+ * Define a topic that copies messages of the given type to each subscriber.
+ *
+ * Example usage:
+ * <pre>
+ * typedef struct { int x; int y; } Position_t;
+ * topicDEFINE( xPositionTopic, Position_t );
+ * </pre>
+ */
+#define topicDEFINE( xName, xType )    Topic_t xName = { #xName, sizeof( xType ), NULL, 0U }
+
+/**
+ * Define a topic whose messages are pointers to data that is shared, not
+ * copied, by every subscriber.  Publish with the address of the pointer.
+ */
+#define topicDEFINE_REF( xName )       Topic_t xName = { #xName, sizeof( void * ), NULL, 0U }
+
+/**
+ * Subscribe to a topic through a queue.  xQueue must have been created with
+ * an item size equal to the topic's message size.  Every subsequent publish is
+ * copied into the queue, so the subscriber just blocks in xQueueReceive().
+ *
+ * @param pxTopic The topic to subscribe to.
+ * @param pxSubscriber Subscriber storage, must outlive the topic.
+ * @param xQueue The queue to deliver messages to.
+ *
+ * @return pdPASS, or pdFAIL if the queue item size does not match.
+ */
+BaseType_t xTopicSubscribeQueue( Topic_t * pxTopic,
+                                 TopicSubscriber_t * pxSubscriber,
+                                 QueueHandle_t xQueue ) PRIVILEGED_FUNCTION;
+
+/**
+ * Subscribe to a topic through a latest-value slot.  Each publish overwrites
+ * pvSlot and, if xTaskToNotify is not NULL, gives that task a notification so
+ * it can wait in ulTaskNotifyTake() instead of polling.
+ *
+ * @param pxTopic The topic to subscribe to.
+ * @param pxSubscriber Subscriber storage, must outlive the topic.
+ * @param pvSlot Storage for one message, must outlive the topic.
+ * @param xTaskToNotify Task to notify on each publish, or NULL.
+ *
+ * @return pdPASS.
+ */
+BaseType_t xTopicSubscribeLatest( Topic_t * pxTopic,
+                                  TopicSubscriber_t * pxSubscriber,
+                                  void * pvSlot,
+                                  TaskHandle_t xTaskToNotify ) PRIVILEGED_FUNCTION;
+
+/**
+ * Publish a message to every subscriber of a topic.  Never blocks.
+ *
+ * @param pxTopic The topic to publish on.
+ * @param pvMessage Pointer to the message, xMessageSize bytes are copied.  For
+ * a reference topic this is the address of the pointer being shared.
+ *
+ * @return The number of subscribers the message was delivered to.
+ */
+UBaseType_t uxTopicPublish( Topic_t * pxTopic,
+                            const void * pvMessage ) PRIVILEGED_FUNCTION;
+
+/**
+ * A version of uxTopicPublish() that can be called from an interrupt service
+ * routine.
+ *
+ * @param pxHigherPriorityTaskWoken Set to pdTRUE if delivering the message
+ * unblocked a task with a priority higher than the interrupted task.
+ */
+UBaseType_t uxTopicPublishFromISR( Topic_t * pxTopic,
+                                   const void * pvMessage,
+                                   BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/**
+ * Read the latest value from a latest-value subscription.
+ *
+ * @param pxSubscriber The subscription to read.
+ * @param pvBuffer Buffer of the topic's message size to copy into.
+ *
+ * @return pdTRUE if the value was published since the last read, pdFALSE if
+ * it was already read (the buffer is still filled with the latest value).
+ */
+BaseType_t xTopicReadLatest( TopicSubscriber_t * pxSubscriber,
+                             void * pvBuffer ) PRIVILEGED_FUNCTION;
+
+/* *INDENT-OFF* */
+#if defined( __cplusplus )
+    }
+#endif
+/* *INDENT-ON* */
+
+#endif /* TOPIC_BUS_H */
@@ -37,6 +37,10 @@
 #include "task.h"
 #include "timers.h"
 
+#if ( configUSE_IDLE_POWER == 1 )
+    #include "idle_power.h"
+#endif
+
 extern void setup(void);
 extern void loop(void);
 
@@ -67,6 +71,8 @@ void initVariant(void)
  *
  * NOTE: vApplicationIdleHook() MUST NOT, UNDER ANY CIRCUMSTANCES, CALL A FUNCTION THAT MIGHT BLOCK.
  *
+ * With configUSE_IDLE_POWER the CPU then sleeps until the next interrupt, see idle_power.h.
+ *
  */
 void vApplicationIdleHook( void ) __attribute__((weak));
 
@@ -74,6 +80,10 @@ void vApplicationIdleHook( void )
 {
     loop();                     // the normal Arduino loop() function is run here.
     if (serialEventRun) serialEventRun();
+
+#if ( configUSE_IDLE_POWER == 1 )
+    vIdlePowerEnter();          // sleep until something needs doing.
+#endif
 }
 
 #else
@@ -187,6 +197,21 @@ void vApplicationStackOverflowHook( TaskHandle_t xTask __attribute__((unused)),
 #endif /* configCHECK_FOR_STACK_OVERFLOW >= 1 */
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_TASK_BUDGETS == 1 )
+
+void vApplicationBudgetOverrunHook( TaskHandle_t xTask,
+                                    char * pcTaskName ) __attribute__((weak));
+
+void vApplicationBudgetOverrunHook( TaskHandle_t xTask __attribute__((unused)),
+                                    char * pcTaskName __attribute__((unused)) )
+{
+    // Called from the tick interrupt. The overrun is already counted against the task,
+    // so by default there is nothing more to do. Read it with usTaskGetBudgetOverruns().
+}
+
+#endif /* configUSE_TASK_BUDGETS == 1 */
+/*-----------------------------------------------------------*/
+
 #if ( configSUPPORT_STATIC_ALLOCATION >= 1 )
 
 void vApplicationGetIdleTaskMemory( StaticTask_t ** ppxIdleTaskTCBBuffer,
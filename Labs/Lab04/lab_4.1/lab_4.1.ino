@@ -4,12 +4,25 @@
 #include <Arduino_FreeRTOS.h>
 #include <queue.h>
 #include <task.h>
+#include <buffer_pool.h>
+#include <stack_monitor.h>
+#include <Melody.h>
 #include <arduinoFFT.h>
 
+// sample frames are handed between tasks by reference, so the pool
+// storage is the only copy of the samples
+bufferpoolDEFINE(framePool, NSAMPLES, NFRAMES);
+
 QueueHandle_t task34Queue;
 QueueHandle_t task4TimeQueue;
 TaskHandle_t task3Handle;
 
+// filled in by the stack report Task3 prints once the FFTs are done
+StackUsage_t stackUsage[stackmonitorMAX_TASKS];
+
+// where TaskTheme is in the theme, kept off its small stack
+melody_seq theme;
+
 
 // the setup function runs once when you press reset or power the board
 void setup() {
@@ -63,49 +76,63 @@ void TaskBlink(void *pvParameters)  // This is a task.
 
 void TaskTheme(void * pvParameters) {
   speakerSetup();
-  // Play the theme NPLAY times
-  for (int i = 0; i < NPLAY; i++) {
-    for (int j = 0; j < NMELODY; j++) {
-      setOC4AFreq(melody[j]);
-      vTaskDelay(pdMS_TO_TICKS(PLAY_DURATION)); // wait for play duration ms
-    }
-    setOC4AFreq(0);
-
-    // add fencepost to waiting
-    if (i != 2) vTaskDelay(pdMS_TO_TICKS(1500));
+  // Play the theme NPLAY times, with a pause in between
+  melody_init(&theme, melody, NMELODY, PLAY_DURATION);
+  melody_set_repeat(&theme, NPLAY, PAUSE_DURATION);
+  for (int freq = melody_step(&theme); freq != MELODY_END; freq = melody_step(&theme)) {
+    setOC4ANote(melody_index(&theme));
+    vTaskDelay(pdMS_TO_TICKS(melody_held(&theme))); // wait for the note or pause to end
   }
+  setOC4AFreq(0);
+
   // delete the task
   vTaskDelete(NULL);
 }
 
 void Task34Starter() {
-  char arr[NSAMPLES];
-  // generate an array of 512 random 16-bit longs
+  int8_t * frame = (int8_t *) pvBufferPoolAlloc(&framePool);
+  // generate a frame of 512 random 8-bit samples
   for (int i = 0; i < NSAMPLES; i++) {
-    arr[i] = random(-100, 100);
+    frame[i] = random(-100, 100);
   }
 
   // intialize the queues which tasks 3 and 4 will use to communicate
-  // FreeRTOS max queue size is only 128 bytes, so we have to split up our queue to send
-  // queues of larger sizes (this does assume that we'll send more than 2 values)
-  task34Queue = xQueueCreate(1, (unsigned int)sizeof(double *));
+  // FreeRTOS max queue size is only 128 bytes, so the frame is passed
+  // by reference through the buffer pool instead of being copied
+  task34Queue = xQueueCreate(1, (unsigned int) sizeof(int8_t *));
   task4TimeQueue = xQueueCreate(1, (unsigned int) sizeof(long));
 
-  xTaskCreate(Task3, "Task3", 128, &arr, 1, &task3Handle);
+  // Task3 takes over the reference we got from the allocation
+  xTaskCreate(Task3, "Task3", 128, frame, 1, &task3Handle);
 
   xTaskCreate(Task4, "Task4", 4269, &task3Handle, 0, NULL);
 }
 
 void Task3(void * pvParameters) {
   long total_time;
-  double * arr = ((double **) pvParameters)[0];
+  BufferPoolStats_t stats;
+  int8_t * frame = (int8_t *) pvParameters;
 
-  xQueueSendToBack(task34Queue, arr, 0);
+  // Task4 gets its own reference, so ours can be dropped straight away
+  xBufferSendToQueue(task34Queue, frame, portMAX_DELAY);
+  vBufferRelease(frame);
   xQueueReceive(task4TimeQueue, &total_time, portMAX_DELAY);
 
   Serial.print("Average FFT Time: ");
   Serial.println((double) total_time / 5.0);
 
+  // once every consumer is done nothing should still be in use
+  vBufferPoolGetStats(&framePool, &stats);
+  Serial.print("Frames in use: ");
+  Serial.print(stats.uxInUse);
+  Serial.print(", high water: ");
+  Serial.print(stats.uxHighWater);
+  Serial.print(" of ");
+  Serial.println(stats.uxBlockCount);
+
+  // Task4 is still waiting to be deleted, so its FFT stack shows up too
+  printStackReport();
+
   vTaskDelete(NULL);
 }
 
@@ -115,12 +142,12 @@ void Task4(void * pvParameters) {
   double vImag[NSAMPLES];
   arduinoFFT FFT = arduinoFFT();
 
-  double * arr;
+  int8_t * frame;
   unsigned long time = millis();
-  xQueueReceive(task34Queue, &arr, portMAX_DELAY);
+  xQueueReceive(task34Queue, &frame, portMAX_DELAY);
   for (int i = 0; i < 5; i++) {
     for (int j = 0; j < NSAMPLES; j++) {
-      vReal[j] = arr[j];
+      vReal[j] = frame[j];
       vImag[j] = 0.0; // reset the imaginary part
     }
 
@@ -128,11 +155,28 @@ void Task4(void * pvParameters) {
     FFT.Compute(vReal, vImag, NSAMPLES, FFT_FORWARD);
   }
   time = millis() - time;
+  vBufferRelease(frame);
   xQueueSendToBack(task4TimeQueue, &time, 0);
 
   vTaskDelete(NULL);
 }
 
+// print how deep every task's stack has been and the depth it needs,
+// so the guessed sizes in xTaskCreate() can be trimmed
+void printStackReport() {
+  UBaseType_t n = uxStackMonitorSample(stackUsage, stackmonitorMAX_TASKS);
+  Serial.println("task\tdepth\tfree\trecommended");
+  for (UBaseType_t i = 0; i < n; i++) {
+    Serial.print(stackUsage[i].pcTaskName);
+    Serial.print('\t');
+    Serial.print(stackUsage[i].usStackDepth);
+    Serial.print('\t');
+    Serial.print(stackUsage[i].usHighWaterMark);
+    Serial.print('\t');
+    Serial.println(stackUsage[i].usRecommended);
+  }
+}
+
 void ledSetup() {
   LED_DDR |= LED_BIT;
   LED_PORT |= LED_BIT;
@@ -157,8 +201,9 @@ void speakerSetup() {
   //
   //  f_out = f_i/o / 2 * N * (PRESCALER + 1)
   //
-  // because f_i/o = 16Mhz, we'll just set N = 1
-  TIMER_REG_B |= (0 << CS42) | (0 << CS41) | (1 << CS40);
+  // N is the smallest prescaler the lowest note of the
+  // melody fits, which the tone table picks when compiling
+  TIMER_REG_B |= melody_tones::cs;
   PRESCALER = 0;
   TIMER_COUNTER = 0;
 
@@ -172,4 +217,11 @@ void speakerSetup() {
 void setOC4AFreq(uint32_t freq) {
   PRESCALER = freq == 0 ? 0 : 16000000 / (2 * freq);
   TIMER_COUNTER = 0;
-}
\ No newline at end of file
+}
+
+// sets the OCR4A to play a note of the melody, from the
+// table worked out when compiling, with no division
+void setOC4ANote(int note) {
+  PRESCALER = melody_tones::top(note);
+  TIMER_COUNTER = 0;
+}
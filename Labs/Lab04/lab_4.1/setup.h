@@ -7,6 +7,8 @@
  * - Joey Pirich
  */
 
+#include <ToneTable.h>
+
 // Define notes for the melody
 #define NOTE_C  262
 #define NOTE_CS 277
@@ -24,7 +26,7 @@
 
 // Define the number of notes in the melody and the melody itself
 #define NMELODY 72
-int melody[] = {
+constexpr int melody[] = {
   NOTE_E, NOTE_E, 0, NOTE_E, 0, NOTE_C, NOTE_E, 0,
   NOTE_G, 0, 0,  0, NOTE_G, 0, 0, 0,
   NOTE_C5, 0, 0, NOTE_G, 0, 0, NOTE_E, 0,
@@ -36,6 +38,9 @@ int melody[] = {
   NOTE_E, 0, NOTE_C, NOTE_D, NOTE_B, 0, 0, NOTE_C5
 };
 
+// The OCR4A value of each note of the melody, worked out when compiling
+typedef tone_table<melody, NMELODY> melody_tones;
+
 #define TIMER_REG_A TCCR4A
 #define TIMER_REG_B TCCR4B
 #define TIMER_MASK TIMSK4
@@ -47,16 +52,19 @@ int melody[] = {
 #define SPEAKER_DDR DDRH
 #define SPEAKER_PORT PORTH
 #define NSAMPLES 512
+#define NFRAMES 1
 
 #define PLAY_DURATION 200
+#define PAUSE_DURATION 1500
 #define NPLAY 3
 
 // define two tasks for Blink & AnalogRead
 void TaskBlink(void * pvParameters);
 void TaskTheme(void * pvParameters);
-void Task34Starter(void * pvParameters);
+void Task34Starter();
 void Task3(void * pvParameters);
 void Task4(void * pvParameters);
+void printStackReport();
 
 
 void ledSetup();
@@ -64,3 +72,4 @@ void ledSetup();
 void speakerSetup();
 
 void setOC4AFreq(uint32_t freq);
+void setOC4ANote(int note);
@@ -0,0 +1,180 @@
+/**
+ * @file FrameIdle.cpp
+ * @brief Idle time records for the Lab 3 schedulers
+ * @authors
+ *  - Mason Wheeler
+ *  - Joey Pirich
+ */
+
+#include "FrameIdle.h"
+
+/// Frames recorded since the last report
+static unsigned long frames;
+/// Timer3 counts spent idle since the last report
+static unsigned long idleCounts;
+/// Fewest Timer3 counts left idle in one frame since the last report
+static unsigned int idleMin = 0xFFFF;
+
+/// Frames counted by frame_tick()
+static volatile unsigned long frameCount;
+/// Frames that ended since the last frame_take()
+static volatile uint8_t framesEnded;
+/// Frames that ended since the last task report
+static volatile unsigned long taskFrames;
+/// Frames that ended with the flag still set, since the last task report
+static volatile unsigned int overruns;
+
+/// Id of the task being timed, or FRAME_MAX_TASKS for none
+static volatile uint8_t runningTask = FRAME_MAX_TASKS;
+/// frame_clock() when the running task started
+static unsigned long taskStart;
+/// Timer3 counts the running task spent in frame_idle_wait()
+static unsigned long taskIdle;
+
+/**
+ * @brief Times of one task since the last report
+ *
+ */
+typedef struct {
+  /// Number of runs
+  unsigned int runs;
+  /// Longest run in Timer3 counts
+  unsigned long longest;
+  /// Number of overruns the task was running for
+  unsigned int overruns;
+} task_times;
+
+static task_times taskTimes[FRAME_MAX_TASKS];
+
+unsigned int frame_idle_left() {
+  unsigned int count;
+
+  // TCNT3 is read through a shared high byte register, keep the interrupts out of it
+  uint8_t sreg = SREG;
+  cli();
+  count = TCNT3;
+  SREG = sreg;
+
+  return count < OCR3A ? OCR3A - count : 0;
+}
+
+void frame_idle_record(unsigned int left) {
+  taskIdle += left;
+  frames++;
+  idleCounts += left;
+  if (left < idleMin) idleMin = left;
+}
+
+unsigned long frame_idle_frames() {
+  return frames;
+}
+
+void frame_idle_report(Print & out) {
+  unsigned long frameCounts = (unsigned long) OCR3A + 1;
+
+  if (frames == 0) return;
+
+  out.print(F("idle avg "));
+  out.print(idleCounts / frames * 100 / frameCounts);
+  out.print(F("% min "));
+  out.print((unsigned long) idleMin * 100 / frameCounts);
+  out.print(F("% of "));
+  out.print(frames);
+  out.println(F(" frames"));
+
+  frames = 0;
+  idleCounts = 0;
+  idleMin = 0xFFFF;
+}
+
+void frame_tick(bool overrun) {
+  frameCount++;
+  taskFrames++;
+  if (framesEnded < 0xFF) framesEnded++;
+
+  if (overrun) {
+    overruns++;
+    if (runningTask < FRAME_MAX_TASKS) taskTimes[runningTask].overruns++;
+  }
+}
+
+unsigned long frame_clock() {
+  unsigned long count;
+  unsigned int counter;
+
+  uint8_t sreg = SREG;
+  cli();
+  count = frameCount;
+  counter = TCNT3;
+  // the counter started the next frame, but the interrupt has not counted it yet
+  if ((TIFR3 & _BV(OCF3A)) && counter < OCR3A / 2) count++;
+  SREG = sreg;
+
+  return count * ((unsigned long) OCR3A + 1) + counter;
+}
+
+uint8_t frame_take_ended() {
+  uint8_t ended = framesEnded;
+  framesEnded = 0;
+  return ended;
+}
+
+void frame_task_begin(uint8_t task) {
+  taskIdle = 0;
+  taskStart = frame_clock();
+  runningTask = task;
+}
+
+void frame_task_end(uint8_t task) {
+  unsigned long ran = frame_clock() - taskStart - taskIdle;
+
+  runningTask = FRAME_MAX_TASKS;
+  if (task >= FRAME_MAX_TASKS) return;
+
+  taskTimes[task].runs++;
+  if (ran > taskTimes[task].longest) taskTimes[task].longest = ran;
+}
+
+unsigned long frame_task_frames() {
+  uint8_t sreg = SREG;
+  cli();
+  unsigned long frames = taskFrames;
+  SREG = sreg;
+
+  return frames;
+}
+
+void frame_task_report(Print & out) {
+  unsigned int taskOverruns[FRAME_MAX_TASKS];
+
+  uint8_t sreg = SREG;
+  cli();
+  unsigned long frames = taskFrames;
+  unsigned int overrun = overruns;
+  taskFrames = 0;
+  overruns = 0;
+  for (uint8_t i = 0; i < FRAME_MAX_TASKS; i++) {
+    // overruns are counted by the interrupt, take them with the frames
+    taskOverruns[i] = taskTimes[i].overruns;
+    taskTimes[i].overruns = 0;
+  }
+  SREG = sreg;
+
+  out.print(F("frames "));
+  out.print(frames);
+  out.print(F(" ovr "));
+  out.print(overrun);
+  out.print(F(" |"));
+  for (uint8_t i = 0; i < FRAME_MAX_TASKS; i++) {
+    if (taskTimes[i].runs == 0) continue;
+    out.print(' ');
+    out.print(i);
+    out.print(':');
+    out.print(taskTimes[i].longest / (F_CPU / 1000000UL));
+    out.print('/');
+    out.print(taskOverruns[i]);
+    taskTimes[i].runs = 0;
+    taskTimes[i].longest = 0;
+  }
+  out.println();
+}
@@ -0,0 +1,173 @@
+/**
+ * @file FrameIdle.h
+ * @brief Idle sleep until the next Timer3 frame for the Lab 3 schedulers
+ * @authors
+ *  - Mason Wheeler
+ *  - Joey Pirich
+ *
+ * The Lab 3 schedulers run in frames of Timer3 in CTC mode: the compare A interrupt sets a
+ * flag every OCR3A + 1 counts, and schedule_sync() waits for it. frame_idle_wait() does that
+ * waiting in idle sleep rather than a busy loop. Timer3 and the other peripherals keep
+ * running in idle sleep, and any interrupt wakes the CPU, so it goes back to sleep until the
+ * flag is set.
+ *
+ * Each wait also records how many Timer3 counts were left in the frame when the scheduler
+ * ran out of work. The average says how busy a demo is, and the smallest says how close its
+ * worst frame came to running over. frame_idle_report() prints both.
+ *
+ * A frame runs over when a task is still running as the next one ends. Then the interrupt
+ * finds the flag still set from the frame before, and one tick would be lost. When the
+ * interrupt calls frame_tick(), the library counts every frame that ends, so schedule_sync()
+ * can pass on all of them with frame_take(). It also blames each overrun on the task that was
+ * running. frame_task_begin() and frame_task_end() around each task time it on the Timer3
+ * counter, and frame_task_report() prints the times and the blame.
+ */
+#ifndef FRAME_IDLE_H
+#define FRAME_IDLE_H
+
+#include <Arduino.h>
+#include <avr/sleep.h>
+
+/// Number of task ids frame_task_begin() keeps times for, ids 0 to FRAME_MAX_TASKS - 1
+#define FRAME_MAX_TASKS 10
+
+/**
+ * @brief Returns how many Timer3 counts are left in the current frame
+ *
+ * @return OCR3A minus TCNT3
+ */
+unsigned int frame_idle_left();
+
+/**
+ * @brief Records the idle time of one frame, for frame_idle_wait()
+ *
+ * @param left The Timer3 counts that were left in the frame when the wait started
+ */
+void frame_idle_record(unsigned int left);
+
+/**
+ * @brief Sleeps until the Timer3 interrupt sets the frame flag, and records the idle time
+ *
+ * Returns at once, recording no idle time, if the flag is already set.
+ *
+ * @param flag The flag the Timer3 compare A interrupt sets
+ * @param pending The value of the flag until the interrupt sets it
+ */
+template <typename FLAG_T, typename VALUE_T>
+void frame_idle_wait(volatile FLAG_T & flag, VALUE_T pending) {
+  unsigned int left = frame_idle_left();
+
+  // check the flag with interrupts off, so the interrupt can not slip in before the sleep
+  cli();
+  if (flag != pending) left = 0;
+  set_sleep_mode(SLEEP_MODE_IDLE);
+  while (flag == pending) {
+    // sei() holds interrupts off for one more instruction, so sleep_cpu() always runs first
+    sleep_enable();
+    sei();
+    sleep_cpu();
+    sleep_disable();
+    cli();
+  }
+  sei();
+
+  frame_idle_record(left);
+}
+
+/**
+ * @brief Returns how many frames were recorded since the last report
+ *
+ * @return The number of frames
+ */
+unsigned long frame_idle_frames();
+
+/**
+ * @brief Prints the average and smallest idle share of the frames since the last report
+ *
+ * Prints a line like "idle avg 87% min 61% of 2500 frames" and starts counting again.
+ * Report at least every 130000 frames so the sum of idle counts does not overflow.
+ *
+ * @param out Where to print, for example Serial
+ */
+void frame_idle_report(Print & out);
+
+/**
+ * @brief Counts the end of a frame, called from the Timer3 compare A interrupt
+ *
+ * @param overrun Whether the frame flag was still set from the frame before
+ */
+void frame_tick(bool overrun);
+
+/**
+ * @brief Returns the time on the Timer3 counter
+ *
+ * @return Timer3 counts since the first frame, wrapping every 2^32 counts
+ */
+unsigned long frame_clock();
+
+/**
+ * @brief Takes the frames that ended since the last call, for frame_take()
+ *
+ * Must be called with interrupts off.
+ *
+ * @return The number of frames
+ */
+uint8_t frame_take_ended();
+
+/**
+ * @brief Takes the frames that ended since the last call and clears the frame flag
+ *
+ * Call after frame_idle_wait(). Returns 1 when schedule_sync() kept up, and more after a
+ * task ran over, so the ticks the flag could not hold are not lost.
+ *
+ * @param flag The flag the Timer3 compare A interrupt sets
+ * @param pending The value of the flag until the interrupt sets it
+ * @return The number of frames that ended
+ */
+template <typename FLAG_T, typename VALUE_T>
+uint8_t frame_take(volatile FLAG_T & flag, VALUE_T pending) {
+  // clear the flag together with the count, so a frame can not end in between
+  cli();
+  uint8_t frames = frame_take_ended();
+  flag = pending;
+  sei();
+
+  return frames;
+}
+
+/**
+ * @brief Starts timing a task
+ *
+ * @param task The id of the task about to run
+ */
+void frame_task_begin(uint8_t task);
+
+/**
+ * @brief Stops timing a task and records how long it ran
+ *
+ * Time spent in frame_idle_wait() while the task ran is not counted.
+ *
+ * @param task The id of the task that just ran
+ */
+void frame_task_end(uint8_t task);
+
+/**
+ * @brief Returns how many frames ended since the last task report
+ *
+ * @return The number of frames
+ */
+unsigned long frame_task_frames();
+
+/**
+ * @brief Prints the overruns and task times since the last report
+ *
+ * Prints one line like "frames 2500 ovr 2 | 0:40/0 1:3120/2 8:30/0". After the number of
+ * frames and of overruns, each task that ran has its id, its longest run in microseconds,
+ * and how many overruns it was running for. Then it starts counting again. Times assume
+ * Timer3 runs at the CPU clock, with no prescaler.
+ *
+ * @param out Where to print, for example Serial
+ */
+void frame_task_report(Print & out);
+
+#endif
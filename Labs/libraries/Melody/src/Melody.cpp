@@ -0,0 +1,95 @@
+/**
+ * @file Melody.cpp
+ * @brief Cursor handling for the melody sequencer
+ * @authors
+ *  - Mason Wheeler
+ *  - Joey Pirich
+ */
+
+#include <stddef.h>
+
+#include "Melody.h"
+
+void melody_init(melody_seq * seq, const int * freqs, unsigned int length, unsigned int duration) {
+  seq->freqs = freqs;
+  seq->durations = NULL;
+  seq->length = length;
+  seq->duration = duration;
+  seq->gap = 0;
+  seq->pause = 0;
+  seq->repeats = 1;
+  melody_start(seq, 0);
+}
+
+void melody_set_durations(melody_seq * seq, const unsigned int * durations) {
+  seq->durations = durations;
+}
+
+void melody_set_gap(melody_seq * seq, unsigned int gap) {
+  seq->gap = gap;
+}
+
+void melody_set_repeat(melody_seq * seq, uint8_t repeats, unsigned int pause) {
+  seq->repeats = repeats;
+  seq->pause = pause;
+}
+
+void melody_start(melody_seq * seq, unsigned long now) {
+  seq->note = 0;
+  seq->played = 0;
+  seq->resting = 0;
+  seq->index = -1;
+  seq->held = 0;
+  seq->next = now;
+}
+
+/**
+ * @brief Returns an event and moves the time of the next step on by its length
+ *
+ * @param seq The melody
+ * @param freq The frequency of the event
+ * @param ms How long the event lasts
+ * @return freq
+ */
+static int melody_hold(melody_seq * seq, int freq, unsigned int ms) {
+  seq->held = ms;
+  seq->next += ms;
+  return freq;
+}
+
+int melody_step(melody_seq * seq) {
+  seq->index = -1;
+  if (seq->length == 0) return MELODY_END;
+
+  // be quiet for the gap after the note that just played
+  if (seq->resting) {
+    seq->resting = 0;
+    return melody_hold(seq, 0, seq->gap);
+  }
+
+  // the end of a play through, stop or pause before the next
+  if (seq->note == seq->length) {
+    if (seq->repeats != 0 && seq->played + 1 >= seq->repeats) return MELODY_END;
+
+    seq->played++;
+    seq->note = 0;
+    if (seq->pause != 0) return melody_hold(seq, 0, seq->pause);
+  }
+
+  unsigned int note = seq->note++;
+  seq->index = (int) note;
+  seq->resting = seq->gap != 0;
+  return melody_hold(seq, seq->freqs[note], seq->durations != NULL ? seq->durations[note] : seq->duration);
+}
+
+int melody_index(const melody_seq * seq) {
+  return seq->index;
+}
+
+unsigned int melody_held(const melody_seq * seq) {
+  return seq->held;
+}
+
+unsigned long melody_next(const melody_seq * seq) {
+  return seq->next;
+}
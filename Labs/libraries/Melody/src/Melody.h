@@ -0,0 +1,137 @@
+/**
+ * @file Melody.h
+ * @brief Note by note melody sequencer for the lab sketches
+ * @authors
+ *  - Mason Wheeler
+ *  - Joey Pirich
+ *
+ * A melody is an array of frequencies in Hz, with 0 for a rest. Each note lasts the same
+ * time unless melody_set_durations() gives every note its own, can be followed by a silent
+ * gap, and the whole melody can be played a number of times with a pause in between.
+ *
+ * The sequencer does not keep time itself. The sketch calls melody_step() when the last
+ * event is over, sets the speaker to the frequency it returns, and waits: either
+ * melody_held() milliseconds, or until melody_next() on the clock it passed to
+ * melody_start(), which keeps a late step from pushing the rest of the melody back. Each
+ * step moves a cursor on by one, so it takes the same time wherever it is in the melody.
+ */
+#ifndef MELODY_H
+#define MELODY_H
+
+#include <stdint.h>
+
+/// Returned by melody_step() when the last repeat has been played
+#define MELODY_END (-1)
+
+/**
+ * @brief A melody and how far it has been played
+ *
+ */
+typedef struct {
+  /// Frequency of each note in Hz, 0 for a rest
+  const int * freqs;
+  /// Duration of each note in milliseconds, or NULL for all the same
+  const unsigned int * durations;
+  /// Number of notes
+  unsigned int length;
+  /// Duration of every note in milliseconds when there is no durations array
+  unsigned int duration;
+  /// Milliseconds of silence after each note
+  unsigned int gap;
+  /// Milliseconds of silence between repeats
+  unsigned int pause;
+  /// Number of times to play the melody, 0 for forever
+  uint8_t repeats;
+
+  /// Index of the next note to play
+  unsigned int note;
+  /// Number of times the melody has been played through
+  uint8_t played;
+  /// Whether the gap after the last note is still to come
+  uint8_t resting;
+  /// Index of the note melody_step() last returned, or -1 for a gap, a pause or the end
+  int index;
+  /// Milliseconds the event melody_step() last returned lasts
+  unsigned int held;
+  /// Clock time at which the event after it is due
+  unsigned long next;
+} melody_seq;
+
+/**
+ * @brief Sets up a melody that plays once, every note for the same time
+ *
+ * @param seq The melody to set up
+ * @param freqs Frequency of each note in Hz, 0 for a rest
+ * @param length The number of notes
+ * @param duration Milliseconds each note lasts
+ */
+void melody_init(melody_seq * seq, const int * freqs, unsigned int length, unsigned int duration);
+
+/**
+ * @brief Gives every note a duration of its own
+ *
+ * @param seq The melody
+ * @param durations Milliseconds each note lasts, length entries, or NULL for the same duration
+ */
+void melody_set_durations(melody_seq * seq, const unsigned int * durations);
+
+/**
+ * @brief Adds a silent gap after every note
+ *
+ * @param seq The melody
+ * @param gap Milliseconds of silence after each note
+ */
+void melody_set_gap(melody_seq * seq, unsigned int gap);
+
+/**
+ * @brief Sets how many times the melody is played
+ *
+ * @param seq The melody
+ * @param repeats Number of times to play it, 0 for forever
+ * @param pause Milliseconds of silence between two plays
+ */
+void melody_set_repeat(melody_seq * seq, uint8_t repeats, unsigned int pause);
+
+/**
+ * @brief Rewinds the melody to its first note
+ *
+ * @param seq The melody
+ * @param now The time on the sketch's clock, in milliseconds, that the first note is due
+ */
+void melody_start(melody_seq * seq, unsigned long now);
+
+/**
+ * @brief Moves on to the next note, gap or pause
+ *
+ * @param seq The melody
+ * @return The frequency to play now, 0 for silence, or MELODY_END once the melody is over
+ */
+int melody_step(melody_seq * seq);
+
+/**
+ * @brief Returns which note melody_step() last returned
+ *
+ * For looking the note up in a table of its own, such as a tone_table from ToneTable.h.
+ *
+ * @param seq The melody
+ * @return The index of the note, or -1 for a gap, a pause or the end
+ */
+int melody_index(const melody_seq * seq);
+
+/**
+ * @brief Returns how long the event melody_step() last returned lasts
+ *
+ * @param seq The melody
+ * @return The time in milliseconds
+ */
+unsigned int melody_held(const melody_seq * seq);
+
+/**
+ * @brief Returns when the next step is due
+ *
+ * @param seq The melody
+ * @return The time on the clock melody_start() was given, in milliseconds
+ */
+unsigned long melody_next(const melody_seq * seq);
+
+#endif
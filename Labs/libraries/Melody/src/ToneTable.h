@@ -0,0 +1,221 @@
+/**
+ * @file ToneTable.h
+ * @brief Timer TOP values for every note of a melody, worked out while compiling
+ * @authors
+ *  - Mason Wheeler
+ *  - Joey Pirich
+ *
+ * A timer plays a tone by counting its clock up to a TOP value, in OCRnA for CTC mode or
+ * ICRn for fast PWM. Working that value out from a frequency takes a 32 bit division, which
+ * the AVR does in software every time the note changes. tone_table does all of those
+ * divisions while compiling instead: given a constexpr array of frequencies, it picks the
+ * smallest prescaler every note fits, and keeps the TOP value of each note in a PROGMEM table,
+ * so changing a note costs one table load.
+ *
+ * The table also works out how far each note lands from the frequency asked for, since TOP
+ * can only be a whole number. max_error_ppm is the worst of them, in parts per million,
+ * compilation stops if it is over TONE_MAX_ERROR_PPM, and report() prints it.
+ *
+ *   constexpr int melody[] = {NOTE_E, NOTE_E, 0, NOTE_E};
+ *   typedef tone_table<melody, 4> melody_tones;
+ *
+ *   TCCR4B |= melody_tones::cs;
+ *   OCR4A = melody_tones::top(2);
+ */
+#ifndef TONE_TABLE_H
+#define TONE_TABLE_H
+
+#include <Arduino.h>
+#include <avr/pgmspace.h>
+
+/// Timer counts per tone period when the compare match toggles the pin, in CTC mode
+#define TONE_TOGGLE 2
+/// Timer counts per tone period when the timer runs a PWM wave up to TOP
+#define TONE_PWM 1
+
+#ifndef TONE_MAX_ERROR_PPM
+/// Largest error, in parts per million, a note of a tone table may have, 0.5% by default
+#define TONE_MAX_ERROR_PPM 5000
+#endif
+
+/**
+ * @brief Returns the prescaler a timer clock select value picks
+ *
+ * @param cs The CSn2:0 bits, 1 to 5, the same for timers 1, 3, 4 and 5
+ * @return The prescaler
+ */
+constexpr uint16_t tone_prescaler(uint8_t cs) {
+  return cs <= 1 ? 1 : cs == 2 ? 8 : cs == 3 ? 64 : cs == 4 ? 256 : 1024;
+}
+
+/**
+ * @brief Returns how many timer counts one wave of a tone lasts, to the nearest count
+ *
+ * @param clock The CPU clock in Hz
+ * @param steps TONE_TOGGLE or TONE_PWM
+ * @param cs The clock select bits of the timer
+ * @param freq The frequency of the tone in Hz, more than 0
+ * @return The number of counts, TOP + 1
+ */
+constexpr unsigned long tone_counts(unsigned long clock, uint8_t steps, uint8_t cs, int freq) {
+  return (clock / tone_prescaler(cs) + (unsigned long) steps * freq / 2) / ((unsigned long) steps * freq);
+}
+
+/**
+ * @brief Returns the TOP value that plays a tone
+ *
+ * @param clock The CPU clock in Hz
+ * @param steps TONE_TOGGLE or TONE_PWM
+ * @param cs The clock select bits of the timer
+ * @param freq The frequency of the tone in Hz, or 0 for none
+ * @return The TOP value, 0 for no tone
+ */
+constexpr uint16_t tone_top(unsigned long clock, uint8_t steps, uint8_t cs, int freq) {
+  return freq <= 0 ? 0 : (uint16_t) (tone_counts(clock, steps, cs, freq) - 1);
+}
+
+/**
+ * @brief Returns the frequency a tone's TOP value really plays
+ *
+ * @param clock The CPU clock in Hz
+ * @param steps TONE_TOGGLE or TONE_PWM
+ * @param cs The clock select bits of the timer
+ * @param freq The frequency asked for in Hz, more than 0
+ * @return The frequency played, in millionths of a Hz
+ */
+constexpr unsigned long long tone_played_uhz(unsigned long clock, uint8_t steps, uint8_t cs, int freq) {
+  return clock / tone_prescaler(cs) * 1000000ULL / (steps * tone_counts(clock, steps, cs, freq));
+}
+
+/**
+ * @brief Returns how far from a frequency its TOP value plays
+ *
+ * @param clock The CPU clock in Hz
+ * @param steps TONE_TOGGLE or TONE_PWM
+ * @param cs The clock select bits of the timer
+ * @param freq The frequency asked for in Hz, or 0 for none
+ * @return The error in parts per million
+ */
+constexpr unsigned long tone_error_ppm(unsigned long clock, uint8_t steps, uint8_t cs, int freq) {
+  return freq <= 0 ? 0 :
+    (unsigned long) ((tone_played_uhz(clock, steps, cs, freq) > freq * 1000000ULL ?
+                      tone_played_uhz(clock, steps, cs, freq) - freq * 1000000ULL :
+                      freq * 1000000ULL - tone_played_uhz(clock, steps, cs, freq)) / freq);
+}
+
+/**
+ * @brief Returns the lowest frequency of a melody, leaving out rests
+ *
+ * @param freqs The frequencies
+ * @param length The number of frequencies
+ * @param lowest The lowest of the frequencies before freqs
+ * @return The lowest frequency, or 0x7FFF if all are rests
+ */
+constexpr int tone_lowest(const int * freqs, unsigned int length, int lowest = 0x7FFF) {
+  return length == 0 ? lowest :
+    tone_lowest(freqs + 1, length - 1, freqs[0] > 0 && freqs[0] < lowest ? freqs[0] : lowest);
+}
+
+/**
+ * @brief Returns the clock select bits of the smallest prescaler a frequency fits
+ *
+ * @param clock The CPU clock in Hz
+ * @param steps TONE_TOGGLE or TONE_PWM
+ * @param freq The lowest frequency to play
+ * @param cs The clock select bits to try first
+ * @return The clock select bits, 5 if even the largest prescaler is too small
+ */
+constexpr uint8_t tone_pick_cs(unsigned long clock, uint8_t steps, int freq, uint8_t cs = 1) {
+  return cs >= 5 || tone_counts(clock, steps, cs, freq) <= 0x10000UL ? cs :
+    tone_pick_cs(clock, steps, freq, cs + 1);
+}
+
+/**
+ * @brief Returns the largest error of the notes of a melody
+ *
+ * @param clock The CPU clock in Hz
+ * @param steps TONE_TOGGLE or TONE_PWM
+ * @param cs The clock select bits of the timer
+ * @param freqs The frequencies
+ * @param length The number of frequencies
+ * @param worst The largest error of the frequencies before freqs
+ * @return The error in parts per million
+ */
+constexpr unsigned long tone_max_error(unsigned long clock, uint8_t steps, uint8_t cs,
+                                       const int * freqs, unsigned int length, unsigned long worst = 0) {
+  return length == 0 ? worst :
+    tone_max_error(clock, steps, cs, freqs + 1, length - 1,
+                   tone_error_ppm(clock, steps, cs, freqs[0]) > worst ? tone_error_ppm(clock, steps, cs, freqs[0]) : worst);
+}
+
+/// Indices 0 to N - 1 as a parameter pack, for building a table an entry per note
+template <unsigned int... I> struct tone_indices {};
+
+template <unsigned int N, unsigned int... I> struct tone_make_indices : tone_make_indices<N - 1, N - 1, I...> {};
+
+template <unsigned int... I> struct tone_make_indices<0, I...> {
+  typedef tone_indices<I...> type;
+};
+
+/// The PROGMEM array of TOP values behind a tone_table
+template <const int * FREQS, uint8_t STEPS, unsigned long CLOCK, uint8_t CS, typename INDICES> struct tone_tops;
+
+template <const int * FREQS, uint8_t STEPS, unsigned long CLOCK, uint8_t CS, unsigned int... I>
+struct tone_tops<FREQS, STEPS, CLOCK, CS, tone_indices<I...> > {
+  static const uint16_t tops[sizeof...(I)];
+};
+
+template <const int * FREQS, uint8_t STEPS, unsigned long CLOCK, uint8_t CS, unsigned int... I>
+const uint16_t tone_tops<FREQS, STEPS, CLOCK, CS, tone_indices<I...> >::tops[sizeof...(I)] PROGMEM = {
+  tone_top(CLOCK, STEPS, CS, FREQS[I])...
+};
+
+/**
+ * @brief TOP values for every note of a melody, for a timer clocked from the CPU
+ *
+ * @tparam FREQS The frequencies of the notes in Hz, 0 for a rest, a constexpr array
+ * @tparam LENGTH The number of notes
+ * @tparam STEPS TONE_TOGGLE for OCRnA in CTC mode, TONE_PWM for ICRn in fast PWM mode
+ * @tparam CLOCK The CPU clock in Hz
+ */
+template <const int * FREQS, unsigned int LENGTH, uint8_t STEPS = TONE_TOGGLE, unsigned long CLOCK = F_CPU>
+struct tone_table {
+  /// Clock select bits for TCCRnB, the smallest prescaler the lowest note fits
+  static const uint8_t cs = tone_pick_cs(CLOCK, STEPS, tone_lowest(FREQS, LENGTH));
+  /// The prescaler cs picks
+  static const uint16_t prescaler = tone_prescaler(cs);
+  /// Largest error of any note, in parts per million of its frequency
+  static const unsigned long max_error_ppm = tone_max_error(CLOCK, STEPS, cs, FREQS, LENGTH);
+
+  static_assert(tone_counts(CLOCK, STEPS, cs, tone_lowest(FREQS, LENGTH)) <= 0x10000UL,
+                "the lowest note is too low for a 16 bit timer at any prescaler");
+  static_assert(max_error_ppm <= TONE_MAX_ERROR_PPM, "a note is further from its frequency than TONE_MAX_ERROR_PPM");
+
+  /**
+   * @brief Returns the TOP value of a note
+   *
+   * @param note The index of the note, or less than 0 for none
+   * @return The TOP value, 0 for rests and for no note
+   */
+  static uint16_t top(int note) {
+    typedef tone_tops<FREQS, STEPS, CLOCK, cs, typename tone_make_indices<LENGTH>::type> table;
+    return note < 0 ? 0 : pgm_read_word(&table::tops[note]);
+  }
+
+  /**
+   * @brief Prints the prescaler and the largest error
+   *
+   * Prints a line like "tones prescaler 1 max error 12 ppm".
+   *
+   * @param out Where to print, for example Serial
+   */
+  static void report(Print & out) {
+    out.print(F("tones prescaler "));
+    out.print(prescaler);
+    out.print(F(" max error "));
+    out.print(max_error_ppm);
+    out.println(F(" ppm"));
+  }
+};
+
+#endif
@@ -0,0 +1,121 @@
+/**
+ * @file SevenSeg.cpp
+ * @brief Frame buffer and Timer5 refresh of the 7-segment display
+ * @authors
+ *  - Mason Wheeler
+ *  - Joey Pirich
+ */
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+#include "SevenSeg.h"
+
+const uint8_t seven_seg_digit_glyphs[10] PROGMEM = {
+  0x3F,  // 0
+  0x06,  // 1
+  0x5B,  // 2
+  0x4F,  // 3
+  0x66,  // 4
+  0x6D,  // 5
+  0x7D,  // 6
+  0x07,  // 7
+  0x7F,  // 8
+  0x67   // 9
+};
+
+const uint8_t seven_seg_smile[SEVEN_SEG_DIGITS] PROGMEM = {
+  0x52,  // right
+  0x09,  // eye
+  0x09,  // eye
+  0x64   // left
+};
+
+/// Timer5 counts per digit at a prescaler of 64
+#define SEVEN_SEG_COUNTS ((F_CPU / 1000000UL) * SEVEN_SEG_DIGIT_US / 64)
+
+#if SEVEN_SEG_COUNTS < 1 || SEVEN_SEG_COUNTS > 0x10000UL
+#error "SEVEN_SEG_DIGIT_US does not fit Timer5 at a prescaler of 64"
+#endif
+
+/// Glyphs the interrupt is showing
+static uint8_t frame[SEVEN_SEG_DIGITS];
+/// Glyphs of the next frame
+static volatile uint8_t next[SEVEN_SEG_DIGITS];
+/// Whether next holds a whole frame the interrupt has not taken yet
+static volatile uint8_t nextReady;
+/// Digit the interrupt lights next
+static uint8_t scanDigit;
+
+void seven_seg_begin() {
+  seven_seg_clear();
+
+  // segment lines and digit selects as outputs, every digit off
+  DDRA = 0xFF;
+  DDRB |= SEVEN_SEG_SELECT_MASK;
+  PORTB |= SEVEN_SEG_SELECT_MASK;
+
+#ifdef TIMER5_COMPA_vect
+  // CTC mode up to OCR5A, with a prescaler of 64, and an interrupt on every match
+  TCCR5A = 0;
+  TCCR5B = (1 << WGM52) | (1 << CS51) | (1 << CS50);
+  OCR5A = SEVEN_SEG_COUNTS - 1;
+  TCNT5 = 0;
+  TIMSK5 |= (1 << OCIE5A);
+#endif
+}
+
+uint8_t seven_seg_glyph(uint8_t digit) {
+  return pgm_read_byte(&seven_seg_digit_glyphs[digit]);
+}
+
+void seven_seg_write(const uint8_t glyphs[SEVEN_SEG_DIGITS]) {
+  // the interrupt leaves next alone while it is being written
+  nextReady = 0;
+  for (uint8_t i = 0; i < SEVEN_SEG_DIGITS; i++) {
+    next[i] = glyphs[i];
+  }
+  nextReady = 1;
+}
+
+void seven_seg_write_P(const uint8_t * glyphs) {
+  uint8_t row[SEVEN_SEG_DIGITS];
+  for (uint8_t i = 0; i < SEVEN_SEG_DIGITS; i++) {
+    row[i] = pgm_read_byte(&glyphs[i]);
+  }
+  seven_seg_write(row);
+}
+
+void seven_seg_show_digits(const uint8_t digits[SEVEN_SEG_DIGITS]) {
+  uint8_t row[SEVEN_SEG_DIGITS];
+  for (uint8_t i = 0; i < SEVEN_SEG_DIGITS; i++) {
+    row[i] = seven_seg_glyph(digits[i]);
+  }
+  seven_seg_write(row);
+}
+
+void seven_seg_clear() {
+  static const uint8_t blank[SEVEN_SEG_DIGITS] = {SEVEN_SEG_BLANK, SEVEN_SEG_BLANK, SEVEN_SEG_BLANK, SEVEN_SEG_BLANK};
+  seven_seg_write(blank);
+}
+
+void seven_seg_refresh() {
+  if (scanDigit == 0 && nextReady) {
+    for (uint8_t i = 0; i < SEVEN_SEG_DIGITS; i++) {
+      frame[i] = next[i];
+    }
+    nextReady = 0;
+  }
+
+  // turn the last digit off before changing the segments, so it never shows the next glyph
+  PORTB |= SEVEN_SEG_SELECT_MASK;
+  PORTA = frame[scanDigit];
+  PORTB &= ~(1 << (SEVEN_SEG_SELECT_SHIFT + scanDigit));
+  scanDigit = (scanDigit + 1) % SEVEN_SEG_DIGITS;
+}
+
+#ifdef TIMER5_COMPA_vect
+ISR(TIMER5_COMPA_vect) {
+  seven_seg_refresh();
+}
+#endif
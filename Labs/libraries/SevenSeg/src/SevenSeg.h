@@ -0,0 +1,104 @@
+/**
+ * @file SevenSeg.h
+ * @brief Four digit 7-segment display refreshed from the Timer5 interrupt
+ * @authors
+ *  - Mason Wheeler
+ *  - Joey Pirich
+ *
+ * The display has one set of segment lines, on PORTA, shared by all four digits, and a select
+ * line per digit on PB4 to PB7, low to light it. Only one digit can be lit at a time, so the
+ * digits take turns fast enough that all four look lit. Doing that from a task costs the task
+ * a busy wait or a sleep for every digit; here the Timer5 compare interrupt lights the next
+ * digit every SEVEN_SEG_DIGIT_US instead, and a task only writes what to show when it changes.
+ *
+ * Each digit is a glyph, one byte with bit i set to light segment i, a to g, the way the
+ * segment lines are wired to PORTA. The glyphs of the digits and of the smiley face are kept
+ * in program memory. The frame buffer is four glyphs, digit 0 on the right.
+ *
+ * A write goes into a second buffer, which the interrupt copies over the frame buffer at the
+ * start of the next scan, so a scan never shows half of one frame and half of another, and
+ * writing never turns interrupts off.
+ *
+ *   seven_seg_begin();
+ *   uint8_t digits[SEVEN_SEG_DIGITS] = {4, 7, 4, 0};
+ *   seven_seg_show_digits(digits);  // shows 0474
+ *   seven_seg_write_P(seven_seg_smile);
+ */
+#ifndef SEVEN_SEG_H
+#define SEVEN_SEG_H
+
+#include <stdint.h>
+#include <avr/pgmspace.h>
+
+/// Number of digits on the display
+#define SEVEN_SEG_DIGITS 4
+
+#ifndef SEVEN_SEG_DIGIT_US
+/// Microseconds each digit is lit for, 2.5 ms for a full scan every 10 ms
+#define SEVEN_SEG_DIGIT_US 2500
+#endif
+
+/// Bits of PORTB that select the digits, digit 0 on PB4
+#define SEVEN_SEG_SELECT_MASK 0xF0
+/// Bit of PORTB that selects digit 0
+#define SEVEN_SEG_SELECT_SHIFT 4
+
+/// Glyph with every segment off
+#define SEVEN_SEG_BLANK 0x00
+
+/// Glyphs of the digits 0 to 9, in program memory
+extern const uint8_t seven_seg_digit_glyphs[10] PROGMEM;
+/// Glyphs of a smiley face, digit 0 first, in program memory
+extern const uint8_t seven_seg_smile[SEVEN_SEG_DIGITS] PROGMEM;
+
+/**
+ * @brief Sets up the display pins and starts refreshing from the Timer5 interrupt
+ *
+ * The display starts blank. Timer5 runs in CTC mode with a prescaler of 64, so it can not be
+ * used for anything else.
+ */
+void seven_seg_begin();
+
+/**
+ * @brief Returns the glyph of a digit
+ *
+ * @param digit The digit, 0 to 9
+ * @return The glyph
+ */
+uint8_t seven_seg_glyph(uint8_t digit);
+
+/**
+ * @brief Shows four glyphs from the start of the next scan
+ *
+ * @param glyphs The glyphs, digit 0 first
+ */
+void seven_seg_write(const uint8_t glyphs[SEVEN_SEG_DIGITS]);
+
+/**
+ * @brief Shows four glyphs kept in program memory, such as seven_seg_smile
+ *
+ * @param glyphs The glyphs in program memory, digit 0 first
+ */
+void seven_seg_write_P(const uint8_t * glyphs);
+
+/**
+ * @brief Shows four digits
+ *
+ * @param digits The digits, 0 to 9, digit 0 first
+ */
+void seven_seg_show_digits(const uint8_t digits[SEVEN_SEG_DIGITS]);
+
+/**
+ * @brief Turns every segment off
+ *
+ */
+void seven_seg_clear();
+
+/**
+ * @brief Lights the next digit, called from the Timer5 interrupt
+ *
+ * Boards without a Timer5, like the host simulator, call it from a timer of their own.
+ */
+void seven_seg_refresh();
+
+#endif
@@ -0,0 +1,341 @@
+/**
+ * @file TCBScheduler.cpp
+ * @brief Task table and list handling for the TCB scheduler
+ * @authors
+ *  - Mason Wheeler
+ *  - Joey Pirich
+ */
+
+#include <stddef.h>
+
+#include "TCBScheduler.h"
+
+#if TCB_MAX_TASKS > 255
+#error "TCB_MAX_TASKS must fit a task_handle and leave TASK_NONE free"
+#endif
+
+/// Longest wait task_idle_ms() hands out, a whole number of ticks that fits an unsigned int
+#define TCB_MAX_IDLE_MS ((32767 / TCB_TICK_MS) * TCB_TICK_MS)
+
+/**
+ * @brief Struct to hold all of a Tasks running state
+ *
+ */
+typedef struct TCB {
+  /// Task function
+  void (*fn_ptr)();
+  /// Next task on the same list, or TASK_NONE
+  task_handle next;
+  /// Previous task on the same list, or TASK_NONE
+  task_handle prev;
+  /// Running state of this task
+  uint8_t state;
+  /// Number of times task has been run
+  int nTimes;
+  /// Amount of time in ms the task sleeps for after the task before it on the sleep list wakes
+  long timeSleep;
+  /// Scheduler clock time at which this task's clock read 0, or its clock time while DEAD
+  unsigned long time;
+#if TCB_USE_NAME_HASH
+  /// Hash of the task name, 0 for none
+  uint16_t name;
+#endif
+} tcb;
+
+/// A list of slots linked through their next and prev fields
+typedef struct {
+  task_handle head;
+  task_handle tail;
+} tcb_list;
+
+static tcb tasks[TCB_MAX_TASKS];
+static tcb_list freeTasks;
+static tcb_list readyTasks;
+static tcb_list sleepingTasks;
+
+/// Milliseconds task_tick() has counted, which task clocks are worked out from
+static unsigned long now;
+
+/// The task that is running now
+static task_handle currTask = TASK_NONE;
+
+/// The task task_run_ready() runs next, kept right when tasks leave the ready list under it
+static task_handle nextTask = TASK_NONE;
+
+/// Called by task_run_ready() before and after each task, or NULL
+static task_hook beforeTask;
+static task_hook afterTask;
+
+/**
+ * @brief Adds a task to the end of a list
+ *
+ * @param list The list to add to
+ * @param task The task to add, which must be on no list
+ */
+static void list_append(tcb_list * list, task_handle task) {
+  tasks[task].next = TASK_NONE;
+  tasks[task].prev = list->tail;
+  if (list->tail == TASK_NONE) {
+    list->head = task;
+  } else {
+    tasks[list->tail].next = task;
+  }
+  list->tail = task;
+}
+
+/**
+ * @brief Adds a task to a list in front of another
+ *
+ * @param list The list to add to
+ * @param task The task to add, which must be on no list
+ * @param before The task to add it in front of, or TASK_NONE for the end of the list
+ */
+static void list_insert(tcb_list * list, task_handle task, task_handle before) {
+  if (before == TASK_NONE) {
+    list_append(list, task);
+    return;
+  }
+
+  tasks[task].next = before;
+  tasks[task].prev = tasks[before].prev;
+  if (tasks[before].prev == TASK_NONE) {
+    list->head = task;
+  } else {
+    tasks[tasks[before].prev].next = task;
+  }
+  tasks[before].prev = task;
+}
+
+/**
+ * @brief Takes a task off the list it is on
+ *
+ * @param list The list the task is on
+ * @param task The task to take off
+ */
+static void list_remove(tcb_list * list, task_handle task) {
+  task_handle next = tasks[task].next;
+  task_handle prev = tasks[task].prev;
+
+  if (prev == TASK_NONE) {
+    list->head = next;
+  } else {
+    tasks[prev].next = next;
+  }
+  if (next == TASK_NONE) {
+    list->tail = prev;
+  } else {
+    tasks[next].prev = prev;
+  }
+
+  // the scheduler loop is about to run this task, move it on to the one after
+  if (task == nextTask) nextTask = next;
+}
+
+/**
+ * @brief Returns the list a task is on for its state
+ *
+ * @param state The state of the task
+ * @return The list, or NULL for DEAD tasks, which are on none
+ */
+static tcb_list * list_for(uint8_t state) {
+  switch (state) {
+    case FREE: return &freeTasks;
+    case READY:
+    case RUNNING: return &readyTasks;
+    case SLEEPING: return &sleepingTasks;
+    default: return NULL;
+  }
+}
+
+void task_init() {
+  freeTasks.head = freeTasks.tail = TASK_NONE;
+  readyTasks.head = readyTasks.tail = TASK_NONE;
+  sleepingTasks.head = sleepingTasks.tail = TASK_NONE;
+  now = 0;
+  currTask = TASK_NONE;
+  nextTask = TASK_NONE;
+
+  for (task_handle i = 0; i < TCB_MAX_TASKS; i++) {
+    tasks[i].fn_ptr = NULL;
+    tasks[i].state = FREE;
+    list_append(&freeTasks, i);
+  }
+}
+
+task_handle task_load(void (*fn_ptr)(), uint16_t name) {
+  task_handle task = freeTasks.head;
+
+  // if there's no space, don't do anything
+  if (task == TASK_NONE) return TASK_NONE;
+
+  list_remove(&freeTasks, task);
+  tasks[task].fn_ptr = fn_ptr;
+  tasks[task].nTimes = 0;
+  tasks[task].timeSleep = 0;
+  tasks[task].time = 0;
+  tasks[task].state = DEAD;
+#if TCB_USE_NAME_HASH
+  tasks[task].name = name;
+#else
+  (void) name;
+#endif
+  return task;
+}
+
+void task_unload(task_handle task) {
+  if (task >= TCB_MAX_TASKS || tasks[task].state == FREE) return;
+
+  task_stop(task);
+  tasks[task].fn_ptr = NULL;
+  tasks[task].state = FREE;
+  list_append(&freeTasks, task);
+}
+
+void task_start(task_handle task) {
+  // only DEAD tasks can be started
+  if (task >= TCB_MAX_TASKS || tasks[task].state != DEAD) return;
+
+  // pick the task's clock up where it stopped
+  tasks[task].time = now - tasks[task].time;
+  tasks[task].state = READY;
+  list_append(&readyTasks, task);
+}
+
+void task_stop(task_handle task) {
+  if (task >= TCB_MAX_TASKS) return;
+
+  tcb_list * list = list_for(tasks[task].state);
+  if (list == NULL || list == &freeTasks) return;
+
+  // the task after it on the sleep list now sleeps its time as well
+  if (list == &sleepingTasks && tasks[task].next != TASK_NONE) {
+    tasks[tasks[task].next].timeSleep += tasks[task].timeSleep;
+  }
+  list_remove(list, task);
+  tasks[task].timeSleep = 0;
+
+  // stop the task's clock where it is
+  tasks[task].time = now - tasks[task].time;
+  tasks[task].state = DEAD;
+}
+
+void task_self_quit() {
+  task_stop(currTask);
+}
+
+task_handle task_find(uint16_t name) {
+#if TCB_USE_NAME_HASH
+  if (name == 0) return TASK_NONE;
+
+  for (task_handle i = 0; i < TCB_MAX_TASKS; i++) {
+    if (tasks[i].state != FREE && tasks[i].name == name) return i;
+  }
+#else
+  (void) name;
+#endif
+  return TASK_NONE;
+}
+
+task_handle task_self() {
+  return currTask;
+}
+
+STATE task_state(task_handle task) {
+  return task < TCB_MAX_TASKS ? (STATE) tasks[task].state : FREE;
+}
+
+long task_time() {
+  return (long) (now - tasks[currTask].time);
+}
+
+void task_reset_time() {
+  tasks[currTask].time = now;
+}
+
+int task_runs() {
+  return tasks[currTask].nTimes;
+}
+
+void sleep_474(long t) {
+  if (currTask == TASK_NONE || tasks[currTask].state != RUNNING) return;
+
+  // sleep whole ticks, the last part of a tick is not waited for
+  long ticks = t / TCB_TICK_MS;
+  long timeSleep = (ticks > 0 ? ticks : 1) * TCB_TICK_MS;
+
+  // find where the task goes on the sleep list, after the tasks that wake no later
+  task_handle before = sleepingTasks.head;
+  while (before != TASK_NONE && tasks[before].timeSleep <= timeSleep) {
+    timeSleep -= tasks[before].timeSleep;
+    before = tasks[before].next;
+  }
+
+  // move the current task from the ready list to the sleep list
+  list_remove(&readyTasks, currTask);
+  tasks[currTask].timeSleep = timeSleep;
+  tasks[currTask].state = SLEEPING;
+  list_insert(&sleepingTasks, currTask, before);
+
+  // the task behind it now sleeps only the time after it
+  if (before != TASK_NONE) tasks[before].timeSleep -= timeSleep;
+}
+
+void task_tick(unsigned int ms) {
+  task_handle task = sleepingTasks.head;
+
+  // every clock that is running moves on with the scheduler's
+  now += ms;
+
+  if (task == TASK_NONE) return;
+
+  // only the first sleeper counts down, the others sleep on after it
+  tasks[task].timeSleep -= (long) ms;
+
+  // wake up the sleepers that are done
+  while (task != TASK_NONE && tasks[task].timeSleep <= 0) {
+    task_handle next = tasks[task].next;
+
+    // pass on what the tick took past this task's wake up time
+    if (next != TASK_NONE) tasks[next].timeSleep += tasks[task].timeSleep;
+    tasks[task].timeSleep = 0;
+    list_remove(&sleepingTasks, task);
+    tasks[task].state = READY;
+    list_append(&readyTasks, task);
+    task = next;
+  }
+}
+
+unsigned int task_idle_ms() {
+  // another task can run now, or no task will wake to run
+  if (readyTasks.head != currTask || readyTasks.tail != currTask || sleepingTasks.head == TASK_NONE) {
+    return TCB_TICK_MS;
+  }
+
+  long timeSleep = tasks[sleepingTasks.head].timeSleep;
+  return timeSleep < TCB_MAX_IDLE_MS ? (unsigned int) timeSleep : TCB_MAX_IDLE_MS;
+}
+
+void task_run_ready() {
+  for (task_handle task = readyTasks.head; task != TASK_NONE; task = nextTask) {
+    // remember the next task first, the running one may leave the list
+    nextTask = tasks[task].next;
+
+    // start up this task
+    tasks[task].state = RUNNING;
+    currTask = task;
+    if (beforeTask != NULL) beforeTask(task);
+    (*(tasks[task].fn_ptr))();
+    if (afterTask != NULL) afterTask(task);
+    tasks[task].nTimes++;
+
+    // tear down
+    if (tasks[task].state == RUNNING) tasks[task].state = READY;
+  }
+  currTask = TASK_NONE;
+  nextTask = TASK_NONE;
+}
+
+void task_set_hooks(task_hook before, task_hook after) {
+  beforeTask = before;
+  afterTask = after;
+}
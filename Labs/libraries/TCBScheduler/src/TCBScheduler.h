@@ -0,0 +1,202 @@
+/**
+ * @file TCBScheduler.h
+ * @brief Cooperative task control block scheduler for the Lab 3 DDS demos
+ * @authors
+ *  - Mason Wheeler
+ *  - Joey Pirich
+ *
+ * Every task lives in one fixed table of TCBs for its whole life. A state field says what
+ * the task is doing, and each slot carries the links of the one list it is on: the free list
+ * of unused slots, the ready list the scheduler loop runs, or the sleep list schedule_sync()
+ * counts down. Dead tasks are on no list, they keep their slot until they are started again.
+ * Moving a task between states only relinks it, so loading, starting, stopping and quitting
+ * take constant time and nothing is ever copied.
+ *
+ * The sleep list is kept in wake up order, and each task on it stores only how much longer
+ * it sleeps than the task before it, so a tick counts down the first task alone. Task clocks
+ * are not counted at all: a task remembers when its clock was 0 and task_time() works its
+ * time out from the scheduler's clock. A tick therefore costs the same however many tasks
+ * there are, and when nothing is ready schedule_sync() can let many ticks pass at once.
+ *
+ * Tasks are named by the handle task_load() returns. With TCB_USE_NAME_HASH each task also
+ * keeps a 16 bit hash of its name, which TCB_NAME() works out at compile time, so tasks can
+ * be looked up by name with task_find() without storing or comparing strings.
+ */
+#ifndef TCB_SCHEDULER_H
+#define TCB_SCHEDULER_H
+
+#include <stdint.h>
+
+#include "TCBSchedulerConfig.h"
+
+/// Handle of a task, the index of its slot in the task table
+typedef uint8_t task_handle;
+
+/// Handle that names no task
+#define TASK_NONE ((task_handle) 0xFF)
+
+/// Function task_run_ready() calls around each task it runs, see task_set_hooks()
+typedef void (*task_hook)(task_handle task);
+
+/// Running state of a task. FREE slots hold no task at all.
+typedef enum {FREE, DEAD, READY, RUNNING, SLEEPING} STATE;
+
+/**
+ * @brief Hashes a task name, djb2 cut down to 16 bits
+ *
+ * constexpr so that TCB_NAME() can hash string literals while compiling.
+ *
+ * @param name The name to hash
+ * @param hash The hash of the characters before name
+ * @return The hash, never 0 for a non-empty name in practice
+ */
+constexpr uint16_t tcb_name_hash(const char * name, uint16_t hash = 5381) {
+  return *name ? tcb_name_hash(name + 1, (uint16_t) (hash * 33u + (uint8_t) *name)) : hash;
+}
+
+/// Holds a hash as a constant so that it can not be left for run time
+template <uint16_t HASH> struct tcb_name_constant {
+  static const uint16_t value = HASH;
+};
+
+#if TCB_USE_NAME_HASH
+/// Name of a task, hashed at compile time, for task_load() and task_find()
+#define TCB_NAME(name) (tcb_name_constant<tcb_name_hash(name)>::value)
+#else
+#define TCB_NAME(name) ((uint16_t) 0)
+#endif
+
+/**
+ * @brief Empties the task table and puts every slot on the free list
+ *
+ */
+void task_init();
+
+/**
+ * @brief Loads a task into a free slot, DEAD until it is started
+ *
+ * @param fn_ptr The function the scheduler calls each time the task runs
+ * @param name The task's name from TCB_NAME(), or 0 for none
+ * @return The handle of the task, or TASK_NONE if the table is full
+ */
+task_handle task_load(void (*fn_ptr)(), uint16_t name);
+
+/**
+ * @brief Stops a task and gives its slot back to the free list
+ *
+ * @param task The task to unload
+ */
+void task_unload(task_handle task);
+
+/**
+ * @brief Starts a DEAD task by putting it at the end of the ready list
+ *
+ * The task keeps its clock and run count from before it quit.
+ *
+ * @param task The task to start, TASK_NONE is ignored
+ */
+void task_start(task_handle task);
+
+/**
+ * @brief Stops a task, whatever it is doing, and makes it DEAD
+ *
+ * @param task The task to stop, TASK_NONE is ignored
+ */
+void task_stop(task_handle task);
+
+/**
+ * @brief Terminates the current task
+ *
+ */
+void task_self_quit();
+
+/**
+ * @brief Finds a loaded task by name
+ *
+ * @param name The name to look for, from TCB_NAME()
+ * @return The handle of the task, or TASK_NONE if there is none
+ */
+task_handle task_find(uint16_t name);
+
+/**
+ * @brief Returns the task that is running now
+ *
+ * @return The handle of the current task, or TASK_NONE outside of a task
+ */
+task_handle task_self();
+
+/**
+ * @brief Returns a task's state
+ *
+ * @param task The task to ask about
+ * @return The state of the task, FREE for TASK_NONE
+ */
+STATE task_state(task_handle task);
+
+/**
+ * @brief Returns the clock time the current task sees, in milliseconds
+ *
+ * @return Milliseconds counted since the task was loaded or last reset its time
+ */
+long task_time();
+
+/**
+ * @brief Sets the current task's clock back to 0
+ *
+ */
+void task_reset_time();
+
+/**
+ * @brief Returns how many times the current task has run before this call
+ *
+ * @return The run count of the current task
+ */
+int task_runs();
+
+/**
+ * @brief Sleeps the current task for a specified amount of time
+ *
+ * The task wakes on the tick that leaves less than a tick of t to go, and never sooner than
+ * the next tick.
+ *
+ * @param t The amount of time to sleep in milliseconds
+ */
+void sleep_474(long t);
+
+/**
+ * @brief Advances every running task's clock and wakes the sleepers that are due
+ *
+ * Called by the sketch's schedule_sync() task with the time that passed since its last call.
+ *
+ * @param ms Milliseconds that passed, a multiple of TCB_TICK_MS
+ */
+void task_tick(unsigned int ms);
+
+/**
+ * @brief Returns how long the scheduler has nothing to do but wait
+ *
+ * When the current task is the only one ready, that is until the first sleeper is due, and
+ * schedule_sync() can wait out that many ticks before calling task_tick() once for them all.
+ *
+ * @return Milliseconds until another task can run, or TCB_TICK_MS if one can run now
+ */
+unsigned int task_idle_ms();
+
+/**
+ * @brief Runs every READY task once, in the order they were started
+ *
+ * The scheduler loop, called from loop().
+ */
+void task_run_ready();
+
+/**
+ * @brief Sets functions for task_run_ready() to call right before and after each task
+ *
+ * For measuring the tasks, for example with frame_task_begin() and frame_task_end().
+ *
+ * @param before Called with the task about to run, or NULL for none
+ * @param after Called with the task that just ran, or NULL for none
+ */
+void task_set_hooks(task_hook before, task_hook after);
+
+#endif
@@ -0,0 +1,20 @@
+/**
+ * @file TCBSchedulerConfig.h
+ * @brief Build options for the TCB scheduler
+ *
+ * The library is compiled on its own, so options set in a sketch do not reach it. Change
+ * them here instead, the way FreeRTOSConfig.h is edited for the FreeRTOS library.
+ */
+#ifndef TCB_SCHEDULER_CONFIG_H
+#define TCB_SCHEDULER_CONFIG_H
+
+/// Number of slots in the task table, at most 255
+#define TCB_MAX_TASKS 10
+
+/// Period of the timer that drives task_tick(), in milliseconds
+#define TCB_TICK_MS 2
+
+/// 1 to keep a 16 bit hash of each task's name so task_find() can look tasks up by name
+#define TCB_USE_NAME_HASH 1
+
+#endif